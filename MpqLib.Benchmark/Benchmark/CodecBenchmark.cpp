@@ -0,0 +1,227 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "CodecBenchmark.h"
+
+MpqLib::Benchmark::CCodecBenchmark::CCodecBenchmark()
+{
+	_SectorSize = 0x200 << Mpq::CConstants::DefaultSectorSizeShift;
+	_Iterations = 1;
+	_SampleCount = 0;
+	_ContentTypes = gcnew System::Collections::Generic::List<System::String^>();
+	_Samples = gcnew System::Collections::Generic::Dictionary<System::String^, System::Collections::Generic::List<array<System::Byte>^>^>(System::StringComparer::OrdinalIgnoreCase);
+}
+
+MpqLib::Benchmark::CCodecBenchmark::CCodecBenchmark(System::UInt16 SectorSizeShift)
+{
+	if(SectorSizeShift > Mpq::CConstants::MaxSectorSizeShift) throw gcnew System::ArgumentOutOfRangeException("SectorSizeShift", "The sector size shift can be at most " + Mpq::CConstants::MaxSectorSizeShift + "!");
+
+	_SectorSize = 0x200 << SectorSizeShift;
+	_Iterations = 1;
+	_SampleCount = 0;
+	_ContentTypes = gcnew System::Collections::Generic::List<System::String^>();
+	_Samples = gcnew System::Collections::Generic::Dictionary<System::String^, System::Collections::Generic::List<array<System::Byte>^>^>(System::StringComparer::OrdinalIgnoreCase);
+}
+
+System::Void MpqLib::Benchmark::CCodecBenchmark::AddSample(System::String^ FileName)
+{
+	AddSample(GetContentType(FileName), System::IO::File::ReadAllBytes(FileName));
+}
+
+System::Void MpqLib::Benchmark::CCodecBenchmark::AddSample(System::String^ ContentType, array<System::Byte>^ Data)
+{
+	if(ContentType == nullptr) throw gcnew System::ArgumentNullException("ContentType");
+	if(Data == nullptr) throw gcnew System::ArgumentNullException("Data");
+
+	//Empty samples have nothing to measure
+	if(Data->Length == 0) return;
+
+	System::Collections::Generic::List<array<System::Byte>^>^ Samples;
+	if(!_Samples->TryGetValue(ContentType, Samples))
+	{
+		Samples = gcnew System::Collections::Generic::List<array<System::Byte>^>();
+		_Samples->Add(ContentType, Samples);
+		_ContentTypes->Add(ContentType);
+	}
+
+	Samples->Add(Data);
+	_SampleCount++;
+}
+
+MpqLib::Benchmark::CCodecReport^ MpqLib::Benchmark::CCodecBenchmark::Run()
+{
+	if(_SampleCount == 0) throw gcnew System::InvalidOperationException("No samples have been added!");
+
+	System::Collections::Generic::List<CCodecResult^>^ Results = gcnew System::Collections::Generic::List<CCodecResult^>();
+
+	for each(System::String^ ContentType in _ContentTypes)
+	{
+		for each(Mpq::ECompression Compression in System::Enum::GetValues(Mpq::ECompression::typeid))
+		{
+			if(GetCompressionFlags(Compression) == 0) continue;
+
+			//The wave codecs expect PCM samples, other data only tells how they mangle it
+			if(IsWaveCompression(Compression) && (ContentType != "WAV")) continue;
+
+			Results->Add(Measure(ContentType, _Samples[ContentType], Compression));
+		}
+	}
+
+	return gcnew CCodecReport(_SectorSize, _Iterations, Results);
+}
+
+System::Int32 MpqLib::Benchmark::CCodecBenchmark::Iterations::get()
+{
+	return _Iterations;
+}
+
+System::Void MpqLib::Benchmark::CCodecBenchmark::Iterations::set(System::Int32 Value)
+{
+	if(Value < 1) throw gcnew System::ArgumentOutOfRangeException("Value", "At least one iteration is needed!");
+
+	_Iterations = Value;
+}
+
+System::Int32 MpqLib::Benchmark::CCodecBenchmark::SampleCount::get()
+{
+	return _SampleCount;
+}
+
+MpqLib::Benchmark::CCodecResult^ MpqLib::Benchmark::CCodecBenchmark::Measure(System::String^ ContentType, System::Collections::Generic::List<array<System::Byte>^>^ Samples, Mpq::ECompression Compression)
+{
+	DWORD CompressionFlags = GetCompressionFlags(Compression);
+	DWORD Flags = ((Compression == Mpq::ECompression::Implode) ? MPQ_FILE_IMPLODE : MPQ_FILE_COMPRESS) | MPQ_FILE_EXISTS;
+
+	System::Int64 Size = 0;
+	System::Int64 CompressedSize = 0;
+	System::Boolean IsLossless = true;
+	System::Diagnostics::Stopwatch^ CompressWatch = gcnew System::Diagnostics::Stopwatch();
+	System::Diagnostics::Stopwatch^ DecompressWatch = gcnew System::Diagnostics::Stopwatch();
+
+	for(System::Int32 Iteration = 0; Iteration < _Iterations; Iteration++)
+	{
+		for each(array<System::Byte>^ Sample in Samples)
+		{
+			DWORD SampleSize = static_cast<DWORD>(Sample->Length);
+			System::Int32 SectorCount = static_cast<System::Int32>((SampleSize + _SectorSize - 1) / _SectorSize);
+
+			//A sector never grows (it is stored as is instead), so each one is encoded into the slot it was read from
+			std::vector<BYTE> BlockData(SampleSize);
+			std::vector<DWORD> SectorSizes(SectorCount);
+			array<System::Byte>^ FileData = gcnew array<System::Byte>(Sample->Length);
+			pin_ptr<System::Byte> SamplePointer = &Sample[0];
+			pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+
+			//The sectors are run one after another on this thread, the parallel paths of the library would measure the cores instead
+			CompressWatch->Start();
+			for(System::Int32 i = 0; i < SectorCount; i++)
+			{
+				DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize);
+				DWORD SectorLength = System::Math::Min(static_cast<DWORD>(_SectorSize), SampleSize - SectorStart);
+
+				SectorSizes[i] = Mpq::CBlockEncoder::EncodeSector(SamplePointer + SectorStart, SectorLength, &BlockData[SectorStart], Flags, CompressionFlags, 0, 0, 0);
+			}
+			CompressWatch->Stop();
+
+			//A sector that fails to decode (or not to its original length) makes the result lossy, it does not end the run
+			System::Boolean IsDecoded = true;
+			DecompressWatch->Start();
+			try
+			{
+				for(System::Int32 i = 0; i < SectorCount; i++)
+				{
+					DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize);
+					DWORD SectorLength = System::Math::Min(static_cast<DWORD>(_SectorSize), SampleSize - SectorStart);
+
+					Mpq::CBlockDecoder::DecodeSector(&BlockData[SectorStart], SectorSizes[i], FileDataPointer + SectorStart, SectorLength, Flags, 0);
+				}
+			}
+			catch(System::IO::IOException^)
+			{
+				IsDecoded = false;
+			}
+			DecompressWatch->Stop();
+
+			if(Iteration == 0)
+			{
+				Size += SampleSize;
+				CompressedSize += (SectorCount + 1) * sizeof(DWORD);
+				for(System::Int32 i = 0; i < SectorCount; i++) CompressedSize += SectorSizes[i];
+
+				if(!IsDecoded || !CompareData(Sample, FileData)) IsLossless = false;
+			}
+		}
+	}
+
+	System::Double Megabytes = static_cast<System::Double>(Size) * _Iterations / 0x100000;
+	System::Double CompressSpeed = Megabytes / CompressWatch->Elapsed.TotalSeconds;
+	System::Double DecompressSpeed = Megabytes / DecompressWatch->Elapsed.TotalSeconds;
+
+	return gcnew CCodecResult(ContentType, Compression, Samples->Count, Size, CompressedSize, CompressSpeed, DecompressSpeed, IsLossless);
+}
+
+DWORD MpqLib::Benchmark::CCodecBenchmark::GetCompressionFlags(Mpq::ECompression Compression)
+{
+	//The legacy wave values pair ADPCM with Huffman the way StormLib stores wave files
+	switch(Compression)
+	{
+	case Mpq::ECompression::Implode: return MPQ_COMPRESSION_PKWARE;
+	case Mpq::ECompression::WaveMono: return MPQ_COMPRESSION_ADPCM_MONO | MPQ_COMPRESSION_HUFFMANN;
+	case Mpq::ECompression::WaveStereo: return MPQ_COMPRESSION_ADPCM_STEREO | MPQ_COMPRESSION_HUFFMANN;
+	}
+
+	return Mpq::CArchive::BuildCompressionFlags(Compression);
+}
+
+System::Boolean MpqLib::Benchmark::CCodecBenchmark::IsWaveCompression(Mpq::ECompression Compression)
+{
+	return (GetCompressionFlags(Compression) & (MPQ_COMPRESSION_ADPCM_MONO | MPQ_COMPRESSION_ADPCM_STEREO)) != 0;
+}
+
+System::String^ MpqLib::Benchmark::CCodecBenchmark::GetContentType(System::String^ FileName)
+{
+	System::String^ Extension = System::IO::Path::GetExtension(FileName)->TrimStart(L'.')->ToUpperInvariant();
+
+	//Scripts come as both "war3map.j" and "*.ai"
+	if((Extension == "J") || (Extension == "AI")) return "JASS";
+	if(Extension->Length == 0) return "OTHER";
+
+	return Extension;
+}
+
+System::Boolean MpqLib::Benchmark::CCodecBenchmark::CompareData(array<System::Byte>^ Data1, array<System::Byte>^ Data2)
+{
+	if(Data1->Length != Data2->Length) return false;
+	if(Data1->Length == 0) return true;
+
+	pin_ptr<System::Byte> DataPointer1 = &Data1[0];
+	pin_ptr<System::Byte> DataPointer2 = &Data2[0];
+
+	return (memcmp(DataPointer1, DataPointer2, Data1->Length) == 0);
+}
@@ -0,0 +1,103 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "CodecReport.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// Measures the compression ratio and the compression and decompression speeds of every
+		/// compression format over samples grouped by content type. The samples are encoded and decoded
+		/// sector by sector on one thread, the speeds are those of the codecs alone. The wave codecs
+		/// (ADPCM mono and stereo, alone or with Huffman) are only run over WAV samples.
+		/// </summary>
+		public ref class CCodecBenchmark sealed
+		{
+			public:
+				/// <summary>
+				/// Default constructor.
+				/// </summary>
+				CCodecBenchmark();
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="SectorSizeShift">The sector size to encode with as a shift of 512 bytes</param>
+				CCodecBenchmark(System::UInt16 SectorSizeShift);
+
+				/// <summary>
+				/// Adds a sample, its content type is the file extension (such as "MDX" or "BLP").
+				/// </summary>
+				/// <param name="FileName">The file to read the sample from</param>
+				System::Void AddSample(System::String^ FileName);
+
+				/// <summary>
+				/// Adds a sample.
+				/// </summary>
+				/// <param name="ContentType">The content type to group the sample under</param>
+				/// <param name="Data">The sample data</param>
+				System::Void AddSample(System::String^ ContentType, array<System::Byte>^ Data);
+
+				/// <summary>
+				/// Runs every compression format over the samples of every content type.
+				/// </summary>
+				/// <returns>The measurements</returns>
+				CCodecReport^ Run();
+
+				/// <summary>
+				/// Gets or sets the number of passes over the samples, more passes give steadier speeds.
+				/// </summary>
+				property System::Int32 Iterations { System::Int32 get(); System::Void set(System::Int32 Value); }
+
+				/// <summary>
+				/// Retrieves the number of samples added.
+				/// </summary>
+				property System::Int32 SampleCount { System::Int32 get(); }
+
+			private:
+				CCodecResult^ Measure(System::String^ ContentType, System::Collections::Generic::List<array<System::Byte>^>^ Samples, Mpq::ECompression Compression);
+
+				static DWORD GetCompressionFlags(Mpq::ECompression Compression);
+				static System::Boolean IsWaveCompression(Mpq::ECompression Compression);
+				static System::String^ GetContentType(System::String^ FileName);
+				static System::Boolean CompareData(array<System::Byte>^ Data1, array<System::Byte>^ Data2);
+
+			private:
+				System::Int32 _SectorSize;
+				System::Int32 _Iterations;
+				System::Int32 _SampleCount;
+				System::Collections::Generic::List<System::String^>^ _ContentTypes;
+				System::Collections::Generic::Dictionary<System::String^, System::Collections::Generic::List<array<System::Byte>^>^>^ _Samples;
+		};
+	}
+}
@@ -0,0 +1,93 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "CodecReport.h"
+
+MpqLib::Benchmark::CCodecReport::CCodecReport(System::Int32 SectorSize, System::Int32 Iterations, System::Collections::Generic::IList<CCodecResult^>^ Results)
+{
+	_SectorSize = SectorSize;
+	_Iterations = Iterations;
+	_Results = gcnew System::Collections::ObjectModel::ReadOnlyCollection<CCodecResult^>(Results);
+}
+
+System::String^ MpqLib::Benchmark::CCodecReport::ToString()
+{
+	System::Text::StringBuilder^ Builder = gcnew System::Text::StringBuilder();
+
+	Builder->AppendLine(System::String::Format("{0,-8} {1,-12} {2,7} {3,12} {4,12} {5,7} {6,10} {7,11} {8}", "Type", "Compression", "Samples", "Size", "Compressed", "Ratio", "Comp MB/s", "Decomp MB/s", "Lossless"));
+
+	for each(CCodecResult^ Result in _Results)
+	{
+		Builder->AppendLine(System::String::Format("{0,-8} {1,-12} {2,7} {3,12} {4,12} {5,7:0.000} {6,10:0.0} {7,11:0.0} {8}", Result->ContentType, Result->Compression, Result->SampleCount, Result->Size, Result->CompressedSize, Result->Ratio, Result->CompressSpeed, Result->DecompressSpeed, Result->IsLossless ? "Yes" : "No"));
+	}
+
+	return Builder->ToString();
+}
+
+System::String^ MpqLib::Benchmark::CCodecReport::ToJson()
+{
+	System::Text::StringBuilder^ Builder = gcnew System::Text::StringBuilder();
+
+	Builder->Append("{\"sectorSize\":" + _SectorSize + ",\"iterations\":" + _Iterations + ",\"results\":[");
+
+	for(System::Int32 i = 0; i < _Results->Count; i++)
+	{
+		CCodecResult^ Result = _Results[i];
+
+		if(i > 0) Builder->Append(",");
+		Builder->Append("{\"contentType\":" + Mpq::CJson::FormatString(Result->ContentType));
+		Builder->Append(",\"compression\":" + Mpq::CJson::FormatString(Result->Compression.ToString()));
+		Builder->Append(",\"samples\":" + Result->SampleCount);
+		Builder->Append(",\"size\":" + Result->Size);
+		Builder->Append(",\"compressedSize\":" + Result->CompressedSize);
+		Builder->Append(",\"ratio\":" + Mpq::CJson::FormatNumber(Result->Ratio));
+		Builder->Append(",\"compressMBps\":" + Mpq::CJson::FormatNumber(Result->CompressSpeed));
+		Builder->Append(",\"decompressMBps\":" + Mpq::CJson::FormatNumber(Result->DecompressSpeed));
+		Builder->Append(",\"lossless\":")->Append(Result->IsLossless ? "true" : "false")->Append("}");
+	}
+
+	Builder->Append("]}");
+
+	return Builder->ToString();
+}
+
+System::Int32 MpqLib::Benchmark::CCodecReport::SectorSize::get()
+{
+	return _SectorSize;
+}
+
+System::Int32 MpqLib::Benchmark::CCodecReport::Iterations::get()
+{
+	return _Iterations;
+}
+
+System::Collections::ObjectModel::ReadOnlyCollection<MpqLib::Benchmark::CCodecResult^>^ MpqLib::Benchmark::CCodecReport::Results::get()
+{
+	return _Results;
+}
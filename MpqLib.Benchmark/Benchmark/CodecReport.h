@@ -0,0 +1,85 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "CodecResult.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// The immutable result of a codec benchmark, one entry per content type and compression format.
+		/// </summary>
+		public ref class CCodecReport sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="SectorSize">The sector size the samples were encoded with to use</param>
+				/// <param name="Iterations">The number of passes over the samples to use</param>
+				/// <param name="Results">The measurements to use</param>
+				CCodecReport(System::Int32 SectorSize, System::Int32 Iterations, System::Collections::Generic::IList<CCodecResult^>^ Results);
+
+				/// <summary>
+				/// Generates a string version of the report, a table with one row per result.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Generates a JSON version of the report.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				System::String^ ToJson();
+
+				/// <summary>
+				/// Retrieves the sector size the samples were encoded with.
+				/// </summary>
+				property System::Int32 SectorSize { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the number of passes over the samples.
+				/// </summary>
+				property System::Int32 Iterations { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the measurements, ordered by content type and compression format.
+				/// </summary>
+				property System::Collections::ObjectModel::ReadOnlyCollection<CCodecResult^>^ Results { System::Collections::ObjectModel::ReadOnlyCollection<CCodecResult^>^ get(); }
+
+			private:
+				System::Int32 _SectorSize;
+				System::Int32 _Iterations;
+				System::Collections::ObjectModel::ReadOnlyCollection<CCodecResult^>^ _Results;
+		};
+	}
+}
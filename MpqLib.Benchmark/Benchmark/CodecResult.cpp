@@ -0,0 +1,92 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "CodecResult.h"
+
+MpqLib::Benchmark::CCodecResult::CCodecResult(System::String^ ContentType, Mpq::ECompression Compression, System::Int32 SampleCount, System::Int64 Size, System::Int64 CompressedSize, System::Double CompressSpeed, System::Double DecompressSpeed, System::Boolean IsLossless)
+{
+	_ContentType = ContentType;
+	_Compression = Compression;
+	_SampleCount = SampleCount;
+	_Size = Size;
+	_CompressedSize = CompressedSize;
+	_CompressSpeed = CompressSpeed;
+	_DecompressSpeed = DecompressSpeed;
+	_IsLossless = IsLossless;
+}
+
+System::String^ MpqLib::Benchmark::CCodecResult::ToString()
+{
+	return _ContentType + " " + _Compression.ToString() + ": ratio " + Ratio.ToString("0.000") + ", compress " + _CompressSpeed.ToString("0.0") + " MB/s, decompress " + _DecompressSpeed.ToString("0.0") + " MB/s" + (_IsLossless ? "" : " (lossy)");
+}
+
+System::String^ MpqLib::Benchmark::CCodecResult::ContentType::get()
+{
+	return _ContentType;
+}
+
+MpqLib::Mpq::ECompression MpqLib::Benchmark::CCodecResult::Compression::get()
+{
+	return _Compression;
+}
+
+System::Int32 MpqLib::Benchmark::CCodecResult::SampleCount::get()
+{
+	return _SampleCount;
+}
+
+System::Int64 MpqLib::Benchmark::CCodecResult::Size::get()
+{
+	return _Size;
+}
+
+System::Int64 MpqLib::Benchmark::CCodecResult::CompressedSize::get()
+{
+	return _CompressedSize;
+}
+
+System::Double MpqLib::Benchmark::CCodecResult::Ratio::get()
+{
+	return (_Size > 0) ? (static_cast<System::Double>(_CompressedSize) / _Size) : 1.0;
+}
+
+System::Double MpqLib::Benchmark::CCodecResult::CompressSpeed::get()
+{
+	return _CompressSpeed;
+}
+
+System::Double MpqLib::Benchmark::CCodecResult::DecompressSpeed::get()
+{
+	return _DecompressSpeed;
+}
+
+System::Boolean MpqLib::Benchmark::CCodecResult::IsLossless::get()
+{
+	return _IsLossless;
+}
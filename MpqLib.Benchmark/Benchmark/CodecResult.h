@@ -0,0 +1,119 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Include.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// The immutable measurements of one compression format over the samples of one content type.
+		/// </summary>
+		public ref class CCodecResult sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="ContentType">The content type of the samples to use</param>
+				/// <param name="Compression">The compression format to use</param>
+				/// <param name="SampleCount">The number of samples to use</param>
+				/// <param name="Size">The total size of the samples to use</param>
+				/// <param name="CompressedSize">The total size of the encoded samples to use</param>
+				/// <param name="CompressSpeed">The compression speed in megabytes per second to use</param>
+				/// <param name="DecompressSpeed">The decompression speed in megabytes per second to use</param>
+				/// <param name="IsLossless">True if the samples decoded to the original data</param>
+				CCodecResult(System::String^ ContentType, Mpq::ECompression Compression, System::Int32 SampleCount, System::Int64 Size, System::Int64 CompressedSize, System::Double CompressSpeed, System::Double DecompressSpeed, System::Boolean IsLossless);
+
+				/// <summary>
+				/// Generates a string version of the result.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the content type of the samples.
+				/// </summary>
+				property System::String^ ContentType { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the compression format.
+				/// </summary>
+				property Mpq::ECompression Compression { Mpq::ECompression get(); }
+
+				/// <summary>
+				/// Retrieves the number of samples.
+				/// </summary>
+				property System::Int32 SampleCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the total size of the samples.
+				/// </summary>
+				property System::Int64 Size { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the total size of the encoded samples (sector offset tables included).
+				/// </summary>
+				property System::Int64 CompressedSize { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the compressed size relative to the original size (lower is better).
+				/// </summary>
+				property System::Double Ratio { System::Double get(); }
+
+				/// <summary>
+				/// Retrieves the compression speed in megabytes of original data per second.
+				/// </summary>
+				property System::Double CompressSpeed { System::Double get(); }
+
+				/// <summary>
+				/// Retrieves the decompression speed in megabytes of original data per second.
+				/// </summary>
+				property System::Double DecompressSpeed { System::Double get(); }
+
+				/// <summary>
+				/// Checks if the samples decoded to the original data (the wave formats are lossy).
+				/// </summary>
+				property System::Boolean IsLossless { System::Boolean get(); }
+
+			private:
+				System::String^ _ContentType;
+				Mpq::ECompression _Compression;
+				System::Int32 _SampleCount;
+				System::Int64 _Size;
+				System::Int64 _CompressedSize;
+				System::Double _CompressSpeed;
+				System::Double _DecompressSpeed;
+				System::Boolean _IsLossless;
+		};
+	}
+}
@@ -0,0 +1,101 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "OpenBenchmark.h"
+
+MpqLib::Benchmark::COpenBenchmark::COpenBenchmark(System::String^ ArchiveFileName)
+{
+	if(ArchiveFileName == nullptr) throw gcnew System::ArgumentNullException("ArchiveFileName");
+
+	_ArchiveFileName = ArchiveFileName;
+	_Passes = 3;
+	_FileCount = 0;
+}
+
+array<System::Double>^ MpqLib::Benchmark::COpenBenchmark::Run(System::Boolean Misses)
+{
+	array<System::Double>^ Results = gcnew array<System::Double>(_Passes);
+	Mpq::CArchive^ Archive = gcnew Mpq::CArchive(_ArchiveFileName);
+
+	try
+	{
+		System::Collections::Generic::List<System::String^>^ FileNames = gcnew System::Collections::Generic::List<System::String^>();
+		for each(Mpq::CFileInfo^ FileInfo in Archive->FindFiles("*"))
+		{
+			if(!Misses)
+			{
+				FileNames->Add(FileInfo->FileName);
+				continue;
+			}
+
+			//The missing names live in the same directories as the real ones, only their extension differs
+			System::String^ MissingFileName = System::IO::Path::ChangeExtension(FileInfo->FileName, ".missing");
+			if(!Archive->FileExists(MissingFileName, LANG_NEUTRAL)) FileNames->Add(MissingFileName);
+		}
+
+		_FileCount = FileNames->Count;
+
+		for(System::Int32 Pass = 0; Pass < _Passes; Pass++)
+		{
+			System::Diagnostics::Stopwatch^ Watch = System::Diagnostics::Stopwatch::StartNew();
+			for each(System::String^ FileName in FileNames)
+			{
+				//A miss is reported without an exception, the same way a hit is opened
+				Mpq::CFileStream^ FileStream = Mpq::CFileStream::TryOpen(Archive, FileName, LANG_NEUTRAL, false);
+				if(FileStream != nullptr) delete FileStream;
+			}
+			Watch->Stop();
+
+			Results[Pass] = (Watch->Elapsed.TotalSeconds > 0) ? (FileNames->Count / Watch->Elapsed.TotalSeconds) : 0;
+		}
+	}
+	finally
+	{
+		delete Archive;
+	}
+
+	return Results;
+}
+
+System::Int32 MpqLib::Benchmark::COpenBenchmark::Passes::get()
+{
+	return _Passes;
+}
+
+System::Void MpqLib::Benchmark::COpenBenchmark::Passes::set(System::Int32 Value)
+{
+	if(Value < 1) throw gcnew System::ArgumentOutOfRangeException("Value", "At least one pass is needed!");
+
+	_Passes = Value;
+}
+
+System::Int32 MpqLib::Benchmark::COpenBenchmark::FileCount::get()
+{
+	return _FileCount;
+}
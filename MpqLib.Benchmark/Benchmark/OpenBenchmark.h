@@ -0,0 +1,75 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Include.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// Measures how many files of an archive can be opened and closed per second. The streams
+		/// are opened without preloading, so the time is spent resolving names and creating handles.
+		/// The misses look up names derived from those in the archive, which it does not contain.
+		/// </summary>
+		public ref class COpenBenchmark sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="ArchiveFileName">The archive to open the files of</param>
+				COpenBenchmark(System::String^ ArchiveFileName);
+
+				/// <summary>
+				/// Runs the passes over the files of the archive.
+				/// </summary>
+				/// <param name="Misses">True to open names missing from the archive, false to open the files in it</param>
+				/// <returns>The opens per second, one entry per pass</returns>
+				array<System::Double>^ Run(System::Boolean Misses);
+
+				/// <summary>
+				/// Gets or sets the number of passes over the files.
+				/// </summary>
+				property System::Int32 Passes { System::Int32 get(); System::Void set(System::Int32 Value); }
+
+				/// <summary>
+				/// Retrieves the number of names opened per pass, known after a run.
+				/// </summary>
+				property System::Int32 FileCount { System::Int32 get(); }
+
+			private:
+				System::String^ _ArchiveFileName;
+				System::Int32 _Passes;
+				System::Int32 _FileCount;
+		};
+	}
+}
@@ -0,0 +1,99 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "PoolBenchmark.h"
+
+MpqLib::Benchmark::CPoolBenchmark::CPoolBenchmark(System::String^ ArchiveFileName)
+{
+	if(ArchiveFileName == nullptr) throw gcnew System::ArgumentNullException("ArchiveFileName");
+
+	_ArchiveFileName = ArchiveFileName;
+	_Passes = 3;
+}
+
+System::Collections::ObjectModel::ReadOnlyCollection<MpqLib::Benchmark::CPoolResult^>^ MpqLib::Benchmark::CPoolBenchmark::Run()
+{
+	System::Collections::Generic::List<CPoolResult^>^ Results = gcnew System::Collections::Generic::List<CPoolResult^>();
+	Mpq::CArchive^ Archive = gcnew Mpq::CArchive(_ArchiveFileName);
+
+	try
+	{
+		System::Collections::Generic::List<System::String^>^ FileNames = gcnew System::Collections::Generic::List<System::String^>();
+		for each(Mpq::CFileInfo^ FileInfo in Archive->FindFiles("*")) FileNames->Add(FileInfo->FileName);
+
+		Mpq::CBufferPool^ BufferPool = Archive->BufferPool;
+		array<System::Byte>^ Buffer = gcnew array<System::Byte>(0x10000);
+
+		for(System::Int32 Pass = 1; Pass <= _Passes; Pass++)
+		{
+			System::Int64 RentCount = BufferPool->RentCount;
+			System::Int64 HitCount = BufferPool->HitCount;
+			System::Int64 AllocatedSize = BufferPool->AllocatedSize;
+			System::Int32 CollectionCount = System::GC::CollectionCount(0);
+			System::Int64 Size = 0;
+
+			System::Diagnostics::Stopwatch^ Watch = System::Diagnostics::Stopwatch::StartNew();
+			for each(System::String^ FileName in FileNames)
+			{
+				Mpq::CFileStream^ Stream = gcnew Mpq::CFileStream(Archive, FileName);
+
+				try
+				{
+					System::Int32 BytesRead;
+					while((BytesRead = Stream->Read(Buffer, 0, Buffer->Length)) > 0) Size += BytesRead;
+				}
+				finally
+				{
+					delete Stream;
+				}
+			}
+			Watch->Stop();
+
+			Results->Add(gcnew CPoolResult(Pass, FileNames->Count, Size, Watch->Elapsed.TotalSeconds, BufferPool->RentCount - RentCount, BufferPool->HitCount - HitCount, BufferPool->AllocatedSize - AllocatedSize, System::GC::CollectionCount(0) - CollectionCount));
+		}
+	}
+	finally
+	{
+		delete Archive;
+	}
+
+	return gcnew System::Collections::ObjectModel::ReadOnlyCollection<CPoolResult^>(Results);
+}
+
+System::Int32 MpqLib::Benchmark::CPoolBenchmark::Passes::get()
+{
+	return _Passes;
+}
+
+System::Void MpqLib::Benchmark::CPoolBenchmark::Passes::set(System::Int32 Value)
+{
+	if(Value < 1) throw gcnew System::ArgumentOutOfRangeException("Value", "At least one pass is needed!");
+
+	_Passes = Value;
+}
@@ -0,0 +1,68 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "PoolResult.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// Measures the buffer pool of an archive by opening, reading and closing each of its files
+		/// over several passes. The first pass starts with an empty pool, the later passes show how
+		/// many buffers (and collections) the pool saves once it has warmed up.
+		/// </summary>
+		public ref class CPoolBenchmark sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="ArchiveFileName">The archive to read the files of</param>
+				CPoolBenchmark(System::String^ ArchiveFileName);
+
+				/// <summary>
+				/// Runs the passes over the files of the archive.
+				/// </summary>
+				/// <returns>The measurements, one per pass</returns>
+				System::Collections::ObjectModel::ReadOnlyCollection<CPoolResult^>^ Run();
+
+				/// <summary>
+				/// Gets or sets the number of passes over the files.
+				/// </summary>
+				property System::Int32 Passes { System::Int32 get(); System::Void set(System::Int32 Value); }
+
+			private:
+				System::String^ _ArchiveFileName;
+				System::Int32 _Passes;
+		};
+	}
+}
@@ -0,0 +1,92 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "PoolResult.h"
+
+MpqLib::Benchmark::CPoolResult::CPoolResult(System::Int32 Pass, System::Int32 FileCount, System::Int64 Size, System::Double Seconds, System::Int64 RentCount, System::Int64 HitCount, System::Int64 AllocatedSize, System::Int32 CollectionCount)
+{
+	_Pass = Pass;
+	_FileCount = FileCount;
+	_Size = Size;
+	_Seconds = Seconds;
+	_RentCount = RentCount;
+	_HitCount = HitCount;
+	_AllocatedSize = AllocatedSize;
+	_CollectionCount = CollectionCount;
+}
+
+System::String^ MpqLib::Benchmark::CPoolResult::ToString()
+{
+	return "Pass " + _Pass + ": " + FilesPerSecond.ToString("0.0") + " files/s, " + _HitCount + "/" + _RentCount + " pooled, " + _AllocatedSize + " bytes allocated";
+}
+
+System::Int32 MpqLib::Benchmark::CPoolResult::Pass::get()
+{
+	return _Pass;
+}
+
+System::Int32 MpqLib::Benchmark::CPoolResult::FileCount::get()
+{
+	return _FileCount;
+}
+
+System::Int64 MpqLib::Benchmark::CPoolResult::Size::get()
+{
+	return _Size;
+}
+
+System::Double MpqLib::Benchmark::CPoolResult::Seconds::get()
+{
+	return _Seconds;
+}
+
+System::Double MpqLib::Benchmark::CPoolResult::FilesPerSecond::get()
+{
+	return (_Seconds > 0) ? (_FileCount / _Seconds) : 0;
+}
+
+System::Int64 MpqLib::Benchmark::CPoolResult::RentCount::get()
+{
+	return _RentCount;
+}
+
+System::Int64 MpqLib::Benchmark::CPoolResult::HitCount::get()
+{
+	return _HitCount;
+}
+
+System::Int64 MpqLib::Benchmark::CPoolResult::AllocatedSize::get()
+{
+	return _AllocatedSize;
+}
+
+System::Int32 MpqLib::Benchmark::CPoolResult::CollectionCount::get()
+{
+	return _CollectionCount;
+}
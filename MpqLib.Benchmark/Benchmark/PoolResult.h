@@ -0,0 +1,119 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Include.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// The immutable measurements of one pass of open-read-close cycles over the files of an archive.
+		/// </summary>
+		public ref class CPoolResult sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Pass">The number of the pass to use, starting at 1</param>
+				/// <param name="FileCount">The number of files opened to use</param>
+				/// <param name="Size">The total number of bytes read to use</param>
+				/// <param name="Seconds">The duration of the pass to use</param>
+				/// <param name="RentCount">The number of buffers handed out by the pool to use</param>
+				/// <param name="HitCount">The number of buffers handed out without allocating to use</param>
+				/// <param name="AllocatedSize">The number of bytes the pool allocated to use</param>
+				/// <param name="CollectionCount">The number of first generation collections to use</param>
+				CPoolResult(System::Int32 Pass, System::Int32 FileCount, System::Int64 Size, System::Double Seconds, System::Int64 RentCount, System::Int64 HitCount, System::Int64 AllocatedSize, System::Int32 CollectionCount);
+
+				/// <summary>
+				/// Generates a string version of the result.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the number of the pass, starting at 1.
+				/// </summary>
+				property System::Int32 Pass { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the number of files opened.
+				/// </summary>
+				property System::Int32 FileCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the total number of bytes read.
+				/// </summary>
+				property System::Int64 Size { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the duration of the pass in seconds.
+				/// </summary>
+				property System::Double Seconds { System::Double get(); }
+
+				/// <summary>
+				/// Retrieves the number of files opened, read and closed per second.
+				/// </summary>
+				property System::Double FilesPerSecond { System::Double get(); }
+
+				/// <summary>
+				/// Retrieves the number of buffers handed out by the pool.
+				/// </summary>
+				property System::Int64 RentCount { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of buffers handed out without allocating.
+				/// </summary>
+				property System::Int64 HitCount { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of bytes the pool allocated.
+				/// </summary>
+				property System::Int64 AllocatedSize { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of first generation collections during the pass.
+				/// </summary>
+				property System::Int32 CollectionCount { System::Int32 get(); }
+
+			private:
+				System::Int32 _Pass;
+				System::Int32 _FileCount;
+				System::Int64 _Size;
+				System::Double _Seconds;
+				System::Int64 _RentCount;
+				System::Int64 _HitCount;
+				System::Int64 _AllocatedSize;
+				System::Int32 _CollectionCount;
+		};
+	}
+}
@@ -0,0 +1,162 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "CodecBenchmark.h"
+#include "PoolBenchmark.h"
+#include "OpenBenchmark.h"
+
+namespace MpqLib
+{
+	namespace Benchmark
+	{
+		/// <summary>
+		/// The command line entry of the benchmarks, the first argument names the benchmark to run.
+		/// </summary>
+		private ref class CProgram abstract sealed
+		{
+			public:
+				static System::Int32 Run(array<System::String^>^ Arguments);
+
+			private:
+				static System::Int32 RunCodecs(array<System::String^>^ Arguments);
+				static System::Int32 RunPool(array<System::String^>^ Arguments);
+				static System::Int32 RunOpen(array<System::String^>^ Arguments);
+				static System::Void AddSamples(CCodecBenchmark^ Benchmark, System::String^ Path);
+				static System::Boolean HasOption(array<System::String^>^ Arguments, System::String^ Option);
+				static System::Int32 PrintUsage();
+		};
+	}
+}
+
+System::Int32 MpqLib::Benchmark::CProgram::Run(array<System::String^>^ Arguments)
+{
+	if(Arguments->Length == 0) return PrintUsage();
+
+	try
+	{
+		if(System::String::Equals(Arguments[0], "codecs", System::StringComparison::OrdinalIgnoreCase)) return RunCodecs(Arguments);
+		if(System::String::Equals(Arguments[0], "pool", System::StringComparison::OrdinalIgnoreCase) && (Arguments->Length > 1)) return RunPool(Arguments);
+		if(System::String::Equals(Arguments[0], "open", System::StringComparison::OrdinalIgnoreCase) && (Arguments->Length > 1)) return RunOpen(Arguments);
+	}
+	catch(System::Exception^ Exception)
+	{
+		System::Console::Error->WriteLine(Exception->Message);
+		return 1;
+	}
+
+	return PrintUsage();
+}
+
+System::Int32 MpqLib::Benchmark::CProgram::RunCodecs(array<System::String^>^ Arguments)
+{
+	CCodecBenchmark^ Benchmark = gcnew CCodecBenchmark();
+
+	for(System::Int32 i = 1; i < Arguments->Length; i++)
+	{
+		if(Arguments[i]->StartsWith("-"))
+		{
+			if(System::String::Equals(Arguments[i], "-iterations", System::StringComparison::OrdinalIgnoreCase) && (i + 1 < Arguments->Length)) Benchmark->Iterations = System::Int32::Parse(Arguments[++i]);
+			continue;
+		}
+
+		AddSamples(Benchmark, Arguments[i]);
+	}
+
+	CCodecReport^ Report = Benchmark->Run();
+	System::Console::WriteLine(HasOption(Arguments, "-json") ? Report->ToJson() : Report->ToString());
+
+	return 0;
+}
+
+System::Int32 MpqLib::Benchmark::CProgram::RunPool(array<System::String^>^ Arguments)
+{
+	CPoolBenchmark^ Benchmark = gcnew CPoolBenchmark(Arguments[1]);
+	if(Arguments->Length > 2) Benchmark->Passes = System::Int32::Parse(Arguments[2]);
+
+	for each(CPoolResult^ Result in Benchmark->Run()) System::Console::WriteLine(Result);
+
+	return 0;
+}
+
+System::Int32 MpqLib::Benchmark::CProgram::RunOpen(array<System::String^>^ Arguments)
+{
+	COpenBenchmark^ Benchmark = gcnew COpenBenchmark(Arguments[1]);
+	if(Arguments->Length > 2) Benchmark->Passes = System::Int32::Parse(Arguments[2]);
+
+	array<System::Double>^ Results = Benchmark->Run(false);
+	for(System::Int32 i = 0; i < Results->Length; i++) System::Console::WriteLine("Pass " + (i + 1) + ": " + Results[i].ToString("0.0") + " opens/s over " + Benchmark->FileCount + " files (hits)");
+
+	Results = Benchmark->Run(true);
+	for(System::Int32 i = 0; i < Results->Length; i++) System::Console::WriteLine("Pass " + (i + 1) + ": " + Results[i].ToString("0.0") + " opens/s over " + Benchmark->FileCount + " names (misses)");
+
+	return 0;
+}
+
+System::Void MpqLib::Benchmark::CProgram::AddSamples(CCodecBenchmark^ Benchmark, System::String^ Path)
+{
+	if(!System::IO::Directory::Exists(Path))
+	{
+		Benchmark->AddSample(Path);
+		return;
+	}
+
+	for each(System::String^ FileName in System::IO::Directory::GetFiles(Path, "*", System::IO::SearchOption::AllDirectories))
+	{
+		Benchmark->AddSample(FileName);
+	}
+}
+
+System::Boolean MpqLib::Benchmark::CProgram::HasOption(array<System::String^>^ Arguments, System::String^ Option)
+{
+	for each(System::String^ Argument in Arguments)
+	{
+		if(System::String::Equals(Argument, Option, System::StringComparison::OrdinalIgnoreCase)) return true;
+	}
+
+	return false;
+}
+
+System::Int32 MpqLib::Benchmark::CProgram::PrintUsage()
+{
+	System::Console::WriteLine("Usage: MpqLib.Benchmark <benchmark> [arguments]");
+	System::Console::WriteLine();
+	System::Console::WriteLine("  codecs <files or directories> [-iterations N] [-json]");
+	System::Console::WriteLine("      Measures every compression format over the given samples, one thread, sector by sector.");
+	System::Console::WriteLine("  pool <archive> [passes]");
+	System::Console::WriteLine("      Opens, reads and closes every file of the archive once per pass, reports the buffer pool hits.");
+	System::Console::WriteLine("  open <archive> [passes]");
+	System::Console::WriteLine("      Opens and closes every file of the archive once per pass without reading, then opens as many missing names, reports the opens per second.");
+
+	return 1;
+}
+
+int main(array<System::String^>^ Arguments)
+{
+	return MpqLib::Benchmark::CProgram::Run(Arguments);
+}
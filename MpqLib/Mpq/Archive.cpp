@@ -28,6 +28,12 @@
 //|
 //+-----------------------------------------------------------------------------
 #include "Archive.h"
+#include "ArchiveComparer.h"
+#include "ArchiveEditor.h"
+#include "ArchiveVerifier.h"
+#include "ArchiveWriter.h"
+#include "ExportScheduler.h"
+#include "Attributes.h"
 
 MpqLib::Mpq::CArchive::CArchive(System::String^ FileName)
 {
@@ -35,6 +41,27 @@ MpqLib::Mpq::CArchive::CArchive(System::String^ FileName)
 
 	_Handle = NULL;
 	_FileName = FileName;
+	_Format = EArchiveFormat::Version1;
+
+	_Locale = LANG_NEUTRAL;
+	_MaxHashTableLoadFactor = CConstants::DefaultMaxHashTableLoadFactor;
+	_Index = nullptr;
+	_Header = nullptr;
+	_Generation = 0;
+	_IndexLock = gcnew System::Object();
+	_ImportMode = EImportMode::Normal;
+	_MemoryBudget = gcnew CMemoryBudget();
+	_BufferPool = gcnew CBufferPool();
+	_ShareIndex = false;
+	_HasPendingChanges = false;
+	_ContentIndex = nullptr;
+	_NameTrie = nullptr;
+	_TraceSink = nullptr;
+	_Root = nullptr;
+	_RootChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_UnflushedChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_Readers = gcnew System::Collections::Generic::List<System::WeakReference^>();
+	_PendingLinks = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>(System::StringComparer::OrdinalIgnoreCase);
 
 	Open(false, EArchiveFormat::Version2, CConstants::DefaultHashTableSize);
 }
@@ -45,6 +72,27 @@ MpqLib::Mpq::CArchive::CArchive(System::String^ FileName, System::Boolean Create
 
 	_Handle = NULL;
 	_FileName = FileName;
+	_Format = EArchiveFormat::Version1;
+
+	_Locale = LANG_NEUTRAL;
+	_MaxHashTableLoadFactor = CConstants::DefaultMaxHashTableLoadFactor;
+	_Index = nullptr;
+	_Header = nullptr;
+	_Generation = 0;
+	_IndexLock = gcnew System::Object();
+	_ImportMode = EImportMode::Normal;
+	_MemoryBudget = gcnew CMemoryBudget();
+	_BufferPool = gcnew CBufferPool();
+	_ShareIndex = false;
+	_HasPendingChanges = false;
+	_ContentIndex = nullptr;
+	_NameTrie = nullptr;
+	_TraceSink = nullptr;
+	_Root = nullptr;
+	_RootChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_UnflushedChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_Readers = gcnew System::Collections::Generic::List<System::WeakReference^>();
+	_PendingLinks = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>(System::StringComparer::OrdinalIgnoreCase);
 
 	Open(CreateIfNotExists, EArchiveFormat::Version2, CConstants::DefaultHashTableSize);
 }
@@ -55,6 +103,27 @@ MpqLib::Mpq::CArchive::CArchive(System::String^ FileName, System::Boolean Create
 
 	_Handle = NULL;
 	_FileName = FileName;
+	_Format = EArchiveFormat::Version1;
+
+	_Locale = LANG_NEUTRAL;
+	_MaxHashTableLoadFactor = CConstants::DefaultMaxHashTableLoadFactor;
+	_Index = nullptr;
+	_Header = nullptr;
+	_Generation = 0;
+	_IndexLock = gcnew System::Object();
+	_ImportMode = EImportMode::Normal;
+	_MemoryBudget = gcnew CMemoryBudget();
+	_BufferPool = gcnew CBufferPool();
+	_ShareIndex = false;
+	_HasPendingChanges = false;
+	_ContentIndex = nullptr;
+	_NameTrie = nullptr;
+	_TraceSink = nullptr;
+	_Root = nullptr;
+	_RootChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_UnflushedChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_Readers = gcnew System::Collections::Generic::List<System::WeakReference^>();
+	_PendingLinks = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>(System::StringComparer::OrdinalIgnoreCase);
 
 	Open(CreateIfNotExists, ArchiveFormat, CConstants::DefaultHashTableSize);
 }
@@ -65,6 +134,27 @@ MpqLib::Mpq::CArchive::CArchive(System::String^ FileName, System::Boolean Create
 
 	_Handle = NULL;
 	_FileName = FileName;
+	_Format = EArchiveFormat::Version1;
+
+	_Locale = LANG_NEUTRAL;
+	_MaxHashTableLoadFactor = CConstants::DefaultMaxHashTableLoadFactor;
+	_Index = nullptr;
+	_Header = nullptr;
+	_Generation = 0;
+	_IndexLock = gcnew System::Object();
+	_ImportMode = EImportMode::Normal;
+	_MemoryBudget = gcnew CMemoryBudget();
+	_BufferPool = gcnew CBufferPool();
+	_ShareIndex = false;
+	_HasPendingChanges = false;
+	_ContentIndex = nullptr;
+	_NameTrie = nullptr;
+	_TraceSink = nullptr;
+	_Root = nullptr;
+	_RootChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_UnflushedChanges = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_Readers = gcnew System::Collections::Generic::List<System::WeakReference^>();
+	_PendingLinks = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>(System::StringComparer::OrdinalIgnoreCase);
 
 	Open(CreateIfNotExists, ArchiveFormat, HashTableSize);
 }
@@ -92,23 +182,215 @@ System::Void MpqLib::Mpq::CArchive::Flush()
 {
 	CheckBadState();
 
-	if(!SFileFlushArchive(_Handle)) throw gcnew System::IO::IOException("Flush operation failed!");
+	if(!_HasPendingChanges && !HasPendingNames()) return;
+
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "Flush", _FileName, nullptr);
+
+	try
+	{
+		GrowHashTable(false);
+
+		if(!SFileFlushArchive(_Handle)) throw gcnew System::IO::IOException("Flush operation failed!");
+
+		//Writing the names of deduplicated imports closes the archive for a moment, with streams open they wait for the next flush or the close
+		if(HasPendingNames() && !HasReaders()) WritePendingLinks(true);
+
+		//Flushing may add the special files, which are searchable like any other, and puts the tables on disk
+		DiscardIndex();
+
+		//The special files are rewritten, the directory tree catches up by name
+		if(_UnflushedChanges->Count > 0)
+		{
+			_RootChanges->UnionWith(_UnflushedChanges);
+			_RootChanges->Add(CConstants::ListFileName);
+			_RootChanges->Add(CConstants::AttributesFileName);
+			_UnflushedChanges->Clear();
+		}
+
+		_HasPendingChanges = false;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "Flush", _FileName, nullptr, TraceStart, 0);
+	}
 }
 
 System::Void MpqLib::Mpq::CArchive::Compact()
 {
 	CheckBadState();
 
+	//The blocks are moved under the open streams
+	CheckReaders();
+	GrowHashTable(false);
+
+	InvalidateIndex();
+	DiscardNames();
+	DiscardRoot();
+
+	//The names of deduplicated imports read their blocks by name, they are written by the next flush
 	if(!SFileCompactArchive(_Handle, NULL, FALSE)) throw gcnew System::IO::IOException("Compact operation failed!");
+
+	_UnflushedChanges->Clear();
+	_HasPendingChanges = false;
+}
+
+System::Void MpqLib::Mpq::CArchive::Compact(CCompressionOptions^ Options)
+{
+	CheckBadState();
+
+	System::UInt16 SectorSizeShift = 0;
+	while((0x200 << SectorSizeShift) < Header->SectorSize) SectorSizeShift++;
+
+	Compact(Options, SectorSizeShift);
+}
+
+System::Void MpqLib::Mpq::CArchive::Compact(CCompressionOptions^ Options, System::UInt16 SectorSizeShift)
+{
+	CheckBadState();
+
+	if(SectorSizeShift > CConstants::MaxSectorSizeShift) throw gcnew System::ArgumentOutOfRangeException("SectorSizeShift", "The sector size shift can be at most " + CConstants::MaxSectorSizeShift + "!");
+
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "Compact", _FileName, nullptr);
+
+	try
+	{
+		Flush();
+
+		//The old archive is replaced at the end, which the open streams would not survive (checked up front to not waste the rebuild)
+		CheckReaders();
+
+		CArchiveHeader^ ArchiveHeader = Header;
+		if(ArchiveHeader->Format > EArchiveFormat::Version2) throw gcnew System::NotSupportedException("Only version 1 and 2 archives can be rebuilt!");
+		if(ArchiveHeader->ArchiveOffset != 0) throw gcnew System::NotSupportedException("Archives embedded in other data can not be rebuilt!");
+
+		//The new archive is written next to the old one, so it can take its place in one step
+		CArchiveIndex^ ArchiveIndex = Index;
+		System::String^ TemporaryFileName = System::IO::Path::Combine(System::IO::Path::GetDirectoryName(System::IO::Path::GetFullPath(_FileName)), System::IO::Path::GetRandomFileName());
+
+		try
+		{
+			CArchiveWriter Writer(TemporaryFileName, ArchiveHeader->Format, SectorSizeShift);
+
+			for each(CFileInfo^ FileInfo in FindFiles("*"))
+			{
+				if((System::String::Compare(FileInfo->FileName, CConstants::ListFileName, true) == 0) || (System::String::Compare(FileInfo->FileName, CConstants::AttributesFileName, true) == 0)) continue;
+
+				//Pseudo names of unnamed blocks do not resolve, their files would be lost
+				CStringHandle FileNameHandle(FileInfo->FileName);
+				System::Int32 HashIndex = ArchiveIndex->FindHashEntry(FileNameHandle.Value, FileInfo->Locale);
+
+				if((HashIndex == CConstants::InvalidIndex) || (static_cast<System::Int32>(ArchiveIndex->GetHashEntry(HashIndex).BlockIndex) != FileInfo->BlockIndex))
+				{
+					throw gcnew System::IO::IOException("The name of \"" + FileInfo->FileName + "\" is unknown, the archive can not be rebuilt!");
+				}
+
+				//Without options every file keeps the compression it is stored with
+				CCompressionOptions^ FileOptions = (Options != nullptr) ? Options : gcnew CCompressionOptions(FileInfo->Compression);
+
+				Writer.Locale = FileInfo->Locale;
+				Writer.AddFile(FileInfo->FileName, ReadFile(FileInfo->FileName, FileInfo->Locale), FileOptions, FileInfo->Encryption);
+			}
+
+			Writer.Close();
+
+			BeginEdit();
+			DiscardRoot();
+
+			try
+			{
+				System::IO::File::Replace(TemporaryFileName, _FileName, nullptr);
+			}
+			catch(System::Exception^)
+			{
+				AbortEdit();
+				throw;
+			}
+
+			Reopen();
+		}
+		finally
+		{
+			if(System::IO::File::Exists(TemporaryFileName)) System::IO::File::Delete(TemporaryFileName);
+		}
+
+		_ContentIndex = nullptr;
+		_HasPendingChanges = false;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "Compact", _FileName, nullptr, TraceStart, 0, (Options != nullptr) ? System::Nullable<ECompression>(Options->Compression) : System::Nullable<ECompression>());
+	}
+}
+
+System::Boolean MpqLib::Mpq::CArchive::CompactIncrementally(System::Int64 MaxBytesMoved)
+{
+	CheckBadState();
+
+	if(MaxBytesMoved <= 0) throw gcnew System::ArgumentOutOfRangeException("MaxBytesMoved", "The number of bytes to move must be positive!");
+
+	//Unsaved changes have to reach the disk before the blocks are moved there
+	if(_HasPendingChanges) Flush();
+
+	//The blocks are moved on disk, StormLib has to let go of the archive meanwhile
+	BeginEdit();
+	DiscardRoot();
+
+	System::Boolean IsCompact = false;
+
+	try
+	{
+		CArchiveEditor Editor(_FileName);
+
+		IsCompact = Editor.Compact(MaxBytesMoved);
+		Editor.Save();
+	}
+	catch(System::Exception^)
+	{
+		AbortEdit();
+		throw;
+	}
+
+	Reopen();
+
+	_HasPendingChanges = false;
+
+	return IsCompact;
 }
 
 System::Boolean MpqLib::Mpq::CArchive::FileExists(System::String^ FileName)
 {
 	CheckBadState();
 
+	return FileExists(FileName, _Locale);
+}
+
+System::Boolean MpqLib::Mpq::CArchive::FileExists(System::String^ FileName, LCID Locale)
+{
+	CheckBadState();
+
+	System::String^ StoredFileName = ResolveFileName(FileName, Locale);
+
+	CStringHandle FileNameHandle(StoredFileName);
+	CArchiveIndex^ ArchiveIndex = Index;
+
+	if(!ArchiveIndex->IsAvailable) return (SFileHasFile(_Handle, const_cast<LPSTR>(FileNameHandle.Value)) != 0);
+
+	return (ArchiveIndex->FindHashEntry(FileNameHandle.Value, Locale) != CConstants::InvalidIndex);
+}
+
+System::Collections::Generic::IEnumerable<LCID>^ MpqLib::Mpq::CArchive::GetLocales(System::String^ FileName)
+{
+	CheckBadState();
+
 	CStringHandle FileNameHandle(FileName);
+	System::Collections::Generic::List<LCID>^ Locales = Index->FindLocales(FileNameHandle.Value);
+
+	//The pending names only stand for the neutral version
+	msclr::lock Lock(_IndexLock);
 
-	return (SFileHasFile(_Handle, const_cast<LPSTR>(FileNameHandle.Value)) != 0);
+	if(_PendingLinks->ContainsKey(FileName) && !Locales->Contains(LANG_NEUTRAL)) Locales->Add(LANG_NEUTRAL);
+
+	return Locales;
 }
 
 System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, System::String^ RealFileName)
@@ -129,12 +411,71 @@ System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, System:
 {
 	CheckBadState();
 
-	CStringHandle FileNameHandle(FileName);
-	CStringHandle RealFileNameHandle(RealFileName);
+	ImportFile(FileName, RealFileName, gcnew CCompressionOptions(Compression), Encryption);
+}
+
+System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, System::String^ RealFileName, CCompressionOptions^ Options, EEncryption Encryption)
+{
+	CheckBadState();
+
+	if(Options == nullptr) throw gcnew System::ArgumentNullException("Options");
+
+	//StormLib runs its codecs with fixed settings, other parameters need the table editor (checked up front to not lose the old version)
+	if(!Options->IsDefault)
+	{
+		if(Format > EArchiveFormat::Version2) throw gcnew System::NotSupportedException("Codec parameters can only be used in version 1 and 2 archives!");
+		CheckReaders();
+	}
+
+	ECompression Compression = Options->Compression;
+	System::Int64 TraceSize = 0;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "ImportFile", _FileName, FileName);
+
+	try
+	{
+		CStringHandle FileNameHandle(FileName);
+		CStringHandle RealFileNameHandle(RealFileName);
+
+		System::UInt32 Flags = BuildFileFlags(Compression, Encryption);
+		System::UInt32 CompressionFlags = BuildCompressionFlags(Compression);
+		System::String^ ContentKey = BuildContentKey(RealFileName, Flags, CompressionFlags);
 
-	throw gcnew System::IO::IOException("SFileAddFile obsolete");
-	//MHE REMOVED
-	//if(!SFileAddFile(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, BuildFileFlags(Compression, Encryption))) throw gcnew System::IO::IOException("Unable to import \"" + RealFileName + "\" as \"" + FileName + "\"!");
+		NoteChange(FileName);
+
+		if((ContentKey != nullptr) && ImportDuplicate(FileName, ContentKey)) return;
+
+		ForgetContent(FileName);
+		UnlinkFile(FileName);
+		ReleaseLinks(FileName);
+
+		//StormLib compresses on one core, large files are encoded on all of them and written by the table editor
+		if(!Options->IsDefault || IsEncodedImport(RealFileName, Flags))
+		{
+			WriteEncodedFile(FileName, RealFileName, Flags, CompressionFlags, Options);
+		}
+		else
+		{
+			InvalidateIndex();
+
+			if(!SFileAddFileEx(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, Flags, CompressionFlags, CompressionFlags))
+			{
+				//StormLib reports a full hash table as a full disk, grow the table and try once more
+				if((GetLastError() != ERROR_DISK_FULL) || !GrowHashTable(true) || !SFileAddFileEx(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, Flags, CompressionFlags, CompressionFlags))
+				{
+					throw gcnew System::IO::IOException("Unable to import \"" + RealFileName + "\" as \"" + FileName + "\"!");
+				}
+			}
+		}
+
+		UpdateName(FileName);
+
+		if(ContentKey != nullptr) ContentIndex[ContentKey] = FileName;
+		if(_TraceSink != nullptr) TraceSize = (gcnew System::IO::FileInfo(RealFileName))->Length;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "ImportFile", _FileName, FileName, TraceStart, TraceSize, Compression);
+	}
 }
 
 System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, array<System::Byte>^ FileData)
@@ -160,6 +501,15 @@ System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, array<S
 	ImportFile(FileName, TemporaryFile.FileName, Compression, Encryption);
 }
 
+System::Void MpqLib::Mpq::CArchive::ImportFile(System::String^ FileName, array<System::Byte>^ FileData, CCompressionOptions^ Options, EEncryption Encryption)
+{
+	CheckBadState();
+
+	CTemporaryFile TemporaryFile(FileData);
+
+	ImportFile(FileName, TemporaryFile.FileName, Options, Encryption);
+}
+
 System::Void MpqLib::Mpq::CArchive::ImportWaveFile(System::String^ FileName, System::String^ RealFileName, EQuality Quality)
 {
 	CheckBadState();
@@ -178,12 +528,39 @@ System::Void MpqLib::Mpq::CArchive::ImportWaveFile(System::String^ FileName, Sys
 {
 	CheckBadState();
 
-	CStringHandle FileNameHandle(FileName);
-	CStringHandle RealFileNameHandle(RealFileName);
+	System::Int64 TraceSize = 0;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "ImportWaveFile", _FileName, FileName);
+
+	try
+	{
+		CStringHandle FileNameHandle(FileName);
+		CStringHandle RealFileNameHandle(RealFileName);
+
+		System::UInt32 Flags = BuildFileFlags(Compression, Encryption);
+		System::UInt32 WaveFlags = BuildWaveFlags(Quality);
+
+		NoteChange(FileName);
+		ForgetContent(FileName);
+		UnlinkFile(FileName);
+		ReleaseLinks(FileName);
+		InvalidateIndex();
 
-	throw gcnew System::IO::IOException("SFileAddWave obsolete");
-	//MHE REMOVED
-	//if(!SFileAddWave(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, BuildFileFlags(Compression, Encryption), BuildWaveFlags(Quality))) throw gcnew System::IO::IOException("Unable to import \"" + RealFileName + "\" as \"" + FileName + "\"!");
+		if(!SFileAddWave(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, Flags, WaveFlags))
+		{
+			if((GetLastError() != ERROR_DISK_FULL) || !GrowHashTable(true) || !SFileAddWave(_Handle, RealFileNameHandle.Value, FileNameHandle.Value, Flags, WaveFlags))
+			{
+				throw gcnew System::IO::IOException("Unable to import \"" + RealFileName + "\" as \"" + FileName + "\"!");
+			}
+		}
+
+		UpdateName(FileName);
+
+		if(_TraceSink != nullptr) TraceSize = (gcnew System::IO::FileInfo(RealFileName))->Length;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "ImportWaveFile", _FileName, FileName, TraceStart, TraceSize, Compression);
+	}
 }
 
 System::Void MpqLib::Mpq::CArchive::ImportWaveFile(System::String^ FileName, array<System::Byte>^ FileData, EQuality Quality)
@@ -216,6 +593,10 @@ System::Void MpqLib::Mpq::CArchive::ImportListFile(System::String^ FileName)
 	CStringHandle FileNameHandle(FileName);
 
 	if(SFileAddListFile(_Handle, FileNameHandle.Value) != ERROR_SUCCESS) throw gcnew System::IO::IOException("Unable to import the listfile \"" + FileName + "\"!");
+
+	//Files known only by pseudo names may have gotten their real ones
+	DiscardIndex();
+	DiscardRoot();
 }
 
 System::Void MpqLib::Mpq::CArchive::ImportListFile(array<System::Byte>^ FileData)
@@ -231,10 +612,54 @@ System::Void MpqLib::Mpq::CArchive::ExportFile(System::String^ FileName, System:
 {
 	CheckBadState();
 
-	CStringHandle FileNameHandle(FileName);
-	CStringHandle RealFileNameHandle(RealFileName);
+	ExportFile(FileName, RealFileName, _Locale);
+}
+
+System::Void MpqLib::Mpq::CArchive::ExportFile(System::String^ FileName, System::String^ RealFileName, LCID Locale)
+{
+	CheckBadState();
+
+	System::Int64 TraceSize = 0;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "ExportFile", _FileName, FileName);
+
+	try
+	{
+		HANDLE FileHandle = OpenFile(FileName, Locale);
+		array<System::Byte>^ Buffer = _BufferPool->RentArray(CConstants::ExportBufferSize);
+		pin_ptr<System::Byte> BufferPointer = &Buffer[0];
 
-	if(!SFileExtractFile(_Handle, FileNameHandle.Value, RealFileNameHandle.Value ,SFILE_OPEN_FROM_MPQ)) throw gcnew System::IO::IOException("Unable to export \"" + FileName + "\" as \"" + RealFileName + "\"!");
+		try
+		{
+			System::IO::FileStream^ RealFile = gcnew System::IO::FileStream(RealFileName, System::IO::FileMode::Create, System::IO::FileAccess::Write);
+
+			try
+			{
+				while(true)
+				{
+					DWORD BytesRead = 0;
+					BOOL Success = SFileReadFile(FileHandle, BufferPointer, static_cast<DWORD>(Buffer->Length), &BytesRead, NULL);
+
+					if(BytesRead > 0) RealFile->Write(Buffer, 0, static_cast<System::Int32>(BytesRead));
+					TraceSize += BytesRead;
+					if(!Success && (GetLastError() != ERROR_HANDLE_EOF)) throw gcnew System::IO::IOException("Unable to export \"" + FileName + "\" as \"" + RealFileName + "\"!");
+					if(!Success || (BytesRead < static_cast<DWORD>(Buffer->Length))) break;
+				}
+			}
+			finally
+			{
+				RealFile->Close();
+			}
+		}
+		finally
+		{
+			SFileCloseFile(FileHandle);
+			_BufferPool->ReturnArray(Buffer);
+		}
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "ExportFile", _FileName, FileName, TraceStart, TraceSize);
+	}
 }
 
 System::Void MpqLib::Mpq::CArchive::ExportFile(System::String^ FileName, array<System::Byte>^ FileData)
@@ -254,6 +679,40 @@ System::Void MpqLib::Mpq::CArchive::ExportFile(System::String^ FileName, array<S
 	TemporaryFile.CopyTo(FileData, Index);
 }
 
+System::Int32 MpqLib::Mpq::CArchive::ExportFiles(System::String^ Mask, System::String^ Directory)
+{
+	CheckBadState();
+
+	return ExportFiles(FindFiles(Mask), Directory);
+}
+
+System::Int32 MpqLib::Mpq::CArchive::ExportFiles(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files, System::String^ Directory)
+{
+	CheckBadState();
+
+	if(Files == nullptr) throw gcnew System::ArgumentNullException("Files");
+	if(Directory == nullptr) throw gcnew System::ArgumentNullException("Directory");
+
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "ExportFiles", _FileName, nullptr);
+	System::Object^ Reader = gcnew System::Object();
+
+	try
+	{
+		//The blocks are read from the file directly, so pending changes have to be written first
+		Flush();
+		AttachReader(Reader);
+
+		CExportScheduler Scheduler(this, Directory);
+
+		return Scheduler.Export(Files);
+	}
+	finally
+	{
+		DetachReader(Reader);
+		CTracer::End(_TraceSink, "ExportFiles", _FileName, nullptr, TraceStart, 0);
+	}
+}
+
 System::Void MpqLib::Mpq::CArchive::RenameFile(System::String^ FileName, System::String^ NewFileName)
 {
 	CheckBadState();
@@ -261,7 +720,35 @@ System::Void MpqLib::Mpq::CArchive::RenameFile(System::String^ FileName, System:
 	CStringHandle FileNameHandle(FileName);
 	CStringHandle NewFileNameHandle(NewFileName);
 
+	NoteChange(FileName);
+	NoteChange(NewFileName);
+	ForgetContent(FileName);
+	ForgetContent(NewFileName);
+
+	LCID Locale = LANG_NEUTRAL;
+	System::String^ StoredFileName = ResolveFileName(FileName, Locale);
+	LCID NewLocale = LANG_NEUTRAL;
+	System::String^ NewStoredFileName = ResolveFileName(NewFileName, NewLocale);
+
+	//StormLib does not know the names of deduplicated imports yet, an existing one is not renamed over (like a stored one)
+	if(System::String::Compare(NewStoredFileName, NewFileName, true) != 0) throw gcnew System::IO::IOException("Unable to rename \"" + FileName + "\" to \"" + NewFileName + "\"!");
+
+	if(System::String::Compare(StoredFileName, FileName, true) != 0)
+	{
+		if(FileExists(NewFileName, LANG_NEUTRAL)) throw gcnew System::IO::IOException("Unable to rename \"" + FileName + "\" to \"" + NewFileName + "\"!");
+
+		LinkFile(NewFileName, StoredFileName);
+		UnlinkFile(FileName);
+		return;
+	}
+
+	InvalidateIndex();
+
 	if(!SFileRenameFile(_Handle, FileNameHandle.Value, NewFileNameHandle.Value)) throw gcnew System::IO::IOException("Unable to rename \"" + FileName + "\" to \"" + NewFileName + "\"!");
+
+	RetargetLinks(FileName, NewFileName);
+	RemoveName(FileName);
+	UpdateName(NewFileName);
 }
 
 System::Void MpqLib::Mpq::CArchive::RemoveFile(System::String^ FileName)
@@ -270,7 +757,17 @@ System::Void MpqLib::Mpq::CArchive::RemoveFile(System::String^ FileName)
 
 	CStringHandle FileNameHandle(FileName);
 
+	NoteChange(FileName);
+	ForgetContent(FileName);
+
+	//A deduplicated import only drops its link, a block read by such imports is handed over to one of them (see ReleaseLinks)
+	if(UnlinkFile(FileName) || ReleaseLinks(FileName)) return;
+
+	InvalidateIndex();
+
 	if(!SFileRemoveFile(_Handle, FileNameHandle.Value, SFILE_OPEN_FROM_MPQ)) throw gcnew System::IO::IOException("Unable to remove \"" + FileName + "\"!");
+
+	RemoveName(FileName);
 }
 
 System::Collections::Generic::IEnumerable<MpqLib::Mpq::CFileInfo^>^ MpqLib::Mpq::CArchive::FindFiles(System::String^ Mask)
@@ -302,38 +799,106 @@ System::Collections::Generic::IEnumerable<MpqLib::Mpq::CFileInfo^>^ MpqLib::Mpq:
 	CStringHandle FileNameHandle((ExternalListFile != nullptr) ? ExternalListFile : "");
 	System::Collections::Generic::List<MpqLib::Mpq::CFileInfo^>^ FileInfoList = gcnew System::Collections::Generic::List<MpqLib::Mpq::CFileInfo^>();
 
+	//The block details come from the index, the compression method is only read when asked for
+	CArchiveIndex^ ArchiveIndex = Index;
+	CArchiveHeader^ ArchiveHeader = Header;
+
 	if(TraverseListFileOnly)
 	{
 		SFILE_FIND_DATA SearchData;
 		HANDLE SearchHandle = SListFileFindFirstFile(_Handle, ((ExternalListFile != nullptr) ? FileNameHandle.Value : NULL), MaskHandle.Value, &SearchData);
-		if(SearchHandle == NULL) return FileInfoList;
 
 		while(SearchHandle != NULL)
 		{
-			FileInfoList->Add(gcnew CFileInfo(gcnew System::String(SearchData.cFileName), SearchData.dwFileSize, SearchData.dwCompSize));
+			System::String^ FileName = gcnew System::String(SearchData.cFileName);
+			System::Int32 HashIndex = ArchiveIndex->FindHashEntry(SearchData.cFileName, _Locale);
+			CFileInfo^ FileInfo = nullptr;
+
+			if(HashIndex != CConstants::InvalidIndex)
+			{
+				SHashEntry HashEntry = ArchiveIndex->GetHashEntry(HashIndex);
+				FileInfo = CreateFileInfo(FileName, static_cast<System::Int32>(HashEntry.BlockIndex), HashEntry.Locale, ArchiveIndex, ArchiveHeader);
+			}
+
+			FileInfoList->Add((FileInfo != nullptr) ? FileInfo : gcnew CFileInfo(FileName, SearchData.dwFileSize, SearchData.dwCompSize));
 			if(!SListFileFindNextFile(SearchHandle, &SearchData)) break;
 		}
 
-		SListFileFindClose(SearchHandle);
+		if(SearchHandle != NULL) SListFileFindClose(SearchHandle);
+	}
+	else if(ExternalListFile == nullptr)
+	{
+		//The known names are kept in a trie, a mask only visits the directories under its literal prefix
+		CNameTrie^ Trie = NameTrie;
+
+		for each(SNameEntry Entry in Trie->Find(gcnew CGlobMatcher(Mask)))
+		{
+			CFileInfo^ FileInfo = CreateFileInfo(Entry.FileName, Entry.BlockIndex, Entry.Locale, ArchiveIndex, ArchiveHeader);
+
+			FileInfoList->Add((FileInfo != nullptr) ? FileInfo : gcnew CFileInfo(Entry.FileName, Entry.FileSize, Entry.CompressedSize, Entry.BlockIndex, Entry.Locale, Entry.Flags, CConstants::InvalidIndex, ECompression::None));
+		}
 	}
 	else
 	{
 		SFILE_FIND_DATA SearchData;
-		HANDLE SearchHandle = SFileFindFirstFile(_Handle, MaskHandle.Value, &SearchData, ((ExternalListFile != nullptr) ? FileNameHandle.Value : NULL));
-		if(SearchHandle == NULL) return FileInfoList;
+		HANDLE SearchHandle = SFileFindFirstFile(_Handle, MaskHandle.Value, &SearchData, FileNameHandle.Value);
 
 		while(SearchHandle != NULL)
 		{
-			FileInfoList->Add(gcnew CFileInfo(gcnew System::String(SearchData.cFileName), SearchData.dwFileSize, SearchData.dwCompSize));
+			System::String^ FileName = gcnew System::String(SearchData.cFileName);
+			CFileInfo^ FileInfo = CreateFileInfo(FileName, static_cast<System::Int32>(SearchData.dwBlockIndex), SearchData.lcLocale, ArchiveIndex, ArchiveHeader);
+
+			FileInfoList->Add((FileInfo != nullptr) ? FileInfo : gcnew CFileInfo(FileName, SearchData.dwFileSize, SearchData.dwCompSize, static_cast<System::Int32>(SearchData.dwBlockIndex), SearchData.lcLocale, SearchData.dwFileFlags, CConstants::InvalidIndex, ECompression::None));
 			if(!SFileFindNextFile(SearchHandle, &SearchData)) break;
 		}
 
-		SFileFindClose(SearchHandle);
+		if(SearchHandle != NULL) SFileFindClose(SearchHandle);
 	}
 
+	AddPendingNames(FileInfoList, Mask, ArchiveIndex, ArchiveHeader);
+
 	return FileInfoList;
 }
 
+System::Collections::Generic::IEnumerable<MpqLib::Mpq::CDiffEntry^>^ MpqLib::Mpq::CArchive::Diff(CArchive^ Other)
+{
+	CheckBadState();
+
+	if(Other == nullptr) throw gcnew System::ArgumentNullException("Other");
+
+	//The checksums in "(attributes)" and the block numbers they are stored by are only brought up to date by a flush
+	Flush();
+	if(Other != this) Other->Flush();
+
+	CArchiveComparer Comparer(this, Other);
+
+	return Comparer.Compare();
+}
+
+MpqLib::Mpq::CVerifyReport^ MpqLib::Mpq::CArchive::Verify()
+{
+	CheckBadState();
+
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "Verify", _FileName, nullptr);
+	System::Object^ Reader = gcnew System::Object();
+
+	try
+	{
+		Flush();
+		AttachReader(Reader);
+
+		//The workers read the file through handles of their own, the tables must stay put meanwhile
+		CArchiveVerifier Verifier(this);
+
+		return Verifier.Verify();
+	}
+	finally
+	{
+		DetachReader(Reader);
+		CTracer::End(_TraceSink, "Verify", _FileName, nullptr, TraceStart, 0);
+	}
+}
+
 System::String^ MpqLib::Mpq::CArchive::ToString()
 {
 	CheckBadState();
@@ -352,154 +917,1089 @@ System::Int32 MpqLib::Mpq::CArchive::FileCount::get()
 	return val;
 }
 
-LCID MpqLib::Mpq::CArchive::Locale::get()
+MpqLib::Mpq::EArchiveFormat MpqLib::Mpq::CArchive::Format::get()
 {
 	CheckBadState();
 
-	return SFileGetLocale();
+	return _Format;
 }
 
-System::Void MpqLib::Mpq::CArchive::Locale::set(LCID Locale)
+System::Int64 MpqLib::Mpq::CArchive::FreeSpace::get()
 {
 	CheckBadState();
 
-	SFileSetLocale(Locale);
+	//The index mirrors the tables StormLib holds in memory, so unsaved changes are counted without flushing
+	return BuildFreeSpaceMap()->FreeSize;
 }
 
-HANDLE MpqLib::Mpq::CArchive::Handle::get()
+System::Int32 MpqLib::Mpq::CArchive::HashTableSize::get()
 {
 	CheckBadState();
 
-	return _Handle;
+	return Index->HashTableSize;
 }
 
-System::String^ MpqLib::Mpq::CArchive::FileName::get()
+System::Double MpqLib::Mpq::CArchive::HashTableLoadFactor::get()
 {
 	CheckBadState();
 
-	return _FileName;
+	CArchiveIndex^ ArchiveIndex = Index;
+	if(ArchiveIndex->HashTableSize == 0) return 0.0;
+
+	return static_cast<System::Double>(ArchiveIndex->UsedHashEntryCount) / ArchiveIndex->HashTableSize;
 }
 
-System::Object^ MpqLib::Mpq::CArchive::Tag::get()
+System::Double MpqLib::Mpq::CArchive::MaxHashTableLoadFactor::get()
 {
-	return _Tag;
+	return _MaxHashTableLoadFactor;
 }
 
-System::Void MpqLib::Mpq::CArchive::Tag::set(System::Object^ Tag)
+System::Void MpqLib::Mpq::CArchive::MaxHashTableLoadFactor::set(System::Double MaxHashTableLoadFactor)
 {
-	_Tag = Tag;
+	if((MaxHashTableLoadFactor <= 0.0) || (MaxHashTableLoadFactor > 1.0)) throw gcnew System::ArgumentOutOfRangeException("MaxHashTableLoadFactor", "The load factor must be larger than 0 and at most 1!");
+
+	_MaxHashTableLoadFactor = MaxHashTableLoadFactor;
 }
 
-System::Boolean MpqLib::Mpq::CArchive::IsDisposed::get()
+LCID MpqLib::Mpq::CArchive::Locale::get()
 {
-	return _Disposed;
+	CheckBadState();
+
+	return _Locale;
 }
 
-System::Void MpqLib::Mpq::CArchive::Open(System::Boolean CreateIfNotExists, EArchiveFormat ArchiveFormat, System::UInt32 HashTableSize)
+System::Void MpqLib::Mpq::CArchive::Locale::set(LCID Locale)
 {
-	//MHE
-	pin_ptr<HANDLE> HandlePointer = &_Handle;
-	CStringHandle FileNameHandle(_FileName);
+	CheckBadState();
 
-	if(System::IO::File::Exists(_FileName))
-	{
-		//if(!SFileCreateArchiveEx(FileNameHandle.Value, OPEN_EXISTING, 0, HandlePointer)) throw gcnew System::IO::IOException("Unable to open \"" + _FileName + "\"!");
-		if(!SFileOpenArchive(FileNameHandle.Value, 0, BASE_PROVIDER_FILE, HandlePointer)) throw gcnew System::IO::IOException("Unable to open \"" + _FileName + "\"!");
-	}
-	else
-	{
-		throw gcnew System::IO::FileNotFoundException("Could not find \"" + _FileName + "\"!", _FileName);
-		/*if(!CreateIfNotExists) throw gcnew System::IO::FileNotFoundException("Could not find \"" + _FileName + "\"!", _FileName);
-		if(HashTableSize < HASH_TABLE_SIZE_MIN) throw gcnew System::ArgumentException("Hash table size must be at least " + HASH_TABLE_SIZE_MIN + "!");
-		if(HashTableSize > HASH_TABLE_SIZE_MAX) throw gcnew System::ArgumentException("Hash table size can be at most " + HASH_TABLE_SIZE_MAX + "!");
-		if(!SFileCreateArchiveEx(FileNameHandle.Value, BuildArchiveFlags(ArchiveFormat), HashTableSize, HandlePointer)) throw gcnew System::IO::IOException("Unable to open or create \"" + _FileName + "\"!");*/
-	}
+	_Locale = Locale;
 }
 
-System::Void MpqLib::Mpq::CArchive::Cleanup(System::Boolean CleanupManagedStuff)
+MpqLib::Mpq::EImportMode MpqLib::Mpq::CArchive::ImportMode::get()
 {
-	UNREFERENCED_PARAMETER(CleanupManagedStuff);
+	return _ImportMode;
+}
 
-	if(_Handle != NULL)
-	{
-		SFileCloseArchive(_Handle);
-		_Handle = NULL;
-	}
+System::Void MpqLib::Mpq::CArchive::ImportMode::set(EImportMode ImportMode)
+{
+	_ImportMode = ImportMode;
 }
 
-System::Void MpqLib::Mpq::CArchive::CheckBadState()
+MpqLib::Mpq::CMemoryBudget^ MpqLib::Mpq::CArchive::MemoryBudget::get()
 {
-	if(_Disposed) throw gcnew System::ObjectDisposedException(nullptr, "The archive has been disposed!");
-	if((_Handle == NULL) || (_Handle == INVALID_HANDLE_VALUE)) throw gcnew System::InvalidOperationException("The archive has been closed!");
+	return _MemoryBudget;
 }
 
-System::UInt32 MpqLib::Mpq::CArchive::BuildFileFlags(ECompression Compression, EEncryption Encryption)
+System::Void MpqLib::Mpq::CArchive::MemoryBudget::set(CMemoryBudget^ MemoryBudget)
 {
-	System::UInt32 Flags = MPQ_FILE_REPLACEEXISTING;
+	if(MemoryBudget == nullptr) throw gcnew System::ArgumentNullException("MemoryBudget");
 
-	switch(Compression)
-	{
-	case ECompression::Implode:
-		{
-			Flags |= MPQ_FILE_IMPLODE;
-			break;
-		}
+	_MemoryBudget = MemoryBudget;
+}
 
-	case ECompression::Huffman:
-		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_HUFFMANN;
-			break;
-		}
+System::Boolean MpqLib::Mpq::CArchive::ShareIndex::get()
+{
+	return _ShareIndex;
+}
+
+System::Void MpqLib::Mpq::CArchive::ShareIndex::set(System::Boolean ShareIndex)
+{
+	CheckBadState();
+
+	msclr::lock Lock(_IndexLock);
+
+	_ShareIndex = ShareIndex;
+
+	DiscardIndex();
+}
+
+MpqLib::Mpq::ITraceSink^ MpqLib::Mpq::CArchive::TraceSink::get()
+{
+	return _TraceSink;
+}
+
+System::Void MpqLib::Mpq::CArchive::TraceSink::set(ITraceSink^ TraceSink)
+{
+	_TraceSink = TraceSink;
+}
 
-	case ECompression::ZLib:
+MpqLib::Mpq::CDirectoryNode^ MpqLib::Mpq::CArchive::Root::get()
+{
+	CheckBadState();
+
+	msclr::lock Lock(_IndexLock);
+
+	if(_Root == nullptr)
+	{
+		_Root = gcnew CDirectoryNode(nullptr, System::String::Empty, System::String::Empty);
+		for each(CFileInfo^ FileInfo in FindFiles("*")) _Root->AddFile(FileInfo);
+	}
+	else
+	{
+		//Only the names changed since the last access are looked up again, all their locales at once
+		for each(System::String^ FileName in _RootChanges)
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_ZLIB;
-			break;
+			_Root->RemoveFile(FileName);
+			for each(CFileInfo^ FileInfo in FindName(FileName)) _Root->AddFile(FileInfo);
 		}
+	}
+
+	_RootChanges->Clear();
+
+	return _Root;
+}
+
+MpqLib::Mpq::CBufferPool^ MpqLib::Mpq::CArchive::BufferPool::get()
+{
+	return _BufferPool;
+}
 
-	case ECompression::PKWareDCL:
+HANDLE MpqLib::Mpq::CArchive::Handle::get()
+{
+	CheckBadState();
+
+	return _Handle;
+}
+
+System::String^ MpqLib::Mpq::CArchive::FileName::get()
+{
+	CheckBadState();
+
+	return _FileName;
+}
+
+System::Object^ MpqLib::Mpq::CArchive::Tag::get()
+{
+	return _Tag;
+}
+
+System::Void MpqLib::Mpq::CArchive::Tag::set(System::Object^ Tag)
+{
+	_Tag = Tag;
+}
+
+System::Boolean MpqLib::Mpq::CArchive::IsDisposed::get()
+{
+	return _Disposed;
+}
+
+HANDLE MpqLib::Mpq::CArchive::OpenFile(System::String^ FileName, LCID Locale)
+{
+	System::Int32 BlockIndex = CConstants::InvalidIndex;
+
+	return OpenFile(FileName, Locale, BlockIndex);
+}
+
+HANDLE MpqLib::Mpq::CArchive::OpenFile(System::String^ FileName, LCID Locale, System::Int32% BlockIndex)
+{
+	HANDLE FileHandle = TryOpenFile(FileName, Locale, BlockIndex);
+	if(FileHandle == NULL) throw gcnew System::IO::FileNotFoundException("Could not find \"" + FileName + "\"!", FileName);
+
+	return FileHandle;
+}
+
+HANDLE MpqLib::Mpq::CArchive::TryOpenFile(System::String^ FileName, LCID Locale, System::Int32% BlockIndex)
+{
+	CheckBadState();
+
+	HANDLE FileHandle = NULL;
+	System::String^ StoredFileName = ResolveFileName(FileName, Locale);
+
+	CStringHandle FileNameHandle(StoredFileName);
+	CArchiveIndex^ ArchiveIndex = Index;
+
+	BlockIndex = CConstants::InvalidIndex;
+
+	if(ArchiveIndex->IsAvailable)
+	{
+		//One probe resolves the name in the locale of this archive, a miss is reported from it without asking StormLib
+		System::Int32 HashIndex = ArchiveIndex->FindHashEntry(FileNameHandle.Value, Locale);
+		if(HashIndex == CConstants::InvalidIndex) return NULL;
+
+		SHashEntry HashEntry = ArchiveIndex->GetHashEntry(HashIndex);
+		System::Int32 FileBlockIndex = static_cast<System::Int32>(HashEntry.BlockIndex);
+		if(FileBlockIndex >= ArchiveIndex->BlockTableSize) throw gcnew System::IO::IOException("Unable to open \"" + FileName + "\"!");
+
+		//The block found is opened by its index, StormLib does not look the name up again. The key of an encrypted block is
+		//derived from its name though, a neutral one is opened by name (which finds the same entry, the StormLib locale is
+		//never changed) and StormLib detects the key of a language specific one from its data
+		System::Boolean OpenByName = ((HashEntry.Locale == LANG_NEUTRAL) && (ArchiveIndex->GetBlockEntry(FileBlockIndex).Flags & MPQ_FILE_ENCRYPTED));
+
+		if(OpenByName)
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_PKWARE;
-			break;
+			if(!SFileOpenFileEx(_Handle, FileNameHandle.Value, SFILE_OPEN_FROM_MPQ, &FileHandle)) throw gcnew System::IO::IOException("Unable to open \"" + FileName + "\"!");
 		}
-
-	case ECompression::BZip2:
+		else
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_BZIP2;
-			break;
+			if(!SFileOpenFileEx(_Handle, reinterpret_cast<LPCSTR>(static_cast<DWORD_PTR>(FileBlockIndex)), SFILE_OPEN_BY_INDEX, &FileHandle)) throw gcnew System::IO::IOException("Unable to open \"" + FileName + "\"!");
 		}
-	//MHE
-	case ECompression::Sparse:
+
+		BlockIndex = FileBlockIndex;
+		return FileHandle;
+	}
+
+	//Without the tables StormLib resolves the name on its own, which only finds the neutral version
+	if(!SFileOpenFileEx(_Handle, FileNameHandle.Value, SFILE_OPEN_FROM_MPQ, &FileHandle))
+	{
+		if(GetLastError() == ERROR_FILE_NOT_FOUND) return NULL;
+		throw gcnew System::IO::IOException("Unable to open \"" + FileName + "\"!");
+	}
+
+	DWORD FileBlockIndex = 0;
+	DWORD LengthNeeded = 0;
+	if(SFileGetFileInfo(FileHandle, SFILE_INFO_BLOCKINDEX, &FileBlockIndex, sizeof(DWORD), &LengthNeeded)) BlockIndex = static_cast<System::Int32>(FileBlockIndex);
+
+	return FileHandle;
+}
+
+array<System::Byte>^ MpqLib::Mpq::CArchive::ReadFile(System::String^ FileName, LCID Locale)
+{
+	System::Int64 TraceSize = 0;
+	System::Nullable<ECompression> TraceCompression;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "ReadFile", _FileName, FileName);
+	System::Object^ Reader = gcnew System::Object();
+
+	try
+	{
+		AttachReader(Reader);
+
+		System::Int32 BlockIndex = CConstants::InvalidIndex;
+		HANDLE FileHandle = OpenFile(FileName, Locale, BlockIndex);
+
+		try
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_SPARSE;
-			break;
+			if(_TraceSink != nullptr) TraceCompression = ProbeCompression(FileName, BlockIndex);
+
+			DWORD FileSize = SFileGetFileSize(FileHandle, NULL);
+			if(FileSize > static_cast<DWORD>(System::Int32::MaxValue)) throw gcnew System::IO::IOException("\"" + FileName + "\" is too large to be read at once, open a stream instead!");
+
+			TraceSize = FileSize;
+			array<System::Byte>^ FileData = gcnew array<System::Byte>(FileSize);
+			if(FileSize == 0) return FileData;
+
+			DWORD BytesRead = 0;
+			pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+
+			if(!SFileReadFile(FileHandle, FileDataPointer, FileSize, &BytesRead, NULL) || (BytesRead != FileSize)) throw gcnew System::IO::IOException("Unable to read \"" + FileName + "\"!");
+
+			return FileData;
 		}
-	case ECompression::LZMA:
+		finally
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_LZMA;
-			break;
+			SFileCloseFile(FileHandle);
 		}
-	case ECompression::ADPCM_MONO:
+	}
+	finally
+	{
+		DetachReader(Reader);
+		CTracer::End(_TraceSink, "ReadFile", _FileName, FileName, TraceStart, TraceSize, TraceCompression);
+	}
+}
+
+System::Nullable<MpqLib::Mpq::ECompression> MpqLib::Mpq::CArchive::ProbeCompression(System::String^ FileName, System::Int32 BlockIndex)
+{
+	CArchiveIndex^ ArchiveIndex = Index;
+	if(!ArchiveIndex->IsAvailable || (BlockIndex < 0) || (BlockIndex >= ArchiveIndex->BlockTableSize)) return System::Nullable<ECompression>();
+
+	//Only the compression mask of the first compressed sector is read, the traces of reads name the codec that way
+	CStringHandle FileNameHandle(FileName);
+	CArchiveHeader^ ArchiveHeader = Header;
+	CBlockProbe Probe(_FileName, ArchiveHeader->SectorSize);
+
+	return System::Nullable<ECompression>(Probe.ProbeCompression(FileNameHandle.Value, ArchiveIndex->GetBlockEntry(BlockIndex), ArchiveHeader->ArchiveOffset + ArchiveIndex->GetBlockPosition(BlockIndex)));
+}
+
+MpqLib::Mpq::CFileInfo^ MpqLib::Mpq::CArchive::CreateFileInfo(System::String^ FileName, System::Int32 BlockIndex, LCID Locale, CArchiveIndex^ ArchiveIndex, CArchiveHeader^ Header)
+{
+	if(!ArchiveIndex->IsAvailable || (BlockIndex < 0) || (BlockIndex >= ArchiveIndex->BlockTableSize)) return nullptr;
+
+	CStringHandle FileNameHandle(FileName);
+	SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(BlockIndex);
+	System::Int64 Position = Header->ArchiveOffset + ArchiveIndex->GetBlockPosition(BlockIndex);
+
+	//Pseudo names of unnamed blocks can not be used to derive the key of encrypted files
+	System::Int32 HashIndex = ArchiveIndex->FindHashEntry(FileNameHandle.Value, Locale);
+	System::Boolean IsNamed = ((HashIndex != CConstants::InvalidIndex) && (static_cast<System::Int32>(ArchiveIndex->GetHashEntry(HashIndex).BlockIndex) == BlockIndex));
+
+	return gcnew CFileInfo(FileName, BlockEntry.FileSize, BlockEntry.CompressedSize, BlockIndex, Locale, BlockEntry.Flags, Position, _FileName, Header->SectorSize, BlockEntry.FilePosition, IsNamed);
+}
+
+MpqLib::Mpq::CArchiveIndex^ MpqLib::Mpq::CArchive::Index::get()
+{
+	msclr::lock Lock(_IndexLock);
+
+	if(_Index == nullptr) _Index = gcnew CArchiveIndex(_Handle, _FileName, !_HasPendingChanges, _ShareIndex);
+
+	return _Index;
+}
+
+MpqLib::Mpq::CArchiveHeader^ MpqLib::Mpq::CArchive::Header::get()
+{
+	msclr::lock Lock(_IndexLock);
+
+	//Read once per flush, the streams take the offset and sector size from it instead of reading the header each
+	if(_Header == nullptr) _Header = gcnew CArchiveHeader(_FileName);
+
+	return _Header;
+}
+
+System::Int32 MpqLib::Mpq::CArchive::Generation::get()
+{
+	return _Generation;
+}
+
+MpqLib::Mpq::CNameTrie^ MpqLib::Mpq::CArchive::NameTrie::get()
+{
+	msclr::lock Lock(_IndexLock);
+
+	if(_NameTrie != nullptr) return _NameTrie;
+
+	//One pass over all names, the same StormLib makes for every search with a mask
+	CNameTrie^ Trie = gcnew CNameTrie();
+	SFILE_FIND_DATA SearchData;
+	HANDLE SearchHandle = SFileFindFirstFile(_Handle, "*", &SearchData, NULL);
+
+	while(SearchHandle != NULL)
+	{
+		SNameEntry Entry;
+		Entry.FileName = gcnew System::String(SearchData.cFileName);
+		Entry.BlockIndex = static_cast<System::Int32>(SearchData.dwBlockIndex);
+		Entry.Locale = SearchData.lcLocale;
+		Entry.FileSize = SearchData.dwFileSize;
+		Entry.CompressedSize = SearchData.dwCompSize;
+		Entry.Flags = SearchData.dwFileFlags;
+
+		Trie->Add(Entry);
+		if(!SFileFindNextFile(SearchHandle, &SearchData)) break;
+	}
+
+	if(SearchHandle != NULL) SFileFindClose(SearchHandle);
+
+	_NameTrie = Trie;
+
+	return _NameTrie;
+}
+
+System::Collections::Generic::Dictionary<System::String^, System::String^>^ MpqLib::Mpq::CArchive::ContentIndex::get()
+{
+	if(_ContentIndex != nullptr) return _ContentIndex;
+
+	_ContentIndex = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>();
+	if(!FileExists(CConstants::AttributesFileName, LANG_NEUTRAL)) return _ContentIndex;
+
+	//The checksums in "(attributes)" are from the last flush, they are laid out for the block table on disk and
+	//do not cover the files changed since (those are added to the index when they are imported)
+	CArchiveIndex^ ArchiveIndex = Index;
+	CAttributes Attributes(ReadFile(CConstants::AttributesFileName, LANG_NEUTRAL), Header->BlockTableSize);
+	System::Collections::Generic::HashSet<System::String^>^ UnflushedChanges = nullptr;
+
+	{
+		msclr::lock Lock(_IndexLock);
+
+		UnflushedChanges = gcnew System::Collections::Generic::HashSet<System::String^>(_UnflushedChanges, System::StringComparer::OrdinalIgnoreCase);
+	}
+
+	for each(CFileInfo^ FileInfo in FindFiles("*"))
+	{
+		//Special files are rewritten on every flush, and the compression method of compressed blocks is not known up front
+		if(FileInfo->FileName->StartsWith("(") || UnflushedChanges->Contains(FileInfo->FileName)) continue;
+
+		CStringHandle FileNameHandle(FileInfo->FileName);
+		System::Int32 HashIndex = ArchiveIndex->FindHashEntry(FileNameHandle.Value, LANG_NEUTRAL);
+		if(HashIndex == CConstants::InvalidIndex) continue;
+
+		SHashEntry HashEntry = ArchiveIndex->GetHashEntry(HashIndex);
+		System::Int32 BlockIndex = static_cast<System::Int32>(HashEntry.BlockIndex);
+		if((HashEntry.Locale != LANG_NEUTRAL) || !Attributes.HasMd5(BlockIndex)) continue;
+
+		SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(BlockIndex);
+		if((BlockEntry.Flags & (MPQ_FILE_ENCRYPTED | MPQ_FILE_COMPRESS | MPQ_FILE_PATCH_FILE)) != 0) continue;
+
+		System::String^ ContentKey = Attributes.GetMd5(BlockIndex) + "/" + (BlockEntry.Flags & MPQ_FILE_IMPLODE).ToString("X") + "/0";
+		if(!_ContentIndex->ContainsKey(ContentKey)) _ContentIndex->Add(ContentKey, FileInfo->FileName);
+	}
+
+	return _ContentIndex;
+}
+
+System::Void MpqLib::Mpq::CArchive::Open(System::Boolean CreateIfNotExists, EArchiveFormat ArchiveFormat, System::UInt32 HashTableSize)
+{
+	//MHE
+	pin_ptr<HANDLE> HandlePointer = &_Handle;
+	CStringHandle FileNameHandle(_FileName);
+
+	//A missing archive is reported by the open itself, there is no separate existence check
+	if(SFileOpenArchive(FileNameHandle.Value, 0, BASE_PROVIDER_FILE, HandlePointer))
+	{
+		_Format = Header->Format;
+		return;
+	}
+
+	DWORD Error = GetLastError();
+	if((Error != ERROR_FILE_NOT_FOUND) && (Error != ERROR_PATH_NOT_FOUND)) throw gcnew System::IO::IOException("Unable to open \"" + _FileName + "\"!");
+
+	if(!CreateIfNotExists) throw gcnew System::IO::FileNotFoundException("Could not find \"" + _FileName + "\"!", _FileName);
+	if(HashTableSize < HASH_TABLE_SIZE_MIN) throw gcnew System::ArgumentException("Hash table size must be at least " + HASH_TABLE_SIZE_MIN + "!");
+	if(HashTableSize > HASH_TABLE_SIZE_MAX) throw gcnew System::ArgumentException("Hash table size can be at most " + HASH_TABLE_SIZE_MAX + "!");
+	if(!SFileCreateArchive(FileNameHandle.Value, BuildArchiveFlags(ArchiveFormat), HashTableSize, HandlePointer)) throw gcnew System::IO::IOException("Unable to open or create \"" + _FileName + "\"!");
+
+	_Format = ArchiveFormat;
+}
+
+System::Void MpqLib::Mpq::CArchive::Cleanup(System::Boolean CleanupManagedStuff)
+{
+	if(CleanupManagedStuff && (_Handle != NULL) && HasPendingNames())
+	{
+		//Closing flushes and rewrites the listfile, do it up front so the names of deduplicated imports are written after it
+		if(SFileFlushArchive(_Handle)) WritePendingLinks(false);
+	}
+
+	if(CleanupManagedStuff)
+	{
+		DiscardIndex();
+		DiscardRoot();
+		_ContentIndex = nullptr;
+
+		//Streams still open return their buffers to the pool, those are released by its finalizer
+		_BufferPool->Trim();
+	}
+
+	if(_Handle != NULL)
+	{
+		SFileCloseArchive(_Handle);
+		_Handle = NULL;
+	}
+}
+
+System::Void MpqLib::Mpq::CArchive::CheckBadState()
+{
+	if(_Disposed) throw gcnew System::ObjectDisposedException(nullptr, "The archive has been disposed!");
+	if((_Handle == NULL) || (_Handle == INVALID_HANDLE_VALUE)) throw gcnew System::InvalidOperationException("The archive has been closed!");
+}
+
+System::Void MpqLib::Mpq::CArchive::InvalidateIndex()
+{
+	msclr::lock Lock(_IndexLock);
+
+	_HasPendingChanges = true;
+
+	//The tables are read again when needed, the names are patched by the callers (see UpdateName)
+	_Index = nullptr;
+}
+
+System::Void MpqLib::Mpq::CArchive::DiscardIndex()
+{
+	msclr::lock Lock(_IndexLock);
+
+	//Other threads may still be reading the index or walking the trie, both are left to the garbage collector
+	_Index = nullptr;
+	_Header = nullptr;
+	_NameTrie = nullptr;
+}
+
+System::Void MpqLib::Mpq::CArchive::DiscardNames()
+{
+	msclr::lock Lock(_IndexLock);
+
+	_NameTrie = nullptr;
+}
+
+System::Void MpqLib::Mpq::CArchive::UpdateName(System::String^ FileName)
+{
+	CNameTrie^ Trie = nullptr;
+
+	{
+		msclr::lock Lock(_IndexLock);
+
+		Trie = _NameTrie;
+	}
+
+	if(Trie == nullptr) return;
+
+	//The entry is read back from StormLib the way the trie was filled, a name it does not resolve drops the trie instead
+	HANDLE FileHandle = NULL;
+	System::Int32 BlockIndex = CConstants::InvalidIndex;
+
+	try
+	{
+		FileHandle = OpenFile(FileName, LANG_NEUTRAL, BlockIndex);
+	}
+	catch(System::IO::IOException^)
+	{
+		DiscardNames();
+		return;
+	}
+
+	DWORD Locale = LANG_NEUTRAL;
+	DWORD FileSize = 0;
+	DWORD CompressedSize = 0;
+	DWORD Flags = 0;
+	DWORD LengthNeeded = 0;
+
+	SFileGetFileInfo(FileHandle, SFILE_INFO_LOCALEID, &Locale, sizeof(DWORD), &LengthNeeded);
+	SFileGetFileInfo(FileHandle, SFILE_INFO_FILE_SIZE, &FileSize, sizeof(DWORD), &LengthNeeded);
+	SFileGetFileInfo(FileHandle, SFILE_INFO_COMPRESSED_SIZE, &CompressedSize, sizeof(DWORD), &LengthNeeded);
+	SFileGetFileInfo(FileHandle, SFILE_INFO_FLAGS, &Flags, sizeof(DWORD), &LengthNeeded);
+	SFileCloseFile(FileHandle);
+
+	SNameEntry Entry;
+	Entry.FileName = FileName;
+	Entry.BlockIndex = BlockIndex;
+	Entry.Locale = Locale;
+	Entry.FileSize = FileSize;
+	Entry.CompressedSize = CompressedSize;
+	Entry.Flags = Flags;
+
+	Trie->Add(Entry);
+}
+
+System::Void MpqLib::Mpq::CArchive::RemoveName(System::String^ FileName)
+{
+	CNameTrie^ Trie = nullptr;
+
+	{
+		msclr::lock Lock(_IndexLock);
+
+		Trie = _NameTrie;
+	}
+
+	if(Trie != nullptr) Trie->Remove(FileName, LANG_NEUTRAL);
+}
+
+System::Void MpqLib::Mpq::CArchive::DiscardRoot()
+{
+	msclr::lock Lock(_IndexLock);
+
+	//Nodes handed out keep describing the tree they were taken from
+	_Root = nullptr;
+	_RootChanges->Clear();
+}
+
+System::Void MpqLib::Mpq::CArchive::NoteChange(System::String^ FileName)
+{
+	msclr::lock Lock(_IndexLock);
+
+	_RootChanges->Add(FileName);
+	_UnflushedChanges->Add(FileName);
+}
+
+System::Boolean MpqLib::Mpq::CArchive::GrowHashTable(System::Boolean TableIsFull)
+{
+	CArchiveIndex^ ArchiveIndex = Index;
+	if(!ArchiveIndex->IsAvailable) return false;
+
+	//The pending names take up an entry each once they are written
+	System::UInt32 HashTableSize = static_cast<System::UInt32>(ArchiveIndex->HashTableSize);
+	System::Int32 PendingLinkCount = _PendingLinks->Count;
+	if(!TableIsFull && ((ArchiveIndex->UsedHashEntryCount + PendingLinkCount) <= HashTableSize * _MaxHashTableLoadFactor)) return false;
+
+	//The rebuilt table drops deleted entries, size it so the files take up about half of the allowed load
+	System::UInt32 NewHashTableSize = TableIsFull ? (HashTableSize * 2) : HashTableSize;
+	while((NewHashTableSize < HASH_TABLE_SIZE_MAX) && ((ArchiveIndex->FileHashEntryCount + PendingLinkCount + 1) > (NewHashTableSize * _MaxHashTableLoadFactor / 2))) NewHashTableSize *= 2;
+	if(NewHashTableSize > HASH_TABLE_SIZE_MAX) return false;
+
+	//The table is rebuilt from the files StormLib knows of, the pending names are added to it by the next flush
+	InvalidateIndex();
+	DiscardNames();
+
+	return (SFileSetMaxFileCount(_Handle, NewHashTableSize) != 0);
+}
+
+System::String^ MpqLib::Mpq::CArchive::BuildContentKey(System::String^ RealFileName, System::UInt32 Flags, System::UInt32 CompressionFlags)
+{
+	if((_ImportMode != EImportMode::Deduplicate) || ((Flags & MPQ_FILE_ENCRYPTED) != 0)) return nullptr;
+	if(Format > EArchiveFormat::Version2) return nullptr;
+
+	array<System::Byte>^ Md5 = nullptr;
+	System::IO::FileStream^ RealFile = System::IO::File::OpenRead(RealFileName);
+
+	try
+	{
+		Md5 = System::Security::Cryptography::MD5::Create()->ComputeHash(RealFile);
+	}
+	finally
+	{
+		RealFile->Close();
+	}
+
+	//The MD5 hash is formatted the same way as the ones read from "(attributes)"
+	return System::BitConverter::ToString(Md5) + "/" + (Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)).ToString("X") + "/" + CompressionFlags.ToString("X");
+}
+
+System::Boolean MpqLib::Mpq::CArchive::ImportDuplicate(System::String^ FileName, System::String^ ContentKey)
+{
+	System::String^ ExistingFileName = nullptr;
+	if(!ContentIndex->TryGetValue(ContentKey, ExistingFileName)) return false;
+
+	LCID Locale = LANG_NEUTRAL;
+	System::String^ StoredFileName = ResolveFileName(ExistingFileName, Locale);
+
+	if(!FileExists(StoredFileName, LANG_NEUTRAL))
+	{
+		ContentIndex->Remove(ContentKey);
+		return false;
+	}
+
+	//The name reads the block already, either directly or through its link
+	if((System::String::Compare(ExistingFileName, FileName, true) == 0) || (System::String::Compare(StoredFileName, FileName, true) == 0)) return true;
+
+	//Sharing the block only saves space, should the old version stay the file is imported on its own
+	try
+	{
+		if(FileExists(FileName, LANG_NEUTRAL)) RemoveFile(FileName);
+	}
+	catch(System::IO::IOException^)
+	{
+		return false;
+	}
+
+	//The entry for the existing block is written by the next flush, until then the name is read through the stored one
+	LinkFile(FileName, StoredFileName);
+
+	return true;
+}
+
+System::Void MpqLib::Mpq::CArchive::ForgetContent(System::String^ FileName)
+{
+	if(_ContentIndex == nullptr) return;
+
+	System::Collections::Generic::List<System::String^>^ ContentKeys = gcnew System::Collections::Generic::List<System::String^>();
+
+	for each(System::Collections::Generic::KeyValuePair<System::String^, System::String^> Content in _ContentIndex)
+	{
+		if(System::String::Compare(Content.Value, FileName, true) == 0) ContentKeys->Add(Content.Key);
+	}
+
+	for each(System::String^ ContentKey in ContentKeys) _ContentIndex->Remove(ContentKey);
+}
+
+System::Void MpqLib::Mpq::CArchive::WritePendingLinks(System::Boolean KeepOpen)
+{
+	//Expects a flushed archive, the listfile and attributes are read before the archive is closed for editing
+	array<System::Byte>^ ListFileData = FileExists(CConstants::ListFileName, LANG_NEUTRAL) ? ReadFile(CConstants::ListFileName, LANG_NEUTRAL) : nullptr;
+	array<System::Byte>^ AttributesData = FileExists(CConstants::AttributesFileName, LANG_NEUTRAL) ? ReadFile(CConstants::AttributesFileName, LANG_NEUTRAL) : nullptr;
+
+	System::Collections::Generic::Dictionary<System::String^, System::String^>^ PendingLinks = nullptr;
+
+	if(KeepOpen)
+	{
+		BeginEdit();
+	}
+	else
+	{
+		DiscardIndex();
+		SFileCloseArchive(_Handle);
+		_Handle = NULL;
+	}
+
+	try
+	{
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_ADPCM_MONO;
-			break;
+			msclr::lock Lock(_IndexLock);
+
+			PendingLinks = gcnew System::Collections::Generic::Dictionary<System::String^, System::String^>(_PendingLinks, System::StringComparer::OrdinalIgnoreCase);
 		}
-	case ECompression::ADPCM_STEREO:
+
+		CArchiveEditor Editor(_FileName);
+
+		for each(System::Collections::Generic::KeyValuePair<System::String^, System::String^> Link in PendingLinks)
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_ADPCM_STEREO;
-			break;
+			CStringHandle FileNameHandle(Link.Key);
+			CStringHandle StoredFileNameHandle(Link.Value);
+
+			System::Int32 BlockIndex = Editor.FindBlock(StoredFileNameHandle.Value, LANG_NEUTRAL);
+			if(BlockIndex == CConstants::InvalidIndex) throw gcnew System::IO::FileNotFoundException("Could not find \"" + Link.Value + "\"!", Link.Value);
+
+			if(!Editor.AddHashEntry(FileNameHandle.Value, LANG_NEUTRAL, BlockIndex)) throw gcnew System::IO::IOException("Unable to add \"" + Link.Key + "\", the hash table is full!");
 		}
-	/*case ECompression::WaveMono:
+
+		WriteSpecialFiles(Editor, ListFileData, AttributesData, PendingLinks->Keys, CConstants::InvalidIndex, nullptr);
+
+		Editor.Save();
+	}
+	catch(System::Exception^)
+	{
+		if(KeepOpen) AbortEdit();
+		throw;
+	}
+
+	//From here on the names are entries like any other, StormLib keeps them in the hash table
+	{
+		msclr::lock Lock(_IndexLock);
+
+		_PendingLinks->Clear();
+	}
+
+	if(KeepOpen) Reopen();
+}
+
+System::Void MpqLib::Mpq::CArchive::WriteSpecialFiles(CArchiveEditor% Editor, array<System::Byte>^ ListFileData, array<System::Byte>^ AttributesData, System::Collections::Generic::IEnumerable<System::String^>^ FileNames, System::Int32 BlockIndex, array<System::Byte>^ FileData)
+{
+	System::Collections::Generic::List<System::String^>^ ListFile = (ListFileData != nullptr) ? ReadListFile(ListFileData) : gcnew System::Collections::Generic::List<System::String^>();
+	System::Collections::Generic::HashSet<System::String^>^ ListedFileNames = gcnew System::Collections::Generic::HashSet<System::String^>(ListFile, System::StringComparer::OrdinalIgnoreCase);
+	System::Int32 ListFileSize = ListFile->Count;
+
+	for each(System::String^ FileName in FileNames)
+	{
+		if(ListedFileNames->Add(FileName)) ListFile->Add(FileName);
+	}
+
+	CStringHandle ListFileNameHandle(CConstants::ListFileName);
+	CStringHandle AttributesFileNameHandle(CConstants::AttributesFileName);
+	System::Int32 ListFileBlockIndex = Editor.FindBlock(ListFileNameHandle.Value, LANG_NEUTRAL);
+	System::Int32 AttributesBlockIndex = Editor.FindBlock(AttributesFileNameHandle.Value, LANG_NEUTRAL);
+	array<System::Byte>^ NewListFileData = nullptr;
+
+	if((ListFileBlockIndex != CConstants::InvalidIndex) && (ListFile->Count != ListFileSize))
+	{
+		NewListFileData = System::Text::Encoding::Default->GetBytes(System::String::Join("\r\n", ListFile) + "\r\n");
+		Editor.ReplaceBlock(static_cast<DWORD>(ListFileBlockIndex), NewListFileData);
+	}
+
+	//The listfile is stored plain, its checksums in "(attributes)" have to follow like those of a written block
+	if((AttributesData == nullptr) || (AttributesBlockIndex == CConstants::InvalidIndex)) return;
+	if((NewListFileData == nullptr) && (BlockIndex == CConstants::InvalidIndex)) return;
+
+	CAttributes Attributes(AttributesData, Editor.BlockTableSize);
+
+	if(NewListFileData != nullptr)
+	{
+		pin_ptr<System::Byte> NewListFileDataPointer = &NewListFileData[0];
+
+		if(Attributes.HasCrc32(ListFileBlockIndex)) Attributes.SetCrc32(ListFileBlockIndex, CCryptography::Crc32(NewListFileDataPointer, NewListFileData->Length));
+		if(Attributes.HasMd5(ListFileBlockIndex)) Attributes.SetMd5(ListFileBlockIndex, System::Security::Cryptography::MD5::Create()->ComputeHash(NewListFileData));
+	}
+
+	if(BlockIndex != CConstants::InvalidIndex) Attributes.SetChecksums(BlockIndex, FileData);
+
+	Editor.ReplaceBlock(static_cast<DWORD>(AttributesBlockIndex), Attributes.FileData);
+}
+
+System::Boolean MpqLib::Mpq::CArchive::IsEncodedImport(System::String^ RealFileName, System::UInt32 Flags)
+{
+	//Only compression gains from the thread pool, the table editor needs the classic tables and an archive it may close
+	if((Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) == 0) return false;
+	if((System::Environment::ProcessorCount < 2) || (Format > EArchiveFormat::Version2) || HasReaders()) return false;
+
+	System::Int64 Length = (gcnew System::IO::FileInfo(RealFileName))->Length;
+
+	return (Length >= CConstants::ParallelEncodeMinSize) && (Length <= System::Int32::MaxValue);
+}
+
+System::Void MpqLib::Mpq::CArchive::WriteEncodedFile(System::String^ FileName, System::String^ RealFileName, System::UInt32 Flags, System::UInt32 CompressionFlags, CCompressionOptions^ Options)
+{
+	array<System::Byte>^ FileData = System::IO::File::ReadAllBytes(RealFileName);
+
+	//The block goes straight to disk, what StormLib holds is written first (making room in the hash table)
+	Flush();
+
+	CArchiveIndex^ ArchiveIndex = Index;
+	if((ArchiveIndex->UsedHashEntryCount >= ArchiveIndex->HashTableSize) && GrowHashTable(true)) Flush();
+
+	//The listfile and attributes are read before the archive is closed for editing
+	array<System::Byte>^ ListFileData = FileExists(CConstants::ListFileName, LANG_NEUTRAL) ? ReadFile(CConstants::ListFileName, LANG_NEUTRAL) : nullptr;
+	array<System::Byte>^ AttributesData = FileExists(CConstants::AttributesFileName, LANG_NEUTRAL) ? ReadFile(CConstants::AttributesFileName, LANG_NEUTRAL) : nullptr;
+
+	BeginEdit();
+
+	try
+	{
+		CArchiveEditor Editor(_FileName);
+		CStringHandle FileNameHandle(FileName);
+
+		System::Int32 Level = (Options != nullptr) ? Options->Level : 0;
+		System::Int32 DictionarySize = (Options != nullptr) ? Options->DictionarySize : 0;
+		System::Int32 BlockIndex = Editor.WriteBlock(FileNameHandle.Value, LANG_NEUTRAL, FileData, Flags & ~MPQ_FILE_REPLACEEXISTING, CompressionFlags, Level, DictionarySize);
+
+		WriteSpecialFiles(Editor, ListFileData, AttributesData, gcnew array<System::String^>{ FileName }, BlockIndex, FileData);
+
+		Editor.Save();
+	}
+	catch(System::Exception^)
+	{
+		AbortEdit();
+		throw;
+	}
+
+	Reopen();
+
+	//The special files were rewritten along with the block
+	msclr::lock Lock(_IndexLock);
+
+	_RootChanges->Add(CConstants::ListFileName);
+	_RootChanges->Add(CConstants::AttributesFileName);
+}
+
+System::Void MpqLib::Mpq::CArchive::BeginEdit()
+{
+	msclr::lock Lock(_IndexLock);
+
+	//Open streams keep reading through the handle, it must not be closed under them
+	CheckReaders();
+
+	DiscardIndex();
+	SFileCloseArchive(_Handle);
+	_Handle = NULL;
+}
+
+System::Void MpqLib::Mpq::CArchive::AbortEdit()
+{
+	try
+	{
+		Reopen();
+	}
+	catch(System::Exception^)
+	{
+		//The error that aborted the edit is the one reported, the archive stays closed
+	}
+}
+
+System::Void MpqLib::Mpq::CArchive::CheckReaders()
+{
+	if(HasReaders()) throw gcnew System::InvalidOperationException("The archive can not be rewritten while files in it are open or being read, close their streams first!");
+}
+
+System::Boolean MpqLib::Mpq::CArchive::HasReaders()
+{
+	msclr::lock Lock(_IndexLock);
+
+	for(System::Int32 i = _Readers->Count - 1; i >= 0; i--)
+	{
+		if(!_Readers[i]->IsAlive) _Readers->RemoveAt(i);
+	}
+
+	return (_Readers->Count > 0);
+}
+
+System::Void MpqLib::Mpq::CArchive::AttachReader(System::Object^ Reader)
+{
+	msclr::lock Lock(_IndexLock);
+
+	//The handle is closed while the tables are rewritten, nothing may start reading meanwhile
+	if((_Handle == NULL) || (_Handle == INVALID_HANDLE_VALUE)) throw gcnew System::InvalidOperationException("The archive is closed or being rewritten!");
+
+	_Readers->Add(gcnew System::WeakReference(Reader));
+}
+
+System::Void MpqLib::Mpq::CArchive::DetachReader(System::Object^ Reader)
+{
+	msclr::lock Lock(_IndexLock);
+
+	for(System::Int32 i = _Readers->Count - 1; i >= 0; i--)
+	{
+		System::Object^ Target = _Readers[i]->Target;
+		if((Target == nullptr) || (Target == Reader)) _Readers->RemoveAt(i);
+	}
+}
+
+System::Boolean MpqLib::Mpq::CArchive::HasPendingNames()
+{
+	msclr::lock Lock(_IndexLock);
+
+	return (_PendingLinks->Count > 0);
+}
+
+System::Collections::Generic::List<System::String^>^ MpqLib::Mpq::CArchive::FindLinks(System::String^ StoredFileName)
+{
+	msclr::lock Lock(_IndexLock);
+
+	System::Collections::Generic::List<System::String^>^ FileNames = gcnew System::Collections::Generic::List<System::String^>();
+
+	for each(System::Collections::Generic::KeyValuePair<System::String^, System::String^> Link in _PendingLinks)
+	{
+		if(System::String::Compare(Link.Value, StoredFileName, true) == 0) FileNames->Add(Link.Key);
+	}
+
+	return FileNames;
+}
+
+System::Void MpqLib::Mpq::CArchive::LinkFile(System::String^ FileName, System::String^ StoredFileName)
+{
+	msclr::lock Lock(_IndexLock);
+
+	if(System::String::Compare(FileName, StoredFileName, true) == 0) _PendingLinks->Remove(FileName);
+	else _PendingLinks[FileName] = StoredFileName;
+}
+
+System::Boolean MpqLib::Mpq::CArchive::UnlinkFile(System::String^ FileName)
+{
+	msclr::lock Lock(_IndexLock);
+
+	return _PendingLinks->Remove(FileName);
+}
+
+System::Void MpqLib::Mpq::CArchive::RetargetLinks(System::String^ StoredFileName, System::String^ NewStoredFileName)
+{
+	msclr::lock Lock(_IndexLock);
+
+	for each(System::String^ FileName in FindLinks(StoredFileName)) LinkFile(FileName, NewStoredFileName);
+}
+
+System::Boolean MpqLib::Mpq::CArchive::ReleaseLinks(System::String^ FileName)
+{
+	System::Collections::Generic::List<System::String^>^ LinkedFileNames = FindLinks(FileName);
+	if(LinkedFileNames->Count == 0) return false;
+
+	//The stored name is about to go, its block is renamed to the first name reading it instead of being copied
+	//and the other names read it through that one from then on
+	System::String^ HeirFileName = LinkedFileNames[0];
+	CStringHandle FileNameHandle(FileName);
+	CStringHandle HeirFileNameHandle(HeirFileName);
+
+	InvalidateIndex();
+
+	if(!SFileRenameFile(_Handle, FileNameHandle.Value, HeirFileNameHandle.Value)) throw gcnew System::IO::IOException("Unable to hand \"" + FileName + "\" over to \"" + HeirFileName + "\", which reads the same block!");
+
+	UnlinkFile(HeirFileName);
+	RetargetLinks(FileName, HeirFileName);
+	NoteChange(HeirFileName);
+	RemoveName(FileName);
+	UpdateName(HeirFileName);
+
+	return true;
+}
+
+System::String^ MpqLib::Mpq::CArchive::ResolveFileName(System::String^ FileName, LCID% Locale)
+{
+	msclr::lock Lock(_IndexLock);
+
+	System::String^ StoredFileName = nullptr;
+	if(!_PendingLinks->TryGetValue(FileName, StoredFileName)) return FileName;
+
+	//Only the neutral entry of a name is linked, a localized one is still read through StormLib
+	if(Locale != LANG_NEUTRAL)
+	{
+		CStringHandle FileNameHandle(FileName);
+		if(Index->FindLocales(FileNameHandle.Value)->Contains(Locale)) return FileName;
+	}
+
+	Locale = LANG_NEUTRAL;
+	return StoredFileName;
+}
+
+System::Void MpqLib::Mpq::CArchive::AddPendingNames(System::Collections::Generic::List<CFileInfo^>^ FileInfoList, System::String^ Mask, CArchiveIndex^ ArchiveIndex, CArchiveHeader^ Header)
+{
+	msclr::lock Lock(_IndexLock);
+
+	if(_PendingLinks->Count == 0) return;
+
+	for(System::Int32 i = FileInfoList->Count - 1; i >= 0; i--)
+	{
+		CFileInfo^ FileInfo = FileInfoList[i];
+		if(FileInfo->Locale != LANG_NEUTRAL) continue;
+
+		if(_PendingLinks->ContainsKey(FileInfo->FileName)) FileInfoList->RemoveAt(i);
+	}
+
+	CGlobMatcher^ Matcher = gcnew CGlobMatcher(Mask);
+
+	for each(System::Collections::Generic::KeyValuePair<System::String^, System::String^> Link in _PendingLinks)
+	{
+		if(!Matcher->IsMatch(Link.Key)) continue;
+
+		CStringHandle StoredFileNameHandle(Link.Value);
+		System::Int32 HashIndex = ArchiveIndex->FindHashEntry(StoredFileNameHandle.Value, LANG_NEUTRAL);
+		if(HashIndex == CConstants::InvalidIndex) continue;
+
+		FileInfoList->Add(CreateFileInfo(Link.Key, static_cast<System::Int32>(ArchiveIndex->GetHashEntry(HashIndex).BlockIndex), LANG_NEUTRAL, ArchiveIndex, Header));
+	}
+}
+
+System::Collections::Generic::List<MpqLib::Mpq::CFileInfo^>^ MpqLib::Mpq::CArchive::FindName(System::String^ FileName)
+{
+	System::Collections::Generic::List<CFileInfo^>^ FileInfoList = gcnew System::Collections::Generic::List<CFileInfo^>();
+	CArchiveIndex^ ArchiveIndex = Index;
+	CArchiveHeader^ ArchiveHeader = Header;
+
+	msclr::lock Lock(_IndexLock);
+
+	//The name is taken literally, a pending link replaces its neutral locale like in FindFiles
+	System::Boolean IsPending = _PendingLinks->ContainsKey(FileName);
+
+	for each(SNameEntry Entry in NameTrie->FindName(FileName))
+	{
+		if(IsPending && (Entry.Locale == LANG_NEUTRAL)) continue;
+
+		CFileInfo^ FileInfo = CreateFileInfo(Entry.FileName, Entry.BlockIndex, Entry.Locale, ArchiveIndex, ArchiveHeader);
+		FileInfoList->Add((FileInfo != nullptr) ? FileInfo : gcnew CFileInfo(Entry.FileName, Entry.FileSize, Entry.CompressedSize, Entry.BlockIndex, Entry.Locale, Entry.Flags, CConstants::InvalidIndex, ECompression::None));
+	}
+
+	System::String^ StoredFileName = nullptr;
+	if(!_PendingLinks->TryGetValue(FileName, StoredFileName)) return FileInfoList;
+
+	CStringHandle StoredFileNameHandle(StoredFileName);
+	System::Int32 HashIndex = ArchiveIndex->FindHashEntry(StoredFileNameHandle.Value, LANG_NEUTRAL);
+	if(HashIndex != CConstants::InvalidIndex) FileInfoList->Add(CreateFileInfo(FileName, static_cast<System::Int32>(ArchiveIndex->GetHashEntry(HashIndex).BlockIndex), LANG_NEUTRAL, ArchiveIndex, ArchiveHeader));
+
+	return FileInfoList;
+}
+
+MpqLib::Mpq::CFreeSpaceMap^ MpqLib::Mpq::CArchive::BuildFreeSpaceMap()
+{
+	CArchiveIndex^ ArchiveIndex = Index;
+	System::Collections::Generic::List<System::Int64>^ Positions = gcnew System::Collections::Generic::List<System::Int64>();
+	System::Collections::Generic::List<System::Int64>^ Sizes = gcnew System::Collections::Generic::List<System::Int64>();
+
+	for(System::Int32 i = 0; i < ArchiveIndex->BlockTableSize; i++)
+	{
+		SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(i);
+		if((BlockEntry.Flags & MPQ_FILE_EXISTS) == 0) continue;
+
+		Positions->Add(ArchiveIndex->GetBlockPosition(i));
+		Sizes->Add(BlockEntry.CompressedSize);
+	}
+
+	//The data starts right after the header, whose size follows from the format
+	System::Int64 DataStart = MPQ_HEADER_SIZE_V1;
+	if(_Format == EArchiveFormat::Version2) DataStart = MPQ_HEADER_SIZE_V2;
+	if(_Format == EArchiveFormat::Version3) DataStart = MPQ_HEADER_SIZE_V3;
+	if(_Format == EArchiveFormat::Version4) DataStart = MPQ_HEADER_SIZE_V4;
+
+	return gcnew CFreeSpaceMap(DataStart, ArchiveIndex->DataEnd, Positions->ToArray(), Sizes->ToArray());
+}
+
+System::Void MpqLib::Mpq::CArchive::Reopen()
+{
+	pin_ptr<HANDLE> HandlePointer = &_Handle;
+	CStringHandle FileNameHandle(_FileName);
+
+	if(!SFileOpenArchive(FileNameHandle.Value, 0, BASE_PROVIDER_FILE, HandlePointer)) throw gcnew System::IO::IOException("Unable to open \"" + _FileName + "\"!");
+
+	//A rebuild may have written the archive in another format or moved its blocks, what was looked up before is stale
+	_Format = Header->Format;
+	System::Threading::Interlocked::Increment(_Generation);
+}
+
+System::Collections::Generic::List<System::String^>^ MpqLib::Mpq::CArchive::ReadListFile(array<System::Byte>^ FileData)
+{
+	System::Collections::Generic::List<System::String^>^ FileNames = gcnew System::Collections::Generic::List<System::String^>();
+
+	for each(System::String^ FileName in System::Text::Encoding::Default->GetString(FileData)->Split(gcnew array<wchar_t>{ '\r', '\n', ';' }, System::StringSplitOptions::RemoveEmptyEntries))
+	{
+		System::String^ TrimmedFileName = FileName->Trim();
+		if(TrimmedFileName->Length > 0) FileNames->Add(TrimmedFileName);
+	}
+
+	return FileNames;
+}
+
+System::UInt32 MpqLib::Mpq::CArchive::BuildFileFlags(ECompression Compression, EEncryption Encryption)
+{
+	System::UInt32 Flags = MPQ_FILE_REPLACEEXISTING;
+
+	switch(Compression)
+	{
+	case ECompression::Implode:
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_WAVE_MONO;
+			Flags |= MPQ_FILE_IMPLODE;
 			break;
 		}
 
-	case ECompression::WaveStereo:
+	default:
 		{
-			Flags |= MPQ_FILE_COMPRESS | MPQ_COMPRESSION_WAVE_STEREO;
+			if(BuildCompressionFlags(Compression) != 0) Flags |= MPQ_FILE_COMPRESS;
 			break;
-		}*/
+		}
 	}
 
 	switch(Encryption)
@@ -521,6 +2021,24 @@ System::UInt32 MpqLib::Mpq::CArchive::BuildFileFlags(ECompression Compression, E
 	return Flags;
 }
 
+System::UInt32 MpqLib::Mpq::CArchive::BuildCompressionFlags(ECompression Compression)
+{
+	switch(Compression)
+	{
+	case ECompression::Huffman: return MPQ_COMPRESSION_HUFFMANN;
+	case ECompression::ZLib: return MPQ_COMPRESSION_ZLIB;
+	case ECompression::PKWareDCL: return MPQ_COMPRESSION_PKWARE;
+	case ECompression::BZip2: return MPQ_COMPRESSION_BZIP2;
+	//MHE
+	case ECompression::Sparse: return MPQ_COMPRESSION_SPARSE;
+	case ECompression::LZMA: return MPQ_COMPRESSION_LZMA;
+	case ECompression::ADPCM_MONO: return MPQ_COMPRESSION_ADPCM_MONO;
+	case ECompression::ADPCM_STEREO: return MPQ_COMPRESSION_ADPCM_STEREO;
+	}
+
+	return 0;
+}
+
 System::UInt32 MpqLib::Mpq::CArchive::BuildWaveFlags(EQuality Quality)
 {
 	switch(Quality)
@@ -535,8 +2053,9 @@ System::UInt32 MpqLib::Mpq::CArchive::BuildWaveFlags(EQuality Quality)
 
 System::UInt32 MpqLib::Mpq::CArchive::BuildArchiveFlags(EArchiveFormat ArchiveFormat)
 {
-	System::UInt32 Flags = CREATE_ALWAYS;
+	System::UInt32 Flags = MPQ_CREATE_ATTRIBUTES;
 
+	//Version 3 and later use the HET/BET tables (Jenkins hashed, bit-packed) to index the files
 	switch(ArchiveFormat)
 	{
 	case EArchiveFormat::Version1:
@@ -550,6 +2069,18 @@ System::UInt32 MpqLib::Mpq::CArchive::BuildArchiveFlags(EArchiveFormat ArchiveFo
 			Flags |= MPQ_CREATE_ARCHIVE_V2;
 			break;
 		}
+
+	case EArchiveFormat::Version3:
+		{
+			Flags |= MPQ_CREATE_ARCHIVE_V3;
+			break;
+		}
+
+	case EArchiveFormat::Version4:
+		{
+			Flags |= MPQ_CREATE_ARCHIVE_V4;
+			break;
+		}
 	}
 
 	return Flags;
@@ -34,8 +34,22 @@
 #include "TemporaryFile.h"
 #include "Quality.h"
 #include "Compression.h"
+#include "CompressionOptions.h"
 #include "Encryption.h"
 #include "ArchiveFormat.h"
+#include "ImportMode.h"
+#include "MemoryBudget.h"
+#include "BufferPool.h"
+#include "ArchiveIndex.h"
+#include "ArchiveHeader.h"
+#include "FreeSpaceMap.h"
+#include "ArchiveEditor.h"
+#include "BlockProbe.h"
+#include "DiffEntry.h"
+#include "VerifyReport.h"
+#include "Tracer.h"
+#include "NameTrie.h"
+#include "DirectoryNode.h"
 
 namespace MpqLib
 {
@@ -95,6 +109,8 @@ namespace MpqLib
 
 				/// <summary>
 				/// Flushes the archive, committing unsaved changes.
+				/// The names of deduplicated imports are added to the tables afterwards, while streams of files in the
+				/// archive are open they wait for the next flush or the close instead.
 				/// </summary>
 				System::Void Flush();
 
@@ -103,6 +119,35 @@ namespace MpqLib
 				/// </summary>
 				System::Void Compact();
 
+				/// <summary>
+				/// Rebuilds the archive, recompressing every file with the given compression (and codec parameters).
+				/// All files must be known by name, files sharing a block are stored separately afterwards.
+				/// Only version 1 and 2 archives can be rebuilt, not while files in it are open or being read.
+				/// </summary>
+				/// <param name="Options">The compression (and codec parameters) to use, or null to keep the compression of each file</param>
+				System::Void Compact(CCompressionOptions^ Options);
+
+				/// <summary>
+				/// Rebuilds the archive with another sector size, recompressing every file with the given compression (and codec parameters).
+				/// All files must be known by name, files sharing a block are stored separately afterwards.
+				/// Only version 1 and 2 archives can be rebuilt, not while files in it are open or being read.
+				/// </summary>
+				/// <param name="Options">The compression (and codec parameters) to use, or null to keep the compression of each file</param>
+				/// <param name="SectorSizeShift">The sector size of the archive as a shift of 512 bytes (larger sectors compress better, smaller ones suit small random reads)</param>
+				System::Void Compact(CCompressionOptions^ Options, System::UInt16 SectorSizeShift);
+
+				/// <summary>
+				/// Compacts the archive in slices, moving the blocks after the first hole towards the start of the archive.
+				/// Unlike Compact only the blocks behind a hole are touched, call it repeatedly (e.g. in the background) until it returns True.
+				/// Blocks encrypted with a fixed seed depend on their position and are never moved.
+				/// Blocks are moved in batches that do not land where the tables on disk still point, those are updated after
+				/// each batch, so an interrupted call leaves a readable archive.
+				/// Throws an InvalidOperationException while files in the archive are open or being read.
+				/// </summary>
+				/// <param name="MaxBytesMoved">The maximum number of bytes to write in this call, block copies and table updates alike (at least one block is always moved)</param>
+				/// <returns>True if no more blocks can be moved, False otherwise</returns>
+				System::Boolean CompactIncrementally(System::Int64 MaxBytesMoved);
+
 				/// <summary>
 				/// Checks if a file exists in the archive.
 				/// </summary>
@@ -110,6 +155,21 @@ namespace MpqLib
 				/// <returns>True if the file exists, False otherwise</returns>
 				System::Boolean FileExists(System::String^ FileName);
 
+				/// <summary>
+				/// Checks if a file exists in the archive, in a specific locale or as a neutral file.
+				/// </summary>
+				/// <param name="FileName">The file to check</param>
+				/// <param name="Locale">The locale to look for</param>
+				/// <returns>True if the file exists, False otherwise</returns>
+				System::Boolean FileExists(System::String^ FileName, LCID Locale);
+
+				/// <summary>
+				/// Retrieves all locales a file is stored in.
+				/// </summary>
+				/// <param name="FileName">The file to check</param>
+				/// <returns>A collection of the locales found</returns>
+				System::Collections::Generic::IEnumerable<LCID>^ GetLocales(System::String^ FileName);
+
 				/// <summary>
 				/// Imports a file to the archive.
 				/// </summary>
@@ -126,7 +186,8 @@ namespace MpqLib
 				System::Void ImportFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression);
 
 				/// <summary>
-				/// Imports a file to the archive.
+				/// Imports a file to the archive. Large compressed files are encoded on all cores and written by the library
+				/// itself instead of StormLib, which flushes the archive first (unless files in it are open).
 				/// </summary>
 				/// <param name="FileName">The filename to save as in the archive</param>
 				/// <param name="RealFileName">The file to import</param>
@@ -134,6 +195,16 @@ namespace MpqLib
 				/// <param name="Encryption">Which encryption to use on the file when importing</param>
 				System::Void ImportFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression, EEncryption Encryption);
 
+				/// <summary>
+				/// Imports a file to the archive, compressed with the given codec parameters. Parameters other than the defaults
+				/// need the classic tables and no open files, the file is then always written by the library itself.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="RealFileName">The file to import</param>
+				/// <param name="Options">The compression (and codec parameters) to use</param>
+				/// <param name="Encryption">Which encryption to use on the file when importing</param>
+				System::Void ImportFile(System::String^ FileName, System::String^ RealFileName, CCompressionOptions^ Options, EEncryption Encryption);
+
 				/// <summary>
 				/// Imports a file to the archive.
 				/// </summary>
@@ -158,6 +229,16 @@ namespace MpqLib
 				/// <param name="Encryption">Which encryption to use on the file when importing</param>
 				System::Void ImportFile(System::String^ FileName, array<System::Byte>^ FileData, ECompression Compression, EEncryption Encryption);
 
+				/// <summary>
+				/// Imports a file to the archive, compressed with the given codec parameters. Parameters other than the defaults
+				/// need the classic tables and no open files, the file is then always written by the library itself.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="FileData">The file to import, stored in a buffer</param>
+				/// <param name="Options">The compression (and codec parameters) to use</param>
+				/// <param name="Encryption">Which encryption to use on the file when importing</param>
+				System::Void ImportFile(System::String^ FileName, array<System::Byte>^ FileData, CCompressionOptions^ Options, EEncryption Encryption);
+
 				/// <summary>
 				/// Imports a wave file to the archive.
 				/// </summary>
@@ -231,6 +312,14 @@ namespace MpqLib
 				/// <param name="RealFileName">The physical file to save to</param>
 				System::Void ExportFile(System::String^ FileName, System::String^ RealFileName);
 
+				/// <summary>
+				/// Exports a file from the archive, saving it to a physical file.
+				/// </summary>
+				/// <param name="FileName">The file to export</param>
+				/// <param name="RealFileName">The physical file to save to</param>
+				/// <param name="Locale">Which locale version of the file to export</param>
+				System::Void ExportFile(System::String^ FileName, System::String^ RealFileName, LCID Locale);
+
 				/// <summary>
 				/// Exports a file from the archive, saving it to a buffer.
 				/// </summary>
@@ -246,6 +335,24 @@ namespace MpqLib
 				/// <param name="Index">The index in the buffer to start writing at</param>
 				System::Void ExportFile(System::String^ FileName, array<System::Byte>^ FileData, System::Int32 Index);
 
+				/// <summary>
+				/// Exports files from the archive to a directory, recreating the paths stored in the archive.
+				/// The files are read in the order they are stored, in large sequential reads, and decompressed in parallel.
+				/// </summary>
+				/// <param name="Mask">A wildcard filter deciding which files to export</param>
+				/// <param name="Directory">The directory to save to</param>
+				/// <returns>The number of files exported</returns>
+				System::Int32 ExportFiles(System::String^ Mask, System::String^ Directory);
+
+				/// <summary>
+				/// Exports files from the archive to a directory, recreating the paths stored in the archive.
+				/// The files are read in the order they are stored, in large sequential reads, and decompressed in parallel.
+				/// </summary>
+				/// <param name="Files">The files to export, as retrieved by FindFiles</param>
+				/// <param name="Directory">The directory to save to</param>
+				/// <returns>The number of files exported</returns>
+				System::Int32 ExportFiles(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files, System::String^ Directory);
+
 				/// <summary>
 				/// Renames a file in the archive.
 				/// </summary>
@@ -291,6 +398,24 @@ namespace MpqLib
 				/// <returns>A collection of the files found</returns>
 				System::Collections::Generic::IEnumerable<CFileInfo^>^ FindFiles(System::String^ Mask, System::String^ ExternalListFile, System::Boolean TraverseListFileOnly);
 
+				/// <summary>
+				/// Compares the archive to another archive. Unchanged files are detected from the
+				/// stored checksums and raw data where possible, without decompressing them.
+				/// The listfile and attributes are not compared, they change with every other file.
+				/// Unsaved changes of both archives are flushed first.
+				/// </summary>
+				/// <param name="Other">The archive to compare to (the newer version)</param>
+				/// <returns>A collection of the files added, removed, modified or renamed in the other archive</returns>
+				System::Collections::Generic::IEnumerable<CDiffEntry^>^ Diff(CArchive^ Other);
+
+				/// <summary>
+				/// Verifies the integrity of the archive: block bounds, sector CRCs and the checksums in "(attributes)".
+				/// Encrypted files without a known name can only be bounds checked, they are reported as EVerifyError::KeyUnknown.
+				/// Unsaved changes are flushed first, the files are then checked in parallel in the order they are stored.
+				/// </summary>
+				/// <returns>A report of the files found to be corrupted or truncated</returns>
+				CVerifyReport^ Verify();
+
 				/// <summary>
 				/// Generates a string version of the archive.
 				/// </summary>
@@ -302,13 +427,84 @@ namespace MpqLib
 				/// </summary>
 				property System::Int32 FileCount { System::Int32 get(); }
 
+				/// <summary>
+				/// Retrieves the MPQ format of the archive.
+				/// </summary>
+				property EArchiveFormat Format { EArchiveFormat get(); }
+
+				/// <summary>
+				/// Retrieves the number of entries in the hash table.
+				/// </summary>
+				property System::Int32 HashTableSize { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the number of bytes in the holes between the files of the archive, including unsaved changes.
+				/// Removed and replaced files leave these holes behind, blocks the library writes itself are placed into the
+				/// best-fitting one (StormLib appends its own). Compact and CompactIncrementally remove them.
+				/// </summary>
+				property System::Int64 FreeSpace { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the fraction of the hash table that is in use (including deleted entries).
+				/// </summary>
+				property System::Double HashTableLoadFactor { System::Double get(); }
+
+				/// <summary>
+				/// Gets or sets the load factor at which Flush and Compact rebuild the hash table with a larger size.
+				/// </summary>
+				property System::Double MaxHashTableLoadFactor { System::Double get(); System::Void set(System::Double MaxHashTableLoadFactor); }
+
 				/// <summary>
 				/// Gets or sets the archive locale (for language specific files).
+				/// The locale only affects this archive, other archives are not changed.
 				/// </summary>
 				property LCID Locale { LCID get(); System::Void set(LCID Locale); }
 
+				/// <summary>
+				/// Gets or sets how imported files are stored. When deduplicating, a file with the same content
+				/// and compression as an existing file shares its block instead of being compressed and stored again.
+				/// Only new, unencrypted imports into version 1 and 2 archives are deduplicated. Once written, names sharing
+				/// a block are left to StormLib like those of any other archive, which lists only one of them after it
+				/// rewrites the listfile.
+				/// </summary>
+				property EImportMode ImportMode { EImportMode get(); System::Void set(EImportMode ImportMode); }
+
+				/// <summary>
+				/// Gets or sets the budget for the decompressed data cached by the file streams of the archive.
+				/// Streams of files that do not fit the budget read from the archive on demand instead.
+				/// </summary>
+				property CMemoryBudget^ MemoryBudget { CMemoryBudget^ get(); System::Void set(CMemoryBudget^ MemoryBudget); }
+
+				/// <summary>
+				/// Gets or sets whether the decoded hash and block tables are kept in a named shared memory segment.
+				/// Processes opening the same unchanged archive attach to the segment of the first one instead of
+				/// decoding their own copy. Changes keep the index private until they are flushed. Only meant for
+				/// archives no other process is changing.
+				/// </summary>
+				property System::Boolean ShareIndex { System::Boolean get(); System::Void set(System::Boolean ShareIndex); }
+
+				/// <summary>
+				/// Gets or sets the sink receiving the begin and end events of the operations on the archive and its
+				/// file streams (null to disable tracing). File streams pick up the sink when they are opened.
+				/// </summary>
+				property ITraceSink^ TraceSink { ITraceSink^ get(); System::Void set(ITraceSink^ TraceSink); }
+
+				/// <summary>
+				/// Retrieves the root of the directory tree of the archive. The tree is built on first access, the changes
+				/// made through the archive since then are applied to it each time the property is read again (not as they
+				/// are made). Directories fill in their contents when first browsed. Compacting the archive or importing a
+				/// listfile builds a new tree.
+				/// </summary>
+				property CDirectoryNode^ Root { CDirectoryNode^ get(); }
+
+				/// <summary>
+				/// Retrieves the pool the file stream caches and export buffers of the archive are taken from.
+				/// </summary>
+				property CBufferPool^ BufferPool { CBufferPool^ get(); }
+
 				/// <summary>
 				/// Retrieves the archive handle.
+				/// The handle is replaced when Flush or Compact rewrite the tables, it should not be kept.
 				/// </summary>
 				property HANDLE Handle { HANDLE get(); }
 
@@ -327,18 +523,96 @@ namespace MpqLib
 				/// </summary>
 				property System::Boolean IsDisposed { System::Boolean get(); }
 
+			internal:
+				HANDLE OpenFile(System::String^ FileName, LCID Locale);
+				HANDLE OpenFile(System::String^ FileName, LCID Locale, System::Int32% BlockIndex);
+				HANDLE TryOpenFile(System::String^ FileName, LCID Locale, System::Int32% BlockIndex);
+				array<System::Byte>^ ReadFile(System::String^ FileName, LCID Locale);
+				System::String^ ResolveFileName(System::String^ FileName, LCID% Locale);
+				System::Nullable<ECompression> ProbeCompression(System::String^ FileName, System::Int32 BlockIndex);
+				System::Void AttachReader(System::Object^ Reader);
+				System::Void DetachReader(System::Object^ Reader);
+
+				property CArchiveIndex^ Index { CArchiveIndex^ get(); }
+				property CArchiveHeader^ Header { CArchiveHeader^ get(); }
+				property System::Int32 Generation { System::Int32 get(); }
+
+				static System::UInt32 BuildFileFlags(ECompression Compression, EEncryption Encryption);
+				static System::UInt32 BuildCompressionFlags(ECompression Compression);
+
 			private:
 				System::Void Open(System::Boolean CreateIfNotExists, EArchiveFormat ArchiveFormat, System::UInt32 HashTableSize);
 				System::Void Cleanup(System::Boolean CleanupManagedStuff);
 				System::Void CheckBadState();
+				System::Void InvalidateIndex();
+				System::Void DiscardIndex();
+				System::Void DiscardNames();
+				System::Void UpdateName(System::String^ FileName);
+				System::Void RemoveName(System::String^ FileName);
+				System::Void DiscardRoot();
+				System::Void NoteChange(System::String^ FileName);
+				System::Void Reopen();
+				System::Void BeginEdit();
+				System::Void AbortEdit();
+				System::Void CheckReaders();
+				System::Boolean HasReaders();
+				CFreeSpaceMap^ BuildFreeSpaceMap();
+
+				System::Boolean GrowHashTable(System::Boolean TableIsFull);
+
+				System::String^ BuildContentKey(System::String^ RealFileName, System::UInt32 Flags, System::UInt32 CompressionFlags);
+				System::Boolean ImportDuplicate(System::String^ FileName, System::String^ ContentKey);
+				System::Void ForgetContent(System::String^ FileName);
+
+				System::Void WritePendingLinks(System::Boolean KeepOpen);
+				System::Void WriteSpecialFiles(CArchiveEditor% Editor, array<System::Byte>^ ListFileData, array<System::Byte>^ AttributesData, System::Collections::Generic::IEnumerable<System::String^>^ FileNames, System::Int32 BlockIndex, array<System::Byte>^ FileData);
+
+				System::Boolean IsEncodedImport(System::String^ RealFileName, System::UInt32 Flags);
+				System::Void WriteEncodedFile(System::String^ FileName, System::String^ RealFileName, System::UInt32 Flags, System::UInt32 CompressionFlags, CCompressionOptions^ Options);
+
+				System::Boolean HasPendingNames();
+				System::Collections::Generic::List<System::String^>^ FindLinks(System::String^ StoredFileName);
+				System::Void LinkFile(System::String^ FileName, System::String^ StoredFileName);
+				System::Boolean UnlinkFile(System::String^ FileName);
+				System::Void RetargetLinks(System::String^ StoredFileName, System::String^ NewStoredFileName);
+				System::Boolean ReleaseLinks(System::String^ FileName);
+				System::Void AddPendingNames(System::Collections::Generic::List<CFileInfo^>^ FileInfoList, System::String^ Mask, CArchiveIndex^ ArchiveIndex, CArchiveHeader^ Header);
+				System::Collections::Generic::List<CFileInfo^>^ FindName(System::String^ FileName);
+				System::Collections::Generic::List<System::String^>^ ReadListFile(array<System::Byte>^ FileData);
+
+				CFileInfo^ CreateFileInfo(System::String^ FileName, System::Int32 BlockIndex, LCID Locale, CArchiveIndex^ ArchiveIndex, CArchiveHeader^ Header);
+
+				property CNameTrie^ NameTrie { CNameTrie^ get(); }
+				property System::Collections::Generic::Dictionary<System::String^, System::String^>^ ContentIndex { System::Collections::Generic::Dictionary<System::String^, System::String^>^ get(); }
 
-				System::UInt32 BuildFileFlags(ECompression Compression, EEncryption Encryption);
 				System::UInt32 BuildWaveFlags(EQuality Quality);
 				System::UInt32 BuildArchiveFlags(EArchiveFormat ArchiveFormat);
 
 			private:
 				HANDLE _Handle;
 				System::String^ _FileName;
+				EArchiveFormat _Format;
+
+				LCID _Locale;
+				System::Double _MaxHashTableLoadFactor;
+				CArchiveIndex^ _Index;
+				CArchiveHeader^ _Header;
+				System::Int32 _Generation;
+				System::Object^ _IndexLock;
+
+				EImportMode _ImportMode;
+				CMemoryBudget^ _MemoryBudget;
+				CBufferPool^ _BufferPool;
+				System::Boolean _ShareIndex;
+				System::Boolean _HasPendingChanges;
+				System::Collections::Generic::Dictionary<System::String^, System::String^>^ _ContentIndex;
+				CNameTrie^ _NameTrie;
+				ITraceSink^ _TraceSink;
+				CDirectoryNode^ _Root;
+				System::Collections::Generic::HashSet<System::String^>^ _RootChanges;
+				System::Collections::Generic::HashSet<System::String^>^ _UnflushedChanges;
+				System::Collections::Generic::List<System::WeakReference^>^ _Readers;
+				System::Collections::Generic::Dictionary<System::String^, System::String^>^ _PendingLinks;
 
 				System::Object^ _Tag;
 				System::Boolean _Disposed;
@@ -0,0 +1,244 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveComparer.h"
+
+MpqLib::Mpq::CArchiveComparer::CArchiveComparer(CArchive^ OldArchive, CArchive^ NewArchive)
+{
+	_Old = gcnew CArchiveSnapshot(OldArchive);
+	_New = gcnew CArchiveSnapshot(NewArchive);
+}
+
+MpqLib::Mpq::CArchiveComparer::~CArchiveComparer()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveComparer::!CArchiveComparer()
+{
+	Cleanup(false);
+}
+
+System::Collections::Generic::List<MpqLib::Mpq::CDiffEntry^>^ MpqLib::Mpq::CArchiveComparer::Compare()
+{
+	System::Collections::Generic::List<CDiffEntry^>^ DiffList = gcnew System::Collections::Generic::List<CDiffEntry^>();
+	System::Collections::Generic::List<System::String^>^ RemovedList = gcnew System::Collections::Generic::List<System::String^>();
+	System::Collections::Generic::List<System::String^>^ AddedList = gcnew System::Collections::Generic::List<System::String^>();
+
+	for each(System::String^ FileName in _Old->Files->Keys)
+	{
+		if(!_New->Files->ContainsKey(FileName)) RemovedList->Add(FileName);
+		else if(IsModified(FileName)) DiffList->Add(gcnew CDiffEntry(FileName, FileName, EDiffKind::Modified));
+	}
+
+	for each(System::String^ FileName in _New->Files->Keys)
+	{
+		if(!_Old->Files->ContainsKey(FileName)) AddedList->Add(FileName);
+	}
+
+	//Only added files of the same size can be renames, so each removed file is tried against its own bucket
+	System::Collections::Generic::Dictionary<System::Int64, System::Collections::Generic::List<System::String^>^>^ AddedBuckets = gcnew System::Collections::Generic::Dictionary<System::Int64, System::Collections::Generic::List<System::String^>^>();
+
+	for each(System::String^ FileName in AddedList)
+	{
+		System::Int32 BlockIndex = _New->Files[FileName];
+		if(BlockIndex == CConstants::InvalidIndex) continue;
+
+		System::Int64 FileSize = _New->GetBlockEntry(BlockIndex).FileSize;
+		System::Collections::Generic::List<System::String^>^ Bucket = nullptr;
+
+		if(!AddedBuckets->TryGetValue(FileSize, Bucket))
+		{
+			Bucket = gcnew System::Collections::Generic::List<System::String^>();
+			AddedBuckets->Add(FileSize, Bucket);
+		}
+
+		Bucket->Add(FileName);
+	}
+
+	//A removed file whose contents reappear under an added name is reported as a rename
+	for each(System::String^ OldFileName in RemovedList)
+	{
+		System::String^ NewFileName = nullptr;
+		System::Int32 BlockIndex = _Old->Files[OldFileName];
+		System::Collections::Generic::List<System::String^>^ Bucket = nullptr;
+
+		if((BlockIndex != CConstants::InvalidIndex) && AddedBuckets->TryGetValue(_Old->GetBlockEntry(BlockIndex).FileSize, Bucket))
+		{
+			for each(System::String^ AddedFileName in Bucket)
+			{
+				if(!IsRenamed(OldFileName, AddedFileName)) continue;
+
+				NewFileName = AddedFileName;
+				break;
+			}
+		}
+
+		if(NewFileName == nullptr)
+		{
+			DiffList->Add(gcnew CDiffEntry(OldFileName, OldFileName, EDiffKind::Removed));
+		}
+		else
+		{
+			Bucket->Remove(NewFileName);
+			AddedList->Remove(NewFileName);
+			DiffList->Add(gcnew CDiffEntry(NewFileName, OldFileName, EDiffKind::Renamed));
+		}
+	}
+
+	for each(System::String^ FileName in AddedList)
+	{
+		DiffList->Add(gcnew CDiffEntry(FileName, FileName, EDiffKind::Added));
+	}
+
+	return DiffList;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveComparer::IsModified(System::String^ FileName)
+{
+	System::Int32 OldBlockIndex = _Old->Files[FileName];
+	System::Int32 NewBlockIndex = _New->Files[FileName];
+
+	if((OldBlockIndex == CConstants::InvalidIndex) || (NewBlockIndex == CConstants::InvalidIndex)) return !ContentEquals(FileName, FileName);
+
+	SBlockEntry OldBlock = _Old->GetBlockEntry(OldBlockIndex);
+	SBlockEntry NewBlock = _New->GetBlockEntry(NewBlockIndex);
+	CAttributes^ OldAttributes = _Old->Attributes;
+	CAttributes^ NewAttributes = _New->Attributes;
+
+	if(OldBlock.FileSize != NewBlock.FileSize) return true;
+
+	if((OldAttributes != nullptr) && (NewAttributes != nullptr))
+	{
+		if(OldAttributes->HasMd5(OldBlockIndex) && NewAttributes->HasMd5(NewBlockIndex)) return (OldAttributes->GetMd5(OldBlockIndex) != NewAttributes->GetMd5(NewBlockIndex));
+		if(OldAttributes->HasCrc32(OldBlockIndex) && NewAttributes->HasCrc32(NewBlockIndex) && (OldAttributes->GetCrc32(OldBlockIndex) != NewAttributes->GetCrc32(NewBlockIndex))) return true;
+	}
+
+	//The same name gives the same key, unless the key is adjusted by the block position
+	if((OldBlock.Flags == NewBlock.Flags) && (OldBlock.CompressedSize == NewBlock.CompressedSize))
+	{
+		if(((OldBlock.Flags & MPQ_FILE_FIX_KEY) == 0) || (OldBlock.FilePosition == NewBlock.FilePosition))
+		{
+			if(RawEquals(OldBlockIndex, NewBlockIndex)) return false;
+		}
+	}
+
+	return !ContentEquals(FileName, FileName);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveComparer::IsRenamed(System::String^ OldFileName, System::String^ NewFileName)
+{
+	System::Int32 OldBlockIndex = _Old->Files[OldFileName];
+	System::Int32 NewBlockIndex = _New->Files[NewFileName];
+
+	if((OldBlockIndex == CConstants::InvalidIndex) || (NewBlockIndex == CConstants::InvalidIndex)) return false;
+
+	SBlockEntry OldBlock = _Old->GetBlockEntry(OldBlockIndex);
+	SBlockEntry NewBlock = _New->GetBlockEntry(NewBlockIndex);
+	CAttributes^ OldAttributes = _Old->Attributes;
+	CAttributes^ NewAttributes = _New->Attributes;
+
+	if(OldBlock.FileSize != NewBlock.FileSize) return false;
+
+	if((OldAttributes != nullptr) && (NewAttributes != nullptr))
+	{
+		if(OldAttributes->HasMd5(OldBlockIndex) && NewAttributes->HasMd5(NewBlockIndex)) return (OldAttributes->GetMd5(OldBlockIndex) == NewAttributes->GetMd5(NewBlockIndex));
+		if(OldAttributes->HasCrc32(OldBlockIndex) && NewAttributes->HasCrc32(NewBlockIndex) && (OldAttributes->GetCrc32(OldBlockIndex) != NewAttributes->GetCrc32(NewBlockIndex))) return false;
+	}
+
+	//Encrypted blocks are keyed by their name, so they never match raw under a new name
+	if((OldBlock.Flags == NewBlock.Flags) && (OldBlock.CompressedSize == NewBlock.CompressedSize) && ((OldBlock.Flags & MPQ_FILE_ENCRYPTED) == 0))
+	{
+		if(RawEquals(OldBlockIndex, NewBlockIndex)) return true;
+	}
+
+	return ContentEquals(OldFileName, NewFileName);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveComparer::RawEquals(System::Int32 OldBlockIndex, System::Int32 NewBlockIndex)
+{
+	System::Int64 Size = _Old->GetBlockEntry(OldBlockIndex).CompressedSize;
+	array<System::Byte>^ OldBuffer = gcnew array<System::Byte>(CConstants::ExportBufferSize);
+	array<System::Byte>^ NewBuffer = gcnew array<System::Byte>(CConstants::ExportBufferSize);
+
+	for(System::Int64 Offset = 0; Offset < Size; Offset += OldBuffer->Length)
+	{
+		System::Int32 BytesToRead = static_cast<System::Int32>(System::Math::Min(Size - Offset, static_cast<System::Int64>(OldBuffer->Length)));
+
+		_Old->ReadRaw(OldBlockIndex, Offset, OldBuffer, BytesToRead);
+		_New->ReadRaw(NewBlockIndex, Offset, NewBuffer, BytesToRead);
+
+		pin_ptr<System::Byte> OldPointer = &OldBuffer[0];
+		pin_ptr<System::Byte> NewPointer = &NewBuffer[0];
+		if(memcmp(OldPointer, NewPointer, BytesToRead) != 0) return false;
+	}
+
+	return true;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveComparer::ContentEquals(System::String^ OldFileName, System::String^ NewFileName)
+{
+	HANDLE OldHandle = _Old->Archive->OpenFile(OldFileName, _Old->Archive->Locale);
+	HANDLE NewHandle = NULL;
+
+	try
+	{
+		NewHandle = _New->Archive->OpenFile(NewFileName, _New->Archive->Locale);
+
+		std::vector<BYTE> OldBuffer(CConstants::ExportBufferSize);
+		std::vector<BYTE> NewBuffer(CConstants::ExportBufferSize);
+
+		while(true)
+		{
+			DWORD OldBytesRead = 0;
+			DWORD NewBytesRead = 0;
+
+			if(!SFileReadFile(OldHandle, &OldBuffer[0], static_cast<DWORD>(OldBuffer.size()), &OldBytesRead, NULL) && (GetLastError() != ERROR_HANDLE_EOF)) throw gcnew System::IO::IOException("Unable to read \"" + OldFileName + "\"!");
+			if(!SFileReadFile(NewHandle, &NewBuffer[0], static_cast<DWORD>(NewBuffer.size()), &NewBytesRead, NULL) && (GetLastError() != ERROR_HANDLE_EOF)) throw gcnew System::IO::IOException("Unable to read \"" + NewFileName + "\"!");
+
+			if(OldBytesRead != NewBytesRead) return false;
+			if(memcmp(&OldBuffer[0], &NewBuffer[0], OldBytesRead) != 0) return false;
+			if(OldBytesRead < OldBuffer.size()) return true;
+		}
+	}
+	finally
+	{
+		if(NewHandle != NULL) SFileCloseFile(NewHandle);
+		SFileCloseFile(OldHandle);
+	}
+}
+
+void MpqLib::Mpq::CArchiveComparer::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff)
+	{
+		delete _Old;
+		delete _New;
+	}
+}
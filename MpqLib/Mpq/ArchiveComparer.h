@@ -0,0 +1,67 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "ArchiveSnapshot.h"
+#include "DiffEntry.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Compares the files of two archives. Decisions are made from the block tables,
+		/// the "(attributes)" checksums and the raw stored bytes whenever possible,
+		/// files are only decompressed when none of those are conclusive.
+		/// </summary>
+		private ref class CArchiveComparer
+		{
+			public:
+				CArchiveComparer(CArchive^ OldArchive, CArchive^ NewArchive);
+				~CArchiveComparer();
+				!CArchiveComparer();
+
+				System::Collections::Generic::List<CDiffEntry^>^ Compare();
+
+			private:
+				System::Boolean IsModified(System::String^ FileName);
+				System::Boolean IsRenamed(System::String^ OldFileName, System::String^ NewFileName);
+
+				System::Boolean RawEquals(System::Int32 OldBlockIndex, System::Int32 NewBlockIndex);
+				System::Boolean ContentEquals(System::String^ OldFileName, System::String^ NewFileName);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				CArchiveSnapshot^ _Old;
+				CArchiveSnapshot^ _New;
+		};
+	}
+}
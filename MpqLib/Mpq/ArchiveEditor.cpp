@@ -0,0 +1,623 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveEditor.h"
+
+MpqLib::Mpq::CArchiveEditor::CArchiveEditor(System::String^ FileName)
+{
+	_Stream = nullptr;
+	_HashTable = new std::vector<SHashEntry>();
+	_BlockTable = new std::vector<SBlockEntry>();
+	_HiBlockTable = new std::vector<USHORT>();
+
+	_Header = gcnew CArchiveHeader(FileName);
+	if(_Header->Format > EArchiveFormat::Version2) throw gcnew System::NotSupportedException("Editing the tables of archives using HET/BET tables is not supported!");
+
+	_Stream = gcnew System::IO::FileStream(FileName, System::IO::FileMode::Open, System::IO::FileAccess::ReadWrite, System::IO::FileShare::Read);
+
+	_HashTable->resize(_Header->HashTableSize);
+	_BlockTable->resize(_Header->BlockTableSize);
+
+	if(!_HashTable->empty())
+	{
+		ReadData(_Header->HashTablePosition, &((*_HashTable)[0]), static_cast<System::Int32>(_HashTable->size() * sizeof(SHashEntry)));
+		CCryptography::DecryptBlock(&((*_HashTable)[0]), static_cast<DWORD>(_HashTable->size() * sizeof(SHashEntry)), CCryptography::HashString("(hash table)", CCryptography::HashTypeFileKey));
+	}
+
+	if(!_BlockTable->empty())
+	{
+		ReadData(_Header->BlockTablePosition, &((*_BlockTable)[0]), static_cast<System::Int32>(_BlockTable->size() * sizeof(SBlockEntry)));
+		CCryptography::DecryptBlock(&((*_BlockTable)[0]), static_cast<DWORD>(_BlockTable->size() * sizeof(SBlockEntry)), CCryptography::HashString("(block table)", CCryptography::HashTypeFileKey));
+	}
+
+	if((_Header->HiBlockTablePosition != 0) && !_BlockTable->empty())
+	{
+		_HiBlockTable->resize(_BlockTable->size());
+		ReadData(_Header->HiBlockTablePosition, &((*_HiBlockTable)[0]), static_cast<System::Int32>(_HiBlockTable->size() * sizeof(USHORT)));
+	}
+
+	//The tables the header points to stay untouched until new ones are on disk
+	_TablesPosition = System::Math::Min(_Header->HashTablePosition, _Header->BlockTablePosition);
+	_TablesEnd = System::Math::Max(_Header->HashTablePosition + static_cast<System::Int64>(_HashTable->size() * sizeof(SHashEntry)), _Header->BlockTablePosition + static_cast<System::Int64>(_BlockTable->size() * sizeof(SBlockEntry)));
+
+	if(!_HiBlockTable->empty())
+	{
+		_TablesPosition = System::Math::Min(_TablesPosition, _Header->HiBlockTablePosition);
+		_TablesEnd = System::Math::Max(_TablesEnd, _Header->HiBlockTablePosition + static_cast<System::Int64>(_HiBlockTable->size() * sizeof(USHORT)));
+	}
+
+	//New data goes right after the last block, unless the tables are in the way
+	UpdateDataEnd();
+	_CommittedDataEnd = _DataEnd;
+
+	UpdateFreeSpace();
+}
+
+MpqLib::Mpq::CArchiveEditor::~CArchiveEditor()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveEditor::!CArchiveEditor()
+{
+	Cleanup(false);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveEditor::FindBlock(LPCSTR FileName, LCID Locale)
+{
+	System::Int32 HashIndex = FindHashEntry(FileName, Locale);
+	if(HashIndex == CConstants::InvalidIndex) return CConstants::InvalidIndex;
+
+	DWORD BlockIndex = (*_HashTable)[HashIndex].BlockIndex;
+	if((BlockIndex >= _BlockTable->size()) || (((*_BlockTable)[BlockIndex].Flags & MPQ_FILE_EXISTS) == 0)) return CConstants::InvalidIndex;
+
+	return static_cast<System::Int32>(BlockIndex);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveEditor::AddHashEntry(LPCSTR FileName, LCID Locale, DWORD BlockIndex)
+{
+	if(_HashTable->empty() || (BlockIndex >= _BlockTable->size())) return false;
+
+	System::Int32 HashIndex = FindHashEntry(FileName, Locale);
+
+	if(HashIndex == CConstants::InvalidIndex)
+	{
+		DWORD Mask = static_cast<DWORD>(_HashTable->size() - 1);
+		DWORD Start = CCryptography::HashString(FileName, CCryptography::HashTypeTableOffset) & Mask;
+
+		for(DWORD i = Start; ; )
+		{
+			DWORD EntryBlockIndex = (*_HashTable)[i].BlockIndex;
+
+			if((EntryBlockIndex == HASH_ENTRY_FREE) || (EntryBlockIndex == HASH_ENTRY_DELETED))
+			{
+				HashIndex = static_cast<System::Int32>(i);
+				break;
+			}
+
+			i = (i + 1) & Mask;
+			if(i == Start) return false;
+		}
+	}
+
+	SHashEntry& Entry = (*_HashTable)[HashIndex];
+	Entry.Name1 = CCryptography::HashString(FileName, CCryptography::HashTypeNameA);
+	Entry.Name2 = CCryptography::HashString(FileName, CCryptography::HashTypeNameB);
+	Entry.Locale = static_cast<USHORT>(Locale);
+	Entry.Platform = 0;
+	Entry.BlockIndex = BlockIndex;
+
+	return true;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveEditor::RemoveHashEntry(LPCSTR FileName, LCID Locale)
+{
+	System::Int32 HashIndex = FindHashEntry(FileName, Locale);
+	if(HashIndex == CConstants::InvalidIndex) return false;
+
+	SHashEntry& Entry = (*_HashTable)[HashIndex];
+	Entry.Name1 = 0xFFFFFFFF;
+	Entry.Name2 = 0xFFFFFFFF;
+	Entry.Locale = 0xFFFF;
+	Entry.Platform = 0xFFFF;
+	Entry.BlockIndex = HASH_ENTRY_DELETED;
+
+	return true;
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::ReplaceBlock(DWORD BlockIndex, array<System::Byte>^ FileData)
+{
+	if(BlockIndex >= _BlockTable->size()) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+
+	//The new data is stored plain (not compressed or encrypted), the old space is left as a hole
+	System::Int64 Position = AllocateSpace(FileData->Length);
+
+	if(FileData->Length > 0)
+	{
+		pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+		WriteData(Position, FileDataPointer, FileData->Length);
+	}
+
+	SetBlockPosition(BlockIndex, Position);
+
+	SBlockEntry& Block = (*_BlockTable)[BlockIndex];
+	Block.CompressedSize = FileData->Length;
+	Block.FileSize = FileData->Length;
+	Block.Flags = MPQ_FILE_EXISTS;
+
+	_DataEnd = System::Math::Max(_DataEnd, Position + FileData->Length);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveEditor::WriteBlock(LPCSTR FileName, LCID Locale, array<System::Byte>^ FileData, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize)
+{
+	System::Int32 OldBlockIndex = FindBlock(FileName, Locale);
+	DWORD BlockIndex = AddBlockEntry();
+
+	SBlockEntry Block;
+	Block.FilePosition = 0;
+	Block.CompressedSize = 0;
+	Block.FileSize = static_cast<DWORD>(FileData->Length);
+	Block.Flags = Flags | MPQ_FILE_EXISTS;
+
+	System::Int64 Position = 0;
+	array<System::Byte>^ BlockData = nullptr;
+
+	if(Flags & MPQ_FILE_FIX_KEY)
+	{
+		//The key depends on the position, so room for the largest possible block is taken before encoding and the rest of a hole is given back
+		System::Int64 SectorCount = (FileData->Length + _Header->SectorSize - 1) / _Header->SectorSize;
+		System::Int64 OffsetTableSize = ((Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) && (SectorCount > 0)) ? (SectorCount + 1) * static_cast<System::Int64>(sizeof(DWORD)) : 0;
+		System::Int64 MaxSize = OffsetTableSize + FileData->Length;
+
+		Position = AllocateSpace(MaxSize);
+		Block.FilePosition = static_cast<DWORD>(Position);
+		BlockData = CBlockEncoder::EncodeBlock(FileData, Block.Flags, CompressionFlags, Level, DictionarySize, CCryptography::GetFileKey(FileName, Block), _Header->SectorSize);
+
+		if((_FreeSpace != nullptr) && (Position < _FreeSpace->DataEnd)) _FreeSpace->Release(Position + BlockData->Length, MaxSize - BlockData->Length);
+	}
+	else
+	{
+		DWORD Key = (Flags & MPQ_FILE_ENCRYPTED) ? CCryptography::GetFileKey(FileName, Block) : 0;
+
+		BlockData = CBlockEncoder::EncodeBlock(FileData, Block.Flags, CompressionFlags, Level, DictionarySize, Key, _Header->SectorSize);
+		Position = AllocateSpace(BlockData->Length);
+	}
+
+	if(BlockData->Length > 0)
+	{
+		_Stream->Position = _Header->ArchiveOffset + Position;
+		_Stream->Write(BlockData, 0, BlockData->Length);
+	}
+
+	Block.CompressedSize = BlockData->Length;
+	(*_BlockTable)[BlockIndex] = Block;
+	SetBlockPosition(BlockIndex, Position);
+
+	_DataEnd = System::Math::Max(_DataEnd, Position + BlockData->Length);
+
+	if(!AddHashEntry(FileName, Locale, BlockIndex)) throw gcnew System::IO::IOException("The hash table is full!");
+
+	//The old version is dropped unless another name still reads it, its space becomes a hole once the tables are committed
+	if((OldBlockIndex != CConstants::InvalidIndex) && !IsBlockUsed(static_cast<DWORD>(OldBlockIndex)))
+	{
+		SBlockEntry& OldBlock = (*_BlockTable)[OldBlockIndex];
+		OldBlock.FilePosition = 0;
+		OldBlock.CompressedSize = 0;
+		OldBlock.FileSize = 0;
+		OldBlock.Flags = 0;
+
+		if(!_HiBlockTable->empty()) (*_HiBlockTable)[OldBlockIndex] = 0;
+	}
+
+	return static_cast<System::Int32>(BlockIndex);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveEditor::Compact(System::Int64 MaxBytesMoved)
+{
+	System::Int64 DataEnd = _Header->HeaderSize;
+	System::Int64 BytesMoved = 0;
+	System::Int64 TablesSize = GetTablesSize();
+
+	//Blocks are moved into the holes here, the map is built again by the next commit
+	_FreeSpace = nullptr;
+
+	//The end of the places the blocks moved since the last commit came from, the tables on disk still point there
+	System::Int64 SourceEnd = 0;
+
+	//Blocks are visited in stored order, each one after a hole is moved down to the end of the one before it
+	for each(DWORD BlockIndex in SortBlocks())
+	{
+		SBlockEntry& Block = (*_BlockTable)[BlockIndex];
+		System::Int64 Position = GetBlockPosition(BlockIndex);
+		System::Int64 Size = Block.CompressedSize;
+
+		//The key of blocks encrypted with a fixed key depends on the position, those stay where they are
+		if((Position <= DataEnd) || (Block.Flags & MPQ_FILE_FIX_KEY))
+		{
+			DataEnd = System::Math::Max(DataEnd, Position + Size);
+			continue;
+		}
+
+		//A block overlapping its new place is parked past everything else first, so one whole copy is always on disk.
+		//The others are moved together until one would land where the tables on disk still point, those are committed first
+		System::Boolean IsParked = ((DataEnd + Size) > Position);
+		System::Boolean IsBlocked = !IsParked && ((DataEnd < SourceEnd) || OverlapsTables(DataEnd, Size));
+		System::Int64 Cost = (IsParked ? (2 * Size) : Size) + ((IsParked || IsBlocked) ? TablesSize : 0);
+
+		//Every copy and table write counts, the tables Save writes included. At least one block is moved per call, so every call makes progress
+		if((BytesMoved > 0) && ((BytesMoved + Cost + TablesSize) > MaxBytesMoved)) return false;
+
+		if(IsParked)
+		{
+			MoveBlock(BlockIndex, GetFreePosition(Size));
+			Commit();
+
+			Position = GetBlockPosition(BlockIndex);
+		}
+		else if(IsBlocked)
+		{
+			Commit();
+		}
+
+		MoveBlock(BlockIndex, DataEnd);
+
+		SourceEnd = (IsParked || IsBlocked) ? (Position + Size) : System::Math::Max(SourceEnd, Position + Size);
+		DataEnd += Size;
+		BytesMoved += Cost;
+	}
+
+	return true;
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::Save()
+{
+	Commit();
+
+	//Tables that had to make way for the live ones are brought back to the end of the data
+	if(_TablesPosition != _DataEnd) Commit();
+
+	_Stream->SetLength(_Header->ArchiveOffset + _TablesEnd);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveEditor::BlockTableSize::get()
+{
+	return static_cast<System::Int32>(_BlockTable->size());
+}
+
+System::Int64 MpqLib::Mpq::CArchiveEditor::DataEnd::get()
+{
+	return _DataEnd;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveEditor::FindHashEntry(LPCSTR FileName, LCID Locale)
+{
+	if(_HashTable->empty()) return CConstants::InvalidIndex;
+
+	DWORD Mask = static_cast<DWORD>(_HashTable->size() - 1);
+	DWORD Start = CCryptography::HashString(FileName, CCryptography::HashTypeTableOffset) & Mask;
+	DWORD Name1 = CCryptography::HashString(FileName, CCryptography::HashTypeNameA);
+	DWORD Name2 = CCryptography::HashString(FileName, CCryptography::HashTypeNameB);
+
+	for(DWORD i = Start; (*_HashTable)[i].BlockIndex != HASH_ENTRY_FREE; )
+	{
+		const SHashEntry& Entry = (*_HashTable)[i];
+
+		if((Entry.Name1 == Name1) && (Entry.Name2 == Name2) && (Entry.Locale == Locale) && (Entry.BlockIndex != HASH_ENTRY_DELETED)) return static_cast<System::Int32>(i);
+
+		i = (i + 1) & Mask;
+		if(i == Start) break;
+	}
+
+	return CConstants::InvalidIndex;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveEditor::IsBlockUsed(DWORD BlockIndex)
+{
+	for(DWORD i = 0; i < _HashTable->size(); i++)
+	{
+		if((*_HashTable)[i].BlockIndex == BlockIndex) return true;
+	}
+
+	return false;
+}
+
+DWORD MpqLib::Mpq::CArchiveEditor::AddBlockEntry()
+{
+	//The entries of removed files are taken before the table grows
+	for(DWORD i = 0; i < _BlockTable->size(); i++)
+	{
+		if(((*_BlockTable)[i].Flags & MPQ_FILE_EXISTS) == 0) return i;
+	}
+
+	if(_BlockTable->size() >= _HashTable->size()) throw gcnew System::IO::IOException("The block table can not hold more files than the hash table!");
+
+	SBlockEntry Block;
+	Block.FilePosition = 0;
+	Block.CompressedSize = 0;
+	Block.FileSize = 0;
+	Block.Flags = 0;
+
+	_BlockTable->push_back(Block);
+	if(!_HiBlockTable->empty()) _HiBlockTable->push_back(0);
+
+	return static_cast<DWORD>(_BlockTable->size() - 1);
+}
+
+System::Int64 MpqLib::Mpq::CArchiveEditor::GetBlockPosition(DWORD BlockIndex)
+{
+	System::Int64 Position = (*_BlockTable)[BlockIndex].FilePosition;
+	if(!_HiBlockTable->empty()) Position |= static_cast<System::Int64>((*_HiBlockTable)[BlockIndex]) << 32;
+
+	return Position;
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::SetBlockPosition(DWORD BlockIndex, System::Int64 Position)
+{
+	//Positions past 4 GB need the high words of the extended block table
+	if((Position > 0xFFFFFFFF) && _HiBlockTable->empty())
+	{
+		if(_Header->HeaderSize < MPQ_HEADER_SIZE_V2) throw gcnew System::IO::IOException("The archive has grown too large for the version 1 format!");
+
+		_HiBlockTable->resize(_BlockTable->size(), 0);
+	}
+
+	(*_BlockTable)[BlockIndex].FilePosition = static_cast<DWORD>(Position);
+	if(!_HiBlockTable->empty()) (*_HiBlockTable)[BlockIndex] = static_cast<USHORT>(Position >> 32);
+}
+
+System::Collections::Generic::List<DWORD>^ MpqLib::Mpq::CArchiveEditor::SortBlocks()
+{
+	System::Collections::Generic::List<DWORD>^ Blocks = gcnew System::Collections::Generic::List<DWORD>();
+
+	for(DWORD i = 0; i < _BlockTable->size(); i++)
+	{
+		if((*_BlockTable)[i].Flags & MPQ_FILE_EXISTS) Blocks->Add(i);
+	}
+
+	Blocks->Sort(gcnew System::Comparison<DWORD>(this, &CArchiveEditor::CompareBlockPositions));
+
+	return Blocks;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveEditor::CompareBlockPositions(DWORD BlockIndex1, DWORD BlockIndex2)
+{
+	return GetBlockPosition(BlockIndex1).CompareTo(GetBlockPosition(BlockIndex2));
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::UpdateDataEnd()
+{
+	_DataEnd = _Header->HeaderSize;
+
+	for(DWORD i = 0; i < _BlockTable->size(); i++)
+	{
+		const SBlockEntry& Block = (*_BlockTable)[i];
+		if((Block.Flags & MPQ_FILE_EXISTS) == 0) continue;
+
+		_DataEnd = System::Math::Max(_DataEnd, GetBlockPosition(i) + Block.CompressedSize);
+	}
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::MoveData(System::Int64 Position, System::Int64 NewPosition, DWORD Size)
+{
+	//Ranges only overlap when data moves down, copying front to back is safe then
+	array<System::Byte>^ Buffer = gcnew array<System::Byte>(CConstants::ExportBufferSize);
+
+	for(DWORD Offset = 0; Offset < Size; )
+	{
+		System::Int32 ChunkSize = static_cast<System::Int32>(System::Math::Min(static_cast<DWORD>(Buffer->Length), Size - Offset));
+		pin_ptr<System::Byte> BufferPointer = &Buffer[0];
+
+		ReadData(Position + Offset, BufferPointer, ChunkSize);
+		WriteData(NewPosition + Offset, BufferPointer, ChunkSize);
+
+		Offset += ChunkSize;
+	}
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::MoveBlock(DWORD BlockIndex, System::Int64 NewPosition)
+{
+	DWORD Size = (*_BlockTable)[BlockIndex].CompressedSize;
+
+	//The tables on disk keep pointing to the old copy until the next commit (blocks only move down, the data end is recounted then)
+	MoveData(GetBlockPosition(BlockIndex), NewPosition, Size);
+	SetBlockPosition(BlockIndex, NewPosition);
+
+	_DataEnd = System::Math::Max(_DataEnd, NewPosition + Size);
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::Commit()
+{
+	//The tables go to the end of the data, past the blocks the live tables still point to, or right behind the live tables when those are in the way
+	UpdateDataEnd();
+
+	System::Int64 TablesSize = GetTablesSize();
+	System::Int64 TablesPosition = GetFreePosition(TablesSize);
+
+	if(((TablesPosition + TablesSize) > 0xFFFFFFFF) && (_Header->HeaderSize < MPQ_HEADER_SIZE_V2)) throw gcnew System::IO::IOException("The archive has grown too large for the version 1 format!");
+
+	System::Int64 BlockTablePosition = TablesPosition + static_cast<System::Int64>(_HashTable->size() * sizeof(SHashEntry));
+	System::Int64 HiBlockTablePosition = BlockTablePosition + static_cast<System::Int64>(_BlockTable->size() * sizeof(SBlockEntry));
+
+	std::vector<SHashEntry> HashTable(*_HashTable);
+	std::vector<SBlockEntry> BlockTable(*_BlockTable);
+
+	if(!HashTable.empty())
+	{
+		CCryptography::EncryptBlock(&HashTable[0], static_cast<DWORD>(HashTable.size() * sizeof(SHashEntry)), CCryptography::HashString("(hash table)", CCryptography::HashTypeFileKey));
+		WriteData(TablesPosition, &HashTable[0], static_cast<System::Int32>(HashTable.size() * sizeof(SHashEntry)));
+	}
+
+	if(!BlockTable.empty())
+	{
+		CCryptography::EncryptBlock(&BlockTable[0], static_cast<DWORD>(BlockTable.size() * sizeof(SBlockEntry)), CCryptography::HashString("(block table)", CCryptography::HashTypeFileKey));
+		WriteData(BlockTablePosition, &BlockTable[0], static_cast<System::Int32>(BlockTable.size() * sizeof(SBlockEntry)));
+	}
+
+	if(!_HiBlockTable->empty())
+	{
+		WriteData(HiBlockTablePosition, &((*_HiBlockTable)[0]), static_cast<System::Int32>(_HiBlockTable->size() * sizeof(USHORT)));
+	}
+
+	//The data and the tables are on disk before the header points to them
+	_Stream->Flush(true);
+	WriteHeader(TablesPosition);
+	_Stream->Flush(true);
+
+	_TablesPosition = TablesPosition;
+	_TablesEnd = TablesPosition + TablesSize;
+	_CommittedDataEnd = _DataEnd;
+
+	UpdateFreeSpace();
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::WriteHeader(System::Int64 TablesPosition)
+{
+	System::Int64 HashTablePosition = TablesPosition;
+	System::Int64 BlockTablePosition = HashTablePosition + _HashTable->size() * sizeof(SHashEntry);
+	System::Int64 HiBlockTablePosition = BlockTablePosition + _BlockTable->size() * sizeof(SBlockEntry);
+	System::Int64 ArchiveSize = TablesPosition + GetTablesSize();
+
+	System::IO::BinaryWriter^ Writer = gcnew System::IO::BinaryWriter(_Stream);
+
+	_Stream->Position = _Header->ArchiveOffset + 8;
+	Writer->Write(static_cast<System::UInt32>(ArchiveSize));
+
+	_Stream->Position = _Header->ArchiveOffset + 16;
+	Writer->Write(static_cast<System::UInt32>(HashTablePosition));
+	Writer->Write(static_cast<System::UInt32>(BlockTablePosition));
+	Writer->Write(static_cast<System::UInt32>(_HashTable->size()));
+	Writer->Write(static_cast<System::UInt32>(_BlockTable->size()));
+
+	if(_Header->HeaderSize >= MPQ_HEADER_SIZE_V2)
+	{
+		Writer->Write(static_cast<System::Int64>(_HiBlockTable->empty() ? 0 : HiBlockTablePosition));
+		Writer->Write(static_cast<System::UInt16>(HashTablePosition >> 32));
+		Writer->Write(static_cast<System::UInt16>(BlockTablePosition >> 32));
+	}
+
+	Writer->Flush();
+}
+
+System::Boolean MpqLib::Mpq::CArchiveEditor::OverlapsTables(System::Int64 Position, System::Int64 Size)
+{
+	return (Position < _TablesEnd) && (_TablesPosition < (Position + Size));
+}
+
+System::Int64 MpqLib::Mpq::CArchiveEditor::GetFreePosition(System::Int64 Size)
+{
+	System::Int64 Position = System::Math::Max(_DataEnd, _CommittedDataEnd);
+
+	return OverlapsTables(Position, Size) ? _TablesEnd : Position;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveEditor::AllocateSpace(System::Int64 Size)
+{
+	System::Int64 Position = (_FreeSpace != nullptr) ? _FreeSpace->Allocate(Size) : CConstants::InvalidIndex;
+
+	return (Position != CConstants::InvalidIndex) ? Position : GetFreePosition(Size);
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::UpdateFreeSpace()
+{
+	//Only the holes of the committed tables are handed out, space freed since stays taken until it is committed too
+	System::Collections::Generic::List<System::Int64>^ Positions = gcnew System::Collections::Generic::List<System::Int64>();
+	System::Collections::Generic::List<System::Int64>^ Sizes = gcnew System::Collections::Generic::List<System::Int64>();
+
+	for(DWORD i = 0; i < _BlockTable->size(); i++)
+	{
+		const SBlockEntry& Block = (*_BlockTable)[i];
+		if((Block.Flags & MPQ_FILE_EXISTS) == 0) continue;
+
+		Positions->Add(GetBlockPosition(i));
+		Sizes->Add(Block.CompressedSize);
+	}
+
+	//The live tables may sit between the blocks when they had to make way
+	Positions->Add(_TablesPosition);
+	Sizes->Add(_TablesEnd - _TablesPosition);
+
+	_FreeSpace = gcnew CFreeSpaceMap(_Header->HeaderSize, _DataEnd, Positions->ToArray(), Sizes->ToArray());
+}
+
+System::Int64 MpqLib::Mpq::CArchiveEditor::GetTablesSize()
+{
+	return static_cast<System::Int64>(_HashTable->size() * sizeof(SHashEntry) + _BlockTable->size() * sizeof(SBlockEntry) + _HiBlockTable->size() * sizeof(USHORT));
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::ReadData(System::Int64 Position, void* Buffer, System::Int32 Size)
+{
+	array<System::Byte>^ Data = gcnew array<System::Byte>(Size);
+
+	_Stream->Position = _Header->ArchiveOffset + Position;
+	for(System::Int32 Index = 0; Index < Size; )
+	{
+		System::Int32 BytesRead = _Stream->Read(Data, Index, Size - Index);
+		if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The archive is truncated!");
+
+		Index += BytesRead;
+	}
+
+	System::Runtime::InteropServices::Marshal::Copy(Data, 0, static_cast<System::IntPtr>(Buffer), Size);
+}
+
+System::Void MpqLib::Mpq::CArchiveEditor::WriteData(System::Int64 Position, const void* Buffer, System::Int32 Size)
+{
+	array<System::Byte>^ Data = gcnew array<System::Byte>(Size);
+	System::Runtime::InteropServices::Marshal::Copy(static_cast<System::IntPtr>(const_cast<void*>(Buffer)), Data, 0, Size);
+
+	_Stream->Position = _Header->ArchiveOffset + Position;
+	_Stream->Write(Data, 0, Size);
+}
+
+void MpqLib::Mpq::CArchiveEditor::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff && (_Stream != nullptr))
+	{
+		_Stream->Close();
+		_Stream = nullptr;
+	}
+
+	if(_HashTable != NULL)
+	{
+		delete _HashTable;
+		_HashTable = NULL;
+	}
+
+	if(_BlockTable != NULL)
+	{
+		delete _BlockTable;
+		_BlockTable = NULL;
+	}
+
+	if(_HiBlockTable != NULL)
+	{
+		delete _HiBlockTable;
+		_HiBlockTable = NULL;
+	}
+}
@@ -0,0 +1,108 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+#include "TableEntries.h"
+#include "Cryptography.h"
+#include "ArchiveHeader.h"
+#include "FreeSpaceMap.h"
+#include "BlockEncoder.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Edits the tables of a closed archive directly on disk, for the changes StormLib
+		/// has no function for. Saving moves the tables to the end of the file data.
+		/// Tables are never written over the ones the header points to, the header is switched
+		/// to them once they are on disk. Blocks are not moved over the places those still point to either.
+		/// New data goes into the best-fitting hole of the committed tables, or past the end of the data.
+		/// Only the classic hash and block tables (version 1 and 2) are supported.
+		/// </summary>
+		private ref class CArchiveEditor
+		{
+			public:
+				CArchiveEditor(System::String^ FileName);
+				~CArchiveEditor();
+				!CArchiveEditor();
+
+				System::Int32 FindBlock(LPCSTR FileName, LCID Locale);
+				System::Boolean AddHashEntry(LPCSTR FileName, LCID Locale, DWORD BlockIndex);
+				System::Boolean RemoveHashEntry(LPCSTR FileName, LCID Locale);
+				System::Void ReplaceBlock(DWORD BlockIndex, array<System::Byte>^ FileData);
+				System::Int32 WriteBlock(LPCSTR FileName, LCID Locale, array<System::Byte>^ FileData, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize);
+				System::Boolean Compact(System::Int64 MaxBytesMoved);
+
+				System::Void Save();
+
+				property System::Int32 BlockTableSize { System::Int32 get(); }
+				property System::Int64 DataEnd { System::Int64 get(); }
+
+			private:
+				System::Int32 FindHashEntry(LPCSTR FileName, LCID Locale);
+				System::Boolean IsBlockUsed(DWORD BlockIndex);
+				DWORD AddBlockEntry();
+				System::Int64 GetBlockPosition(DWORD BlockIndex);
+				System::Void SetBlockPosition(DWORD BlockIndex, System::Int64 Position);
+				System::Collections::Generic::List<DWORD>^ SortBlocks();
+				System::Int32 CompareBlockPositions(DWORD BlockIndex1, DWORD BlockIndex2);
+				System::Void UpdateDataEnd();
+				System::Void MoveData(System::Int64 Position, System::Int64 NewPosition, DWORD Size);
+				System::Void MoveBlock(DWORD BlockIndex, System::Int64 NewPosition);
+				System::Void Commit();
+				System::Void WriteHeader(System::Int64 TablesPosition);
+				System::Boolean OverlapsTables(System::Int64 Position, System::Int64 Size);
+				System::Int64 GetFreePosition(System::Int64 Size);
+				System::Int64 AllocateSpace(System::Int64 Size);
+				System::Void UpdateFreeSpace();
+				System::Int64 GetTablesSize();
+
+				System::Void ReadData(System::Int64 Position, void* Buffer, System::Int32 Size);
+				System::Void WriteData(System::Int64 Position, const void* Buffer, System::Int32 Size);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				System::IO::FileStream^ _Stream;
+				CArchiveHeader^ _Header;
+				System::Int64 _DataEnd;
+				System::Int64 _CommittedDataEnd;
+				System::Int64 _TablesPosition;
+				System::Int64 _TablesEnd;
+				CFreeSpaceMap^ _FreeSpace;
+
+				std::vector<SHashEntry>* _HashTable;
+				std::vector<SBlockEntry>* _BlockTable;
+				std::vector<USHORT>* _HiBlockTable;
+		};
+	}
+}
@@ -49,6 +49,16 @@ namespace MpqLib
 			/// Represents later MPQ version (archive &gt; 4Gb).
 			/// </summary>
 			Version2,
+
+			/// <summary>
+			/// Represents MPQ version 3, indexing files with the bit-packed HET/BET tables.
+			/// </summary>
+			Version3,
+
+			/// <summary>
+			/// Represents MPQ version 4, HET/BET tables and MD5 checksums of the tables.
+			/// </summary>
+			Version4,
 		};
 	}
 }
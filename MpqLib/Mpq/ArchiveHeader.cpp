@@ -0,0 +1,167 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveHeader.h"
+
+MpqLib::Mpq::CArchiveHeader::CArchiveHeader(System::String^ FileName)
+{
+	_ArchiveOffset = CConstants::InvalidIndex;
+
+	System::IO::FileStream^ Stream = gcnew System::IO::FileStream(FileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite);
+
+	try
+	{
+		System::IO::BinaryReader^ Reader = gcnew System::IO::BinaryReader(Stream);
+
+		//The header may be preceded by other data (like a map header), it is always aligned to 512 bytes
+		for(System::Int64 Offset = 0; Offset + MPQ_HEADER_SIZE_V1 <= Stream->Length; Offset += 0x200)
+		{
+			Stream->Position = Offset;
+			System::UInt32 Id = Reader->ReadUInt32();
+
+			if(Id == ID_MPQ_USERDATA)
+			{
+				Reader->ReadUInt32();
+				System::UInt32 HeaderOffset = Reader->ReadUInt32();
+
+				Stream->Position = Offset + HeaderOffset;
+				if(Reader->ReadUInt32() != ID_MPQ) continue;
+
+				_ArchiveOffset = Offset + HeaderOffset;
+				break;
+			}
+
+			if(Id == ID_MPQ)
+			{
+				_ArchiveOffset = Offset;
+				break;
+			}
+		}
+
+		if(_ArchiveOffset == CConstants::InvalidIndex) throw gcnew System::IO::IOException("\"" + FileName + "\" is not an MPQ archive!");
+
+		Stream->Position = _ArchiveOffset + 4;
+		Read(Reader);
+	}
+	finally
+	{
+		Stream->Close();
+	}
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::ArchiveOffset::get()
+{
+	return _ArchiveOffset;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveHeader::HeaderSize::get()
+{
+	return static_cast<System::Int32>(_HeaderSize);
+}
+
+MpqLib::Mpq::EArchiveFormat MpqLib::Mpq::CArchiveHeader::Format::get()
+{
+	switch(_FormatVersion)
+	{
+	case MPQ_FORMAT_VERSION_1: return EArchiveFormat::Version1;
+	case MPQ_FORMAT_VERSION_2: return EArchiveFormat::Version2;
+	case MPQ_FORMAT_VERSION_3: return EArchiveFormat::Version3;
+	}
+
+	return EArchiveFormat::Version4;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveHeader::SectorSize::get()
+{
+	return (0x200 << _SectorSizeShift);
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::HashTablePosition::get()
+{
+	return _HashTablePosition;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::BlockTablePosition::get()
+{
+	return _BlockTablePosition;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::HiBlockTablePosition::get()
+{
+	return _HiBlockTablePosition;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::HetTablePosition::get()
+{
+	return _HetTablePosition;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveHeader::BetTablePosition::get()
+{
+	return _BetTablePosition;
+}
+
+System::UInt32 MpqLib::Mpq::CArchiveHeader::HashTableSize::get()
+{
+	return _HashTableSize;
+}
+
+System::UInt32 MpqLib::Mpq::CArchiveHeader::BlockTableSize::get()
+{
+	return _BlockTableSize;
+}
+
+System::Void MpqLib::Mpq::CArchiveHeader::Read(System::IO::BinaryReader^ Reader)
+{
+	//Table positions are stored relative to the header, in the version 1 layout followed by the later extensions
+	_HeaderSize = Reader->ReadUInt32();
+	Reader->ReadUInt32();
+	_FormatVersion = Reader->ReadUInt16();
+	_SectorSizeShift = Reader->ReadUInt16();
+	_HashTablePosition = Reader->ReadUInt32();
+	_BlockTablePosition = Reader->ReadUInt32();
+	_HashTableSize = Reader->ReadUInt32();
+	_BlockTableSize = Reader->ReadUInt32();
+
+	_HiBlockTablePosition = 0;
+	_HetTablePosition = 0;
+	_BetTablePosition = 0;
+
+	if((_FormatVersion < MPQ_FORMAT_VERSION_2) || (_HeaderSize < MPQ_HEADER_SIZE_V2)) return;
+
+	_HiBlockTablePosition = Reader->ReadInt64();
+	_HashTablePosition |= static_cast<System::Int64>(Reader->ReadUInt16()) << 32;
+	_BlockTablePosition |= static_cast<System::Int64>(Reader->ReadUInt16()) << 32;
+
+	if((_FormatVersion < MPQ_FORMAT_VERSION_3) || (_HeaderSize < MPQ_HEADER_SIZE_V3)) return;
+
+	Reader->ReadInt64();
+	_BetTablePosition = Reader->ReadInt64();
+	_HetTablePosition = Reader->ReadInt64();
+}
@@ -0,0 +1,75 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+#include "ArchiveFormat.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		private ref class CArchiveHeader
+		{
+			public:
+				CArchiveHeader(System::String^ FileName);
+
+				property System::Int64 ArchiveOffset { System::Int64 get(); }
+				property System::Int32 HeaderSize { System::Int32 get(); }
+				property EArchiveFormat Format { EArchiveFormat get(); }
+				property System::Int32 SectorSize { System::Int32 get(); }
+
+				property System::Int64 HashTablePosition { System::Int64 get(); }
+				property System::Int64 BlockTablePosition { System::Int64 get(); }
+				property System::Int64 HiBlockTablePosition { System::Int64 get(); }
+				property System::Int64 HetTablePosition { System::Int64 get(); }
+				property System::Int64 BetTablePosition { System::Int64 get(); }
+				property System::UInt32 HashTableSize { System::UInt32 get(); }
+				property System::UInt32 BlockTableSize { System::UInt32 get(); }
+
+			private:
+				System::Void Read(System::IO::BinaryReader^ Reader);
+
+			private:
+				System::Int64 _ArchiveOffset;
+				System::UInt32 _HeaderSize;
+				System::UInt16 _FormatVersion;
+				System::UInt16 _SectorSizeShift;
+
+				System::Int64 _HashTablePosition;
+				System::Int64 _BlockTablePosition;
+				System::Int64 _HiBlockTablePosition;
+				System::Int64 _HetTablePosition;
+				System::Int64 _BetTablePosition;
+				System::UInt32 _HashTableSize;
+				System::UInt32 _BlockTableSize;
+		};
+	}
+}
@@ -0,0 +1,540 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveIndex.h"
+
+MpqLib::Mpq::CArchiveIndex::CArchiveIndex(HANDLE ArchiveHandle, System::String^ ArchiveFileName, System::Boolean IsFlushed, System::Boolean Shared)
+{
+	_HashTable = new std::vector<SHashEntry>();
+	_BlockTable = new std::vector<SBlockEntry>();
+	_HiBlockTable = new std::vector<USHORT>();
+	_BlockReferences = new std::vector<System::Int32>();
+
+	_Segment = nullptr;
+	_SegmentView = nullptr;
+	_SegmentPointer = NULL;
+
+	_UsedHashEntryCount = 0;
+	_FileHashEntryCount = 0;
+	_HasSharedBlocks = false;
+	_DataEnd = 0;
+
+	//Tables with unflushed changes differ from the ones on disk, they are never shared
+	if(!Shared || !IsFlushed)
+	{
+		Build(ArchiveHandle, ArchiveFileName, IsFlushed);
+		Bind();
+		return;
+	}
+
+	//The lock keeps a second process from attaching to a segment that is still being filled
+	System::String^ SegmentName = GetSegmentName(ArchiveFileName);
+	System::Threading::Mutex^ SegmentLock = gcnew System::Threading::Mutex(false, SegmentName + ".Lock");
+
+	try
+	{
+		try
+		{
+			SegmentLock->WaitOne();
+		}
+		catch(System::Threading::AbandonedMutexException^)
+		{
+			//A process died while publishing, its segment went away with it
+		}
+
+		try
+		{
+			if(Attach(SegmentName)) return;
+
+			Build(ArchiveHandle, ArchiveFileName, IsFlushed);
+			Bind();
+
+			//An index that can not be published is simply kept private
+			try
+			{
+				Publish(SegmentName);
+			}
+			catch(System::IO::IOException^)
+			{
+				ReleaseSegment();
+			}
+			catch(System::UnauthorizedAccessException^)
+			{
+				ReleaseSegment();
+			}
+		}
+		finally
+		{
+			SegmentLock->ReleaseMutex();
+		}
+	}
+	finally
+	{
+		SegmentLock->Close();
+	}
+}
+
+MpqLib::Mpq::CArchiveIndex::~CArchiveIndex()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveIndex::!CArchiveIndex()
+{
+	Cleanup(false);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::FindHashEntry(LPCSTR FileName, LCID Locale)
+{
+	if(!IsAvailable) return CConstants::InvalidIndex;
+
+	DWORD Mask = _HashTableSize - 1;
+	DWORD Start = CCryptography::HashString(FileName, CCryptography::HashTypeTableOffset) & Mask;
+	DWORD Name1 = CCryptography::HashString(FileName, CCryptography::HashTypeNameA);
+	DWORD Name2 = CCryptography::HashString(FileName, CCryptography::HashTypeNameB);
+	System::Int32 LocaleIndex = CConstants::InvalidIndex;
+	System::Int32 NeutralIndex = CConstants::InvalidIndex;
+
+	//An exact locale match wins, otherwise the neutral version is used (same rule as StormLib)
+	for(DWORD i = Start; _HashEntries[i].BlockIndex != HASH_ENTRY_FREE; )
+	{
+		const SHashEntry& Entry = _HashEntries[i];
+
+		if(IsMatch(Entry, Name1, Name2))
+		{
+			if(Entry.Locale == Locale)
+			{
+				LocaleIndex = static_cast<System::Int32>(i);
+				break;
+			}
+
+			if((Entry.Locale == LANG_NEUTRAL) && (NeutralIndex == CConstants::InvalidIndex)) NeutralIndex = static_cast<System::Int32>(i);
+		}
+
+		i = (i + 1) & Mask;
+		if(i == Start) break;
+	}
+
+	//A discarded index is freed by the finalizer, it must not run while the tables are walked
+	System::GC::KeepAlive(this);
+
+	return (LocaleIndex != CConstants::InvalidIndex) ? LocaleIndex : NeutralIndex;
+}
+
+System::Collections::Generic::List<LCID>^ MpqLib::Mpq::CArchiveIndex::FindLocales(LPCSTR FileName)
+{
+	System::Collections::Generic::List<LCID>^ LocaleList = gcnew System::Collections::Generic::List<LCID>();
+	if(!IsAvailable) return LocaleList;
+
+	DWORD Mask = _HashTableSize - 1;
+	DWORD Start = CCryptography::HashString(FileName, CCryptography::HashTypeTableOffset) & Mask;
+	DWORD Name1 = CCryptography::HashString(FileName, CCryptography::HashTypeNameA);
+	DWORD Name2 = CCryptography::HashString(FileName, CCryptography::HashTypeNameB);
+
+	for(DWORD i = Start; _HashEntries[i].BlockIndex != HASH_ENTRY_FREE; )
+	{
+		const SHashEntry& Entry = _HashEntries[i];
+
+		if(IsMatch(Entry, Name1, Name2)) LocaleList->Add(Entry.Locale);
+
+		i = (i + 1) & Mask;
+		if(i == Start) break;
+	}
+
+	System::GC::KeepAlive(this);
+
+	return LocaleList;
+}
+
+MpqLib::Mpq::SHashEntry MpqLib::Mpq::CArchiveIndex::GetHashEntry(System::Int32 HashIndex)
+{
+	if((HashIndex < 0) || (static_cast<DWORD>(HashIndex) >= _HashTableSize)) throw gcnew System::ArgumentOutOfRangeException("HashIndex");
+
+	return _HashEntries[HashIndex];
+}
+
+MpqLib::Mpq::SBlockEntry MpqLib::Mpq::CArchiveIndex::GetBlockEntry(System::Int32 BlockIndex)
+{
+	if((BlockIndex < 0) || (static_cast<DWORD>(BlockIndex) >= _BlockTableSize)) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+
+	return _BlockEntries[BlockIndex];
+}
+
+System::Int64 MpqLib::Mpq::CArchiveIndex::GetBlockPosition(System::Int32 BlockIndex)
+{
+	System::Int64 Position = GetBlockEntry(BlockIndex).FilePosition;
+	if(static_cast<DWORD>(BlockIndex) < _HiBlockTableSize) Position |= static_cast<System::Int64>(_HiBlockEntries[BlockIndex]) << 32;
+
+	return Position;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::CountHashEntries(System::Int32 BlockIndex)
+{
+	if((BlockIndex < 0) || (static_cast<DWORD>(BlockIndex) >= _BlockTableSize)) return 0;
+
+	return _BlockReferenceCounts[BlockIndex];
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::IsAvailable::get()
+{
+	return (_HashTableSize > 0);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::IsShared::get()
+{
+	return (_Segment != nullptr);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::HashTableSize::get()
+{
+	return static_cast<System::Int32>(_HashTableSize);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::BlockTableSize::get()
+{
+	return static_cast<System::Int32>(_BlockTableSize);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::UsedHashEntryCount::get()
+{
+	return _UsedHashEntryCount;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveIndex::FileHashEntryCount::get()
+{
+	return _FileHashEntryCount;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::HasSharedBlocks::get()
+{
+	return _HasSharedBlocks;
+}
+
+System::Int64 MpqLib::Mpq::CArchiveIndex::DataEnd::get()
+{
+	return _DataEnd;
+}
+
+System::Void MpqLib::Mpq::CArchiveIndex::Build(HANDLE ArchiveHandle, System::String^ ArchiveFileName, System::Boolean IsFlushed)
+{
+	DWORD HashTableSize = 0;
+	DWORD BlockTableSize = 0;
+	DWORD LengthNeeded = 0;
+
+	//Archives using only HET/BET tables have no classic hash table, lookups are then left to StormLib
+	if(!SFileGetFileInfo(ArchiveHandle, SFILE_INFO_HASH_TABLE_SIZE, &HashTableSize, sizeof(DWORD), &LengthNeeded)) return;
+	if(!SFileGetFileInfo(ArchiveHandle, SFILE_INFO_BLOCK_TABLE_SIZE, &BlockTableSize, sizeof(DWORD), &LengthNeeded)) return;
+	if((HashTableSize == 0) || ((HashTableSize & (HashTableSize - 1)) != 0)) return;
+
+	_HashTable->resize(HashTableSize);
+	_BlockTable->resize(BlockTableSize);
+
+	if(!SFileGetFileInfo(ArchiveHandle, SFILE_INFO_HASH_TABLE, &((*_HashTable)[0]), HashTableSize * sizeof(SHashEntry), &LengthNeeded) ||
+	   ((BlockTableSize > 0) && !SFileGetFileInfo(ArchiveHandle, SFILE_INFO_BLOCK_TABLE, &((*_BlockTable)[0]), BlockTableSize * sizeof(SBlockEntry), &LengthNeeded)))
+	{
+		_HashTable->clear();
+		_BlockTable->clear();
+		return;
+	}
+
+	//StormLib only hands out the low words of the block positions, the high words of archives past 4 GB are read from disk.
+	//Until the next flush that table may already be overwritten by appended data, lookups are then left to StormLib.
+	if(!LoadHiBlockTable(ArchiveFileName, IsFlushed))
+	{
+		_HashTable->clear();
+		_BlockTable->clear();
+		return;
+	}
+
+	_BlockReferences->resize(BlockTableSize, 0);
+
+	//Deleted entries still lengthen the probe chains, so they count as used
+	for(std::vector<SHashEntry>::const_iterator i = _HashTable->begin(); i != _HashTable->end(); ++i)
+	{
+		if(i->BlockIndex == HASH_ENTRY_FREE) continue;
+
+		_UsedHashEntryCount++;
+		if(i->BlockIndex >= BlockTableSize) continue;
+
+		_FileHashEntryCount++;
+		if(++(*_BlockReferences)[i->BlockIndex] > 1) _HasSharedBlocks = true;
+	}
+
+	for(DWORD i = 0; i < BlockTableSize; i++)
+	{
+		const SBlockEntry& Block = (*_BlockTable)[i];
+		if((Block.Flags & MPQ_FILE_EXISTS) == 0) continue;
+
+		System::Int64 Position = Block.FilePosition;
+		if(i < _HiBlockTable->size()) Position |= static_cast<System::Int64>((*_HiBlockTable)[i]) << 32;
+
+		_DataEnd = System::Math::Max(_DataEnd, Position + Block.CompressedSize);
+	}
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::LoadHiBlockTable(System::String^ ArchiveFileName, System::Boolean IsFlushed)
+{
+	CArchiveHeader Header(ArchiveFileName);
+	if((Header.HiBlockTablePosition == 0) || _BlockTable->empty()) return true;
+	if(!IsFlushed) return false;
+
+	System::Int32 EntryCount = static_cast<System::Int32>(System::Math::Min(static_cast<System::UInt32>(_BlockTable->size()), Header.BlockTableSize));
+	array<System::Byte>^ Data = gcnew array<System::Byte>(EntryCount * static_cast<System::Int32>(sizeof(USHORT)));
+	System::IO::FileStream^ Stream = gcnew System::IO::FileStream(ArchiveFileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite);
+
+	try
+	{
+		Stream->Position = Header.ArchiveOffset + Header.HiBlockTablePosition;
+		for(System::Int32 Index = 0; Index < Data->Length; )
+		{
+			System::Int32 BytesRead = Stream->Read(Data, Index, Data->Length - Index);
+			if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The extended block table of \"" + ArchiveFileName + "\" is truncated!");
+
+			Index += BytesRead;
+		}
+	}
+	finally
+	{
+		Stream->Close();
+	}
+
+	_HiBlockTable->resize(_BlockTable->size(), 0);
+	if(EntryCount == 0) return true;
+
+	pin_ptr<System::Byte> DataPointer = &Data[0];
+	memcpy(&((*_HiBlockTable)[0]), DataPointer, Data->Length);
+
+	return true;
+}
+
+System::Void MpqLib::Mpq::CArchiveIndex::Bind()
+{
+	_HashTableSize = static_cast<DWORD>(_HashTable->size());
+	_BlockTableSize = static_cast<DWORD>(_BlockTable->size());
+	_HiBlockTableSize = static_cast<DWORD>(_HiBlockTable->size());
+
+	_HashEntries = _HashTable->empty() ? NULL : &((*_HashTable)[0]);
+	_BlockEntries = _BlockTable->empty() ? NULL : &((*_BlockTable)[0]);
+	_HiBlockEntries = _HiBlockTable->empty() ? NULL : &((*_HiBlockTable)[0]);
+	_BlockReferenceCounts = _BlockReferences->empty() ? NULL : &((*_BlockReferences)[0]);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::BindSegment()
+{
+	System::Byte* SegmentPointer = NULL;
+	_SegmentView->SafeMemoryMappedViewHandle->AcquirePointer(SegmentPointer);
+	_SegmentPointer = SegmentPointer;
+
+	//A segment of another layout (or a truncated or damaged one) is not used, the lookups rely on every size in it
+	if(static_cast<System::Int64>(sizeof(SIndexSegmentHeader)) > _SegmentView->Capacity) return false;
+
+	const SIndexSegmentHeader* Header = reinterpret_cast<const SIndexSegmentHeader*>(_SegmentPointer);
+	if(Header->Signature != CConstants::IndexSegmentSignature) return false;
+	if((Header->HashTableSize == 0) || ((Header->HashTableSize & (Header->HashTableSize - 1)) != 0)) return false;
+	if(Header->HiBlockTableSize > Header->BlockTableSize) return false;
+
+	System::Int64 SegmentSize = sizeof(SIndexSegmentHeader) + static_cast<System::Int64>(Header->HashTableSize) * sizeof(SHashEntry) + static_cast<System::Int64>(Header->BlockTableSize) * (sizeof(SBlockEntry) + sizeof(System::Int32)) + static_cast<System::Int64>(Header->HiBlockTableSize) * sizeof(USHORT);
+	if(SegmentSize > _SegmentView->Capacity) return false;
+
+	const System::Byte* Data = _SegmentPointer + sizeof(SIndexSegmentHeader);
+
+	_HashTableSize = Header->HashTableSize;
+	_BlockTableSize = Header->BlockTableSize;
+	_HiBlockTableSize = Header->HiBlockTableSize;
+
+	_HashEntries = reinterpret_cast<const SHashEntry*>(Data);
+	Data += _HashTableSize * sizeof(SHashEntry);
+	_BlockEntries = reinterpret_cast<const SBlockEntry*>(Data);
+	Data += _BlockTableSize * sizeof(SBlockEntry);
+	_BlockReferenceCounts = reinterpret_cast<const System::Int32*>(Data);
+	Data += _BlockTableSize * sizeof(System::Int32);
+	_HiBlockEntries = reinterpret_cast<const USHORT*>(Data);
+
+	_UsedHashEntryCount = Header->UsedHashEntryCount;
+	_FileHashEntryCount = Header->FileHashEntryCount;
+	_HasSharedBlocks = (Header->HasSharedBlocks != 0);
+	_DataEnd = Header->DataEnd;
+
+	return true;
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::Attach(System::String^ SegmentName)
+{
+	try
+	{
+		_Segment = System::IO::MemoryMappedFiles::MemoryMappedFile::OpenExisting(SegmentName, System::IO::MemoryMappedFiles::MemoryMappedFileRights::Read);
+	}
+	catch(System::IO::FileNotFoundException^)
+	{
+		return false;
+	}
+
+	_SegmentView = _Segment->CreateViewAccessor(0, 0, System::IO::MemoryMappedFiles::MemoryMappedFileAccess::Read);
+	if(BindSegment()) return true;
+
+	ReleaseSegment();
+
+	return false;
+}
+
+System::Void MpqLib::Mpq::CArchiveIndex::Publish(System::String^ SegmentName)
+{
+	System::Int64 SegmentSize = sizeof(SIndexSegmentHeader) + static_cast<System::Int64>(_HashTableSize) * sizeof(SHashEntry) + static_cast<System::Int64>(_BlockTableSize) * (sizeof(SBlockEntry) + sizeof(System::Int32)) + static_cast<System::Int64>(_HiBlockTableSize) * sizeof(USHORT);
+
+	_Segment = System::IO::MemoryMappedFiles::MemoryMappedFile::CreateNew(SegmentName, SegmentSize);
+	_SegmentView = _Segment->CreateViewAccessor(0, SegmentSize);
+
+	System::Byte* SegmentPointer = NULL;
+	_SegmentView->SafeMemoryMappedViewHandle->AcquirePointer(SegmentPointer);
+
+	try
+	{
+		SIndexSegmentHeader* Header = reinterpret_cast<SIndexSegmentHeader*>(SegmentPointer);
+		Header->Signature = CConstants::IndexSegmentSignature;
+		Header->HashTableSize = _HashTableSize;
+		Header->BlockTableSize = _BlockTableSize;
+		Header->HiBlockTableSize = _HiBlockTableSize;
+		Header->UsedHashEntryCount = _UsedHashEntryCount;
+		Header->FileHashEntryCount = _FileHashEntryCount;
+		Header->HasSharedBlocks = _HasSharedBlocks ? 1 : 0;
+		Header->Reserved = 0;
+		Header->DataEnd = _DataEnd;
+
+		System::Byte* Data = SegmentPointer + sizeof(SIndexSegmentHeader);
+
+		if(_HashTableSize > 0) memcpy(Data, _HashEntries, _HashTableSize * sizeof(SHashEntry));
+		Data += _HashTableSize * sizeof(SHashEntry);
+		if(_BlockTableSize > 0) memcpy(Data, _BlockEntries, _BlockTableSize * sizeof(SBlockEntry));
+		Data += _BlockTableSize * sizeof(SBlockEntry);
+		if(_BlockTableSize > 0) memcpy(Data, _BlockReferenceCounts, _BlockTableSize * sizeof(System::Int32));
+		Data += _BlockTableSize * sizeof(System::Int32);
+		if(_HiBlockTableSize > 0) memcpy(Data, _HiBlockEntries, _HiBlockTableSize * sizeof(USHORT));
+	}
+	finally
+	{
+		_SegmentView->SafeMemoryMappedViewHandle->ReleasePointer();
+	}
+
+	//From now on the private copy is not needed, this process reads the published tables like the others
+	BindSegment();
+
+	_HashTable->clear();
+	_HashTable->shrink_to_fit();
+	_BlockTable->clear();
+	_BlockTable->shrink_to_fit();
+	_HiBlockTable->clear();
+	_HiBlockTable->shrink_to_fit();
+	_BlockReferences->clear();
+	_BlockReferences->shrink_to_fit();
+}
+
+System::Void MpqLib::Mpq::CArchiveIndex::ReleaseSegment()
+{
+	if(_SegmentPointer != NULL)
+	{
+		_SegmentView->SafeMemoryMappedViewHandle->ReleasePointer();
+		_SegmentPointer = NULL;
+	}
+
+	if(_SegmentView != nullptr)
+	{
+		delete _SegmentView;
+		_SegmentView = nullptr;
+	}
+
+	if(_Segment != nullptr)
+	{
+		delete _Segment;
+		_Segment = nullptr;
+	}
+}
+
+System::Boolean MpqLib::Mpq::CArchiveIndex::IsMatch(const SHashEntry& Entry, DWORD Name1, DWORD Name2)
+{
+	if((Entry.Name1 != Name1) || (Entry.Name2 != Name2)) return false;
+	if(Entry.BlockIndex >= _BlockTableSize) return false;
+
+	return ((_BlockEntries[Entry.BlockIndex].Flags & MPQ_FILE_EXISTS) != 0);
+}
+
+System::String^ MpqLib::Mpq::CArchiveIndex::GetSegmentName(System::String^ ArchiveFileName)
+{
+	//The name changes along with the archive, a rewritten archive never meets the segment of its old tables
+	System::IO::FileInfo^ ArchiveFile = gcnew System::IO::FileInfo(ArchiveFileName);
+	CArchiveHeader Header(ArchiveFileName);
+	array<System::Byte>^ PathHash = System::Security::Cryptography::MD5::Create()->ComputeHash(System::Text::Encoding::UTF8->GetBytes(ArchiveFile->FullName->ToUpperInvariant()));
+
+	return System::String::Format("MpqLib.Index.{0}.{1:X}.{2:X}.{3:X}.{4:X}", System::BitConverter::ToString(PathHash)->Replace("-", ""), ArchiveFile->Length, ArchiveFile->LastWriteTimeUtc.Ticks, Header.HashTablePosition, Header.BlockTablePosition);
+}
+
+void MpqLib::Mpq::CArchiveIndex::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff)
+	{
+		ReleaseSegment();
+	}
+	else if(_SegmentPointer != NULL)
+	{
+		//Safe handles are finalized after this object, the view is still there to be released
+		_SegmentView->SafeMemoryMappedViewHandle->ReleasePointer();
+		_SegmentPointer = NULL;
+	}
+
+	_HashEntries = NULL;
+	_BlockEntries = NULL;
+	_HiBlockEntries = NULL;
+	_BlockReferenceCounts = NULL;
+	_HashTableSize = 0;
+	_BlockTableSize = 0;
+	_HiBlockTableSize = 0;
+
+	if(_HashTable != NULL)
+	{
+		delete _HashTable;
+		_HashTable = NULL;
+	}
+
+	if(_BlockTable != NULL)
+	{
+		delete _BlockTable;
+		_BlockTable = NULL;
+	}
+
+	if(_HiBlockTable != NULL)
+	{
+		delete _HiBlockTable;
+		_HiBlockTable = NULL;
+	}
+
+	if(_BlockReferences != NULL)
+	{
+		delete _BlockReferences;
+		_BlockReferences = NULL;
+	}
+}
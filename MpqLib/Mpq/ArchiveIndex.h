@@ -0,0 +1,126 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+#include "TableEntries.h"
+#include "Cryptography.h"
+#include "ArchiveHeader.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// The start of a shared index segment. It is followed by the hash table, the block table,
+		/// the number of hash entries per block and the high words of the block positions.
+		/// </summary>
+		struct SIndexSegmentHeader
+		{
+			DWORD Signature;
+			DWORD HashTableSize;
+			DWORD BlockTableSize;
+			DWORD HiBlockTableSize;
+			System::Int32 UsedHashEntryCount;
+			System::Int32 FileHashEntryCount;
+			System::Int32 HasSharedBlocks;
+			DWORD Reserved;
+			System::Int64 DataEnd;
+		};
+
+		/// <summary>
+		/// A snapshot of the hash and block tables of an open archive. Lookups probe
+		/// the hash table directly and collect every locale variant of a name in one pass,
+		/// so no process-wide locale has to be set to find a language specific file.
+		/// A shared index lives in a named memory segment, processes opening the same
+		/// unchanged archive attach to it instead of decoding the tables again.
+		/// </summary>
+		private ref class CArchiveIndex
+		{
+			public:
+				CArchiveIndex(HANDLE ArchiveHandle, System::String^ ArchiveFileName, System::Boolean IsFlushed, System::Boolean Shared);
+				~CArchiveIndex();
+				!CArchiveIndex();
+
+				System::Int32 FindHashEntry(LPCSTR FileName, LCID Locale);
+				System::Collections::Generic::List<LCID>^ FindLocales(LPCSTR FileName);
+
+				SHashEntry GetHashEntry(System::Int32 HashIndex);
+				SBlockEntry GetBlockEntry(System::Int32 BlockIndex);
+				System::Int64 GetBlockPosition(System::Int32 BlockIndex);
+				System::Int32 CountHashEntries(System::Int32 BlockIndex);
+
+				property System::Boolean IsAvailable { System::Boolean get(); }
+				property System::Boolean IsShared { System::Boolean get(); }
+				property System::Int32 HashTableSize { System::Int32 get(); }
+				property System::Int32 BlockTableSize { System::Int32 get(); }
+				property System::Int32 UsedHashEntryCount { System::Int32 get(); }
+				property System::Int32 FileHashEntryCount { System::Int32 get(); }
+				property System::Boolean HasSharedBlocks { System::Boolean get(); }
+				property System::Int64 DataEnd { System::Int64 get(); }
+
+			private:
+				System::Void Build(HANDLE ArchiveHandle, System::String^ ArchiveFileName, System::Boolean IsFlushed);
+				System::Boolean LoadHiBlockTable(System::String^ ArchiveFileName, System::Boolean IsFlushed);
+				System::Void Bind();
+				System::Boolean BindSegment();
+				System::Boolean Attach(System::String^ SegmentName);
+				System::Void Publish(System::String^ SegmentName);
+				System::Void ReleaseSegment();
+				System::Boolean IsMatch(const SHashEntry& Entry, DWORD Name1, DWORD Name2);
+				void Cleanup(bool CleanupManagedStuff);
+
+				static System::String^ GetSegmentName(System::String^ ArchiveFileName);
+
+			private:
+				std::vector<SHashEntry>* _HashTable;
+				std::vector<SBlockEntry>* _BlockTable;
+				std::vector<USHORT>* _HiBlockTable;
+				std::vector<System::Int32>* _BlockReferences;
+
+				const SHashEntry* _HashEntries;
+				const SBlockEntry* _BlockEntries;
+				const USHORT* _HiBlockEntries;
+				const System::Int32* _BlockReferenceCounts;
+				DWORD _HashTableSize;
+				DWORD _BlockTableSize;
+				DWORD _HiBlockTableSize;
+
+				System::IO::MemoryMappedFiles::MemoryMappedFile^ _Segment;
+				System::IO::MemoryMappedFiles::MemoryMappedViewAccessor^ _SegmentView;
+				System::Byte* _SegmentPointer;
+
+				System::Int32 _UsedHashEntryCount;
+				System::Int32 _FileHashEntryCount;
+				System::Boolean _HasSharedBlocks;
+				System::Int64 _DataEnd;
+		};
+	}
+}
@@ -0,0 +1,144 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveSnapshot.h"
+
+MpqLib::Mpq::CArchiveSnapshot::CArchiveSnapshot(CArchive^ Archive)
+{
+	_Archive = Archive;
+	_Index = Archive->Index;
+	_Attributes = nullptr;
+	_Files = gcnew System::Collections::Generic::Dictionary<System::String^, System::Int32>(System::StringComparer::OrdinalIgnoreCase);
+
+	_ArchiveOffset = Archive->Header->ArchiveOffset;
+	_RawStream = nullptr;
+
+	if(Archive->FileExists(CConstants::AttributesFileName, LANG_NEUTRAL))
+	{
+		_Attributes = gcnew CAttributes(Archive->ReadFile(CConstants::AttributesFileName, LANG_NEUTRAL), _Index->BlockTableSize);
+	}
+
+	//Unnamed blocks are listed under pseudo names, those do not resolve and are left out
+	for each(CFileInfo^ FileInfo in Archive->FindFiles("*"))
+	{
+		//The listfile and attributes are rewritten by every change, they would always show up as modified
+		if(IsSpecialFile(FileInfo->FileName)) continue;
+
+		System::Int32 BlockIndex = FindBlock(FileInfo->FileName);
+		if((BlockIndex == CConstants::InvalidIndex) && _Index->IsAvailable) continue;
+
+		_Files[FileInfo->FileName] = BlockIndex;
+	}
+}
+
+MpqLib::Mpq::CArchiveSnapshot::~CArchiveSnapshot()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveSnapshot::!CArchiveSnapshot()
+{
+	Cleanup(false);
+}
+
+System::Int32 MpqLib::Mpq::CArchiveSnapshot::FindBlock(System::String^ FileName)
+{
+	//Names waiting for the next flush read the block of the name they are linked to
+	LCID Locale = _Archive->Locale;
+	System::String^ StoredFileName = _Archive->ResolveFileName(FileName, Locale);
+
+	CStringHandle FileNameHandle(StoredFileName);
+
+	System::Int32 HashIndex = _Index->FindHashEntry(FileNameHandle.Value, Locale);
+	if(HashIndex == CConstants::InvalidIndex) return CConstants::InvalidIndex;
+
+	return static_cast<System::Int32>(_Index->GetHashEntry(HashIndex).BlockIndex);
+}
+
+System::Boolean MpqLib::Mpq::CArchiveSnapshot::IsSpecialFile(System::String^ FileName)
+{
+	if(System::String::Equals(FileName, CConstants::ListFileName, System::StringComparison::OrdinalIgnoreCase)) return true;
+	if(System::String::Equals(FileName, CConstants::AttributesFileName, System::StringComparison::OrdinalIgnoreCase)) return true;
+
+	return false;
+}
+
+MpqLib::Mpq::SBlockEntry MpqLib::Mpq::CArchiveSnapshot::GetBlockEntry(System::Int32 BlockIndex)
+{
+	return _Index->GetBlockEntry(BlockIndex);
+}
+
+System::Int64 MpqLib::Mpq::CArchiveSnapshot::GetBlockPosition(System::Int32 BlockIndex)
+{
+	return _ArchiveOffset + _Index->GetBlockPosition(BlockIndex);
+}
+
+System::Void MpqLib::Mpq::CArchiveSnapshot::ReadRaw(System::Int32 BlockIndex, System::Int64 Offset, array<System::Byte>^ Buffer, System::Int32 Size)
+{
+	if(_RawStream == nullptr) _RawStream = gcnew System::IO::FileStream(_Archive->FileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite);
+
+	_RawStream->Position = GetBlockPosition(BlockIndex) + Offset;
+
+	for(System::Int32 BufferIndex = 0; BufferIndex < Size; )
+	{
+		System::Int32 BytesRead = _RawStream->Read(Buffer, BufferIndex, Size - BufferIndex);
+		if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The block data of \"" + _Archive->FileName + "\" is truncated!");
+
+		BufferIndex += BytesRead;
+	}
+}
+
+MpqLib::Mpq::CArchive^ MpqLib::Mpq::CArchiveSnapshot::Archive::get()
+{
+	return _Archive;
+}
+
+MpqLib::Mpq::CArchiveIndex^ MpqLib::Mpq::CArchiveSnapshot::Index::get()
+{
+	return _Index;
+}
+
+MpqLib::Mpq::CAttributes^ MpqLib::Mpq::CArchiveSnapshot::Attributes::get()
+{
+	return _Attributes;
+}
+
+System::Collections::Generic::Dictionary<System::String^, System::Int32>^ MpqLib::Mpq::CArchiveSnapshot::Files::get()
+{
+	return _Files;
+}
+
+void MpqLib::Mpq::CArchiveSnapshot::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff && (_RawStream != nullptr))
+	{
+		_RawStream->Close();
+		_RawStream = nullptr;
+	}
+}
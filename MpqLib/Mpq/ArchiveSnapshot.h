@@ -0,0 +1,75 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Archive.h"
+#include "Attributes.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// The named files of an archive resolved to their blocks, along with the
+		/// block checksums and direct access to the stored (raw) block data.
+		/// Only valid as long as the archive is not modified.
+		/// </summary>
+		private ref class CArchiveSnapshot
+		{
+			public:
+				CArchiveSnapshot(CArchive^ Archive);
+				~CArchiveSnapshot();
+				!CArchiveSnapshot();
+
+				System::Int32 FindBlock(System::String^ FileName);
+				static System::Boolean IsSpecialFile(System::String^ FileName);
+				SBlockEntry GetBlockEntry(System::Int32 BlockIndex);
+				System::Int64 GetBlockPosition(System::Int32 BlockIndex);
+				System::Void ReadRaw(System::Int32 BlockIndex, System::Int64 Offset, array<System::Byte>^ Buffer, System::Int32 Size);
+
+				property CArchive^ Archive { CArchive^ get(); }
+				property CArchiveIndex^ Index { CArchiveIndex^ get(); }
+				property CAttributes^ Attributes { CAttributes^ get(); }
+				property System::Collections::Generic::Dictionary<System::String^, System::Int32>^ Files { System::Collections::Generic::Dictionary<System::String^, System::Int32>^ get(); }
+
+			private:
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				CArchive^ _Archive;
+				CArchiveIndex^ _Index;
+				CAttributes^ _Attributes;
+				System::Collections::Generic::Dictionary<System::String^, System::Int32>^ _Files;
+
+				System::Int64 _ArchiveOffset;
+				System::IO::FileStream^ _RawStream;
+		};
+	}
+}
@@ -0,0 +1,160 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveVerifier.h"
+
+MpqLib::Mpq::CArchiveVerifier::CArchiveVerifier(CArchive^ Archive)
+{
+	_Snapshot = gcnew CArchiveSnapshot(Archive);
+	_FileSize = (gcnew System::IO::FileInfo(Archive->FileName))->Length;
+
+	_FileNames = gcnew array<System::String^>(_Snapshot->Index->BlockTableSize);
+	_Blocks = gcnew System::Collections::Generic::List<System::Int32>();
+	_Errors = nullptr;
+	_WorkerCount = 0;
+
+	//Only neutral names open the right block through StormLib, other blocks are opened by pseudo name
+	for each(System::Collections::Generic::KeyValuePair<System::String^, System::Int32> File in _Snapshot->Files)
+	{
+		CStringHandle FileNameHandle(File.Key);
+
+		System::Int32 HashIndex = _Snapshot->Index->FindHashEntry(FileNameHandle.Value, LANG_NEUTRAL);
+		if(HashIndex == CConstants::InvalidIndex) continue;
+
+		SHashEntry HashEntry = _Snapshot->Index->GetHashEntry(HashIndex);
+		if((HashEntry.Locale == LANG_NEUTRAL) && (static_cast<System::Int32>(HashEntry.BlockIndex) == File.Value)) _FileNames[File.Value] = File.Key;
+	}
+
+	for(System::Int32 i = 0; i < _Snapshot->Index->BlockTableSize; i++)
+	{
+		if(_Snapshot->GetBlockEntry(i).Flags & MPQ_FILE_EXISTS) _Blocks->Add(i);
+	}
+}
+
+MpqLib::Mpq::CArchiveVerifier::~CArchiveVerifier()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveVerifier::!CArchiveVerifier()
+{
+	Cleanup(false);
+}
+
+MpqLib::Mpq::CVerifyReport^ MpqLib::Mpq::CArchiveVerifier::Verify()
+{
+	System::Collections::Generic::List<CVerifyEntry^>^ Entries = gcnew System::Collections::Generic::List<CVerifyEntry^>();
+
+	_Blocks->Sort(gcnew System::Comparison<System::Int32>(this, &CArchiveVerifier::ComparePositions));
+	_Errors = gcnew array<EVerifyError>(_Blocks->Count);
+
+	//Bounds are checked up front, blocks reaching past the end are not read at all
+	for(System::Int32 i = 0; i < _Blocks->Count; i++)
+	{
+		SBlockEntry BlockEntry = _Snapshot->GetBlockEntry(_Blocks[i]);
+		if((_Snapshot->GetBlockPosition(_Blocks[i]) + BlockEntry.CompressedSize) > _FileSize) _Errors[i] = EVerifyError::OutOfBounds;
+	}
+
+	_WorkerCount = System::Math::Max(1, System::Math::Min(System::Environment::ProcessorCount, _Blocks->Count));
+	System::Threading::Tasks::Parallel::For(0, _WorkerCount, gcnew System::Action<System::Int32>(this, &CArchiveVerifier::VerifyRange));
+
+	for(System::Int32 i = 0; i < _Blocks->Count; i++)
+	{
+		if(_Errors[i] != EVerifyError::None) Entries->Add(gcnew CVerifyEntry(GetFileName(_Blocks[i]), _Blocks[i], _Snapshot->GetBlockPosition(_Blocks[i]), _Errors[i]));
+	}
+
+	return gcnew CVerifyReport(_Blocks->Count, Entries);
+}
+
+System::Void MpqLib::Mpq::CArchiveVerifier::VerifyRange(System::Int32 WorkerIndex)
+{
+	System::Int32 Start = static_cast<System::Int32>(static_cast<System::Int64>(_Blocks->Count) * WorkerIndex / _WorkerCount);
+	System::Int32 End = static_cast<System::Int32>(static_cast<System::Int64>(_Blocks->Count) * (WorkerIndex + 1) / _WorkerCount);
+
+	//StormLib handles are not thread safe, every worker opens the archive on its own (read only)
+	HANDLE ArchiveHandle = NULL;
+	CStringHandle FileNameHandle(_Snapshot->Archive->FileName);
+
+	if(!SFileOpenArchive(FileNameHandle.Value, 0, BASE_PROVIDER_FILE | STREAM_FLAG_READ_ONLY, &ArchiveHandle))
+	{
+		for(System::Int32 i = Start; i < End; i++) _Errors[i] = _Errors[i] | EVerifyError::Unreadable;
+		return;
+	}
+
+	try
+	{
+		for(System::Int32 i = Start; i < End; i++)
+		{
+			if(_Errors[i] == EVerifyError::None) _Errors[i] = VerifyFile(ArchiveHandle, _Blocks[i]);
+		}
+	}
+	finally
+	{
+		SFileCloseArchive(ArchiveHandle);
+	}
+}
+
+MpqLib::Mpq::EVerifyError MpqLib::Mpq::CArchiveVerifier::VerifyFile(HANDLE ArchiveHandle, System::Int32 BlockIndex)
+{
+	//The key of an encrypted file is derived from its name, without one the block can only be bounds checked
+	if((_FileNames[BlockIndex] == nullptr) && (_Snapshot->GetBlockEntry(BlockIndex).Flags & MPQ_FILE_ENCRYPTED)) return EVerifyError::KeyUnknown;
+
+	CStringHandle FileNameHandle(GetFileName(BlockIndex));
+	EVerifyError Errors = EVerifyError::None;
+
+	DWORD Result = SFileVerifyFile(ArchiveHandle, FileNameHandle.Value, SFILE_VERIFY_SECTOR_CRC | SFILE_VERIFY_FILE_CRC | SFILE_VERIFY_FILE_MD5);
+
+	if(Result & (VERIFY_OPEN_ERROR | VERIFY_READ_ERROR)) Errors = Errors | EVerifyError::Unreadable;
+	if(Result & VERIFY_FILE_SECTOR_CRC_ERROR) Errors = Errors | EVerifyError::SectorCrcMismatch;
+	if(Result & VERIFY_FILE_CHECKSUM_ERROR) Errors = Errors | EVerifyError::Crc32Mismatch;
+	if(Result & VERIFY_FILE_MD5_ERROR) Errors = Errors | EVerifyError::Md5Mismatch;
+
+	return Errors;
+}
+
+System::Int32 MpqLib::Mpq::CArchiveVerifier::ComparePositions(System::Int32 BlockIndex1, System::Int32 BlockIndex2)
+{
+	return _Snapshot->GetBlockPosition(BlockIndex1).CompareTo(_Snapshot->GetBlockPosition(BlockIndex2));
+}
+
+System::String^ MpqLib::Mpq::CArchiveVerifier::GetFileName(System::Int32 BlockIndex)
+{
+	if(_FileNames[BlockIndex] != nullptr) return _FileNames[BlockIndex];
+
+	return System::String::Format("File{0:D8}.xxx", BlockIndex);
+}
+
+void MpqLib::Mpq::CArchiveVerifier::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff && (_Snapshot != nullptr))
+	{
+		delete _Snapshot;
+		_Snapshot = nullptr;
+	}
+}
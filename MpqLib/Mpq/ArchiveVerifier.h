@@ -0,0 +1,72 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "ArchiveSnapshot.h"
+#include "VerifyReport.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Verifies every block of an archive: bounds against the archive size, sector CRCs and
+		/// the "(attributes)" checksums. The blocks are sorted by position and split into one
+		/// contiguous range per core, each worker reading its range in order through its own handle.
+		/// </summary>
+		private ref class CArchiveVerifier
+		{
+			public:
+				CArchiveVerifier(CArchive^ Archive);
+				~CArchiveVerifier();
+				!CArchiveVerifier();
+
+				CVerifyReport^ Verify();
+
+			private:
+				System::Void VerifyRange(System::Int32 WorkerIndex);
+				EVerifyError VerifyFile(HANDLE ArchiveHandle, System::Int32 BlockIndex);
+
+				System::Int32 ComparePositions(System::Int32 BlockIndex1, System::Int32 BlockIndex2);
+				System::String^ GetFileName(System::Int32 BlockIndex);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				CArchiveSnapshot^ _Snapshot;
+				System::Int64 _FileSize;
+
+				array<System::String^>^ _FileNames;
+				System::Collections::Generic::List<System::Int32>^ _Blocks;
+				array<EVerifyError>^ _Errors;
+				System::Int32 _WorkerCount;
+		};
+	}
+}
@@ -0,0 +1,480 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ArchiveWriter.h"
+#include "SectorEncoder.h"
+
+MpqLib::Mpq::CArchiveWriter::CArchiveWriter(System::String^ FileName)
+{
+	Open(FileName, EArchiveFormat::Version2, CConstants::DefaultSectorSizeShift);
+}
+
+MpqLib::Mpq::CArchiveWriter::CArchiveWriter(System::String^ FileName, EArchiveFormat ArchiveFormat)
+{
+	Open(FileName, ArchiveFormat, CConstants::DefaultSectorSizeShift);
+}
+
+MpqLib::Mpq::CArchiveWriter::CArchiveWriter(System::String^ FileName, EArchiveFormat ArchiveFormat, System::UInt16 SectorSizeShift)
+{
+	Open(FileName, ArchiveFormat, SectorSizeShift);
+}
+
+MpqLib::Mpq::CArchiveWriter::~CArchiveWriter()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CArchiveWriter::!CArchiveWriter()
+{
+	Cleanup(false);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::Close()
+{
+	if(_Stream == nullptr) return;
+
+	try
+	{
+		//The listfile and the attributes cover the files added so far, so they go last
+		DWORD Flags = MPQ_FILE_EXISTS | MPQ_FILE_COMPRESS;
+
+		array<System::Byte>^ ListFileData = BuildListFile();
+		WriteBlock(CConstants::ListFileName, LANG_NEUTRAL, gcnew System::IO::MemoryStream(ListFileData, false), ListFileData->Length, Flags, MPQ_COMPRESSION_ZLIB, nullptr);
+
+		array<System::Byte>^ AttributesData = BuildAttributes();
+		WriteBlock(CConstants::AttributesFileName, LANG_NEUTRAL, gcnew System::IO::MemoryStream(AttributesData, false), AttributesData->Length, Flags, MPQ_COMPRESSION_ZLIB, nullptr);
+
+		WriteTables();
+	}
+	finally
+	{
+		_Stream->Close();
+		_Stream = nullptr;
+	}
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, System::String^ RealFileName)
+{
+	AddFile(FileName, RealFileName, ECompression::None, EEncryption::None);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression)
+{
+	AddFile(FileName, RealFileName, Compression, EEncryption::None);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression, EEncryption Encryption)
+{
+	AddFile(FileName, RealFileName, gcnew CCompressionOptions(Compression), Encryption);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, System::String^ RealFileName, CCompressionOptions^ Options, EEncryption Encryption)
+{
+	CheckBadState();
+
+	if(RealFileName == nullptr) throw gcnew System::ArgumentNullException("RealFileName");
+
+	//The file is read a chunk of sectors at a time, it never has to fit in memory as a whole
+	System::IO::FileStream^ RealFile = gcnew System::IO::FileStream(RealFileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::Read, CConstants::ExportBufferSize, System::IO::FileOptions::SequentialScan);
+
+	try
+	{
+		AddFile(FileName, RealFile, RealFile->Length, Options, Encryption);
+	}
+	finally
+	{
+		RealFile->Close();
+	}
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, array<System::Byte>^ FileData)
+{
+	AddFile(FileName, FileData, ECompression::None, EEncryption::None);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, array<System::Byte>^ FileData, ECompression Compression)
+{
+	AddFile(FileName, FileData, Compression, EEncryption::None);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, array<System::Byte>^ FileData, ECompression Compression, EEncryption Encryption)
+{
+	AddFile(FileName, FileData, gcnew CCompressionOptions(Compression), Encryption);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, array<System::Byte>^ FileData, CCompressionOptions^ Options, EEncryption Encryption)
+{
+	CheckBadState();
+
+	if(FileData == nullptr) throw gcnew System::ArgumentNullException("FileData");
+
+	AddFile(FileName, gcnew System::IO::MemoryStream(FileData, false), FileData->Length, Options, Encryption);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::AddFile(System::String^ FileName, System::IO::Stream^ Source, System::Int64 Length, CCompressionOptions^ Options, EEncryption Encryption)
+{
+	CheckBadState();
+
+	if(FileName == nullptr) throw gcnew System::ArgumentNullException("FileName");
+	if(Options == nullptr) throw gcnew System::ArgumentNullException("Options");
+
+	if((System::String::Compare(FileName, CConstants::ListFileName, true) == 0) || (System::String::Compare(FileName, CConstants::AttributesFileName, true) == 0))
+	{
+		throw gcnew System::ArgumentException("\"" + FileName + "\" is written by the archive writer itself!", "FileName");
+	}
+
+	//Names are hashed case insensitive and with either kind of slash
+	System::String^ Key = FileName->Replace('/', '\\')->ToUpperInvariant() + ":" + _Locale;
+	if(!_Keys->Add(Key)) throw gcnew System::ArgumentException("\"" + FileName + "\" has already been added!", "FileName");
+
+	DWORD Flags = (CArchive::BuildFileFlags(Options->Compression, Encryption) & ~MPQ_FILE_REPLACEEXISTING) | MPQ_FILE_EXISTS;
+
+	try
+	{
+		WriteBlock(FileName, _Locale, Source, Length, Flags, CArchive::BuildCompressionFlags(Options->Compression), Options);
+	}
+	catch(System::Exception^)
+	{
+		_Keys->Remove(Key);
+		throw;
+	}
+}
+
+System::Int32 MpqLib::Mpq::CArchiveWriter::FileCount::get()
+{
+	return _Keys->Count;
+}
+
+LCID MpqLib::Mpq::CArchiveWriter::Locale::get()
+{
+	return _Locale;
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::Locale::set(LCID Locale)
+{
+	_Locale = Locale;
+}
+
+System::String^ MpqLib::Mpq::CArchiveWriter::FileName::get()
+{
+	return _FileName;
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::Open(System::String^ FileName, EArchiveFormat ArchiveFormat, System::UInt16 SectorSizeShift)
+{
+	if((ArchiveFormat != EArchiveFormat::Version1) && (ArchiveFormat != EArchiveFormat::Version2)) throw gcnew System::ArgumentException("Only version 1 and 2 archives can be written!", "ArchiveFormat");
+	if(SectorSizeShift > CConstants::MaxSectorSizeShift) throw gcnew System::ArgumentOutOfRangeException("SectorSizeShift", "The sector size shift can be at most " + CConstants::MaxSectorSizeShift + "!");
+
+	_Stream = nullptr;
+	_FileName = FileName;
+	_ArchiveFormat = ArchiveFormat;
+	_SectorSizeShift = SectorSizeShift;
+	_SectorSize = 0x200 << SectorSizeShift;
+	_Locale = LANG_NEUTRAL;
+
+	_FileNames = gcnew System::Collections::Generic::List<System::String^>();
+	_Locales = gcnew System::Collections::Generic::List<LCID>();
+	_Keys = gcnew System::Collections::Generic::HashSet<System::String^>();
+	_Crc32s = gcnew System::Collections::Generic::List<System::UInt32>();
+	_Md5s = gcnew System::Collections::Generic::List<array<System::Byte>^>();
+	_Md5 = System::Security::Cryptography::MD5::Create();
+
+	_BlockTable = new std::vector<SBlockEntry>();
+	_HiBlockTable = new std::vector<USHORT>();
+
+	//The header is written last, its room is reserved up front
+	System::Int32 HeaderSize = (ArchiveFormat == EArchiveFormat::Version1) ? MPQ_HEADER_SIZE_V1 : MPQ_HEADER_SIZE_V2;
+	_Stream = gcnew System::IO::FileStream(FileName, System::IO::FileMode::Create, System::IO::FileAccess::Write, System::IO::FileShare::None, CConstants::ExportBufferSize, System::IO::FileOptions::SequentialScan);
+	_Stream->Write(gcnew array<System::Byte>(HeaderSize), 0, HeaderSize);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::WriteBlock(System::String^ FileName, LCID Locale, System::IO::Stream^ Source, System::Int64 Length, DWORD Flags, DWORD CompressionFlags, CCompressionOptions^ Options)
+{
+	System::Int64 Position = _Stream->Position;
+
+	if((Position > 0xFFFFFFFF) && (_ArchiveFormat == EArchiveFormat::Version1)) throw gcnew System::IO::IOException("The archive has grown too large for the version 1 format!");
+	if(_BlockTable->size() >= HASH_TABLE_SIZE_MAX) throw gcnew System::IO::IOException("The archive can not hold more than " + HASH_TABLE_SIZE_MAX + " files!");
+	if(Length > 0xFFFFFFFF) throw gcnew System::IO::IOException("\"" + FileName + "\" is too large to be stored in an archive!");
+
+	SBlockEntry BlockEntry;
+	BlockEntry.FilePosition = static_cast<DWORD>(Position);
+	BlockEntry.CompressedSize = 0;
+	BlockEntry.FileSize = static_cast<DWORD>(Length);
+	BlockEntry.Flags = Flags;
+
+	CStringHandle FileNameHandle(FileName);
+	DWORD Key = (Flags & MPQ_FILE_ENCRYPTED) ? CCryptography::GetFileKey(FileNameHandle.Value, BlockEntry) : 0;
+
+	System::Int32 Level = (Options != nullptr) ? Options->Level : 0;
+	System::Int32 DictionarySize = (Options != nullptr) ? Options->DictionarySize : 0;
+
+	//Compressed blocks start with the sector offset table, its room is reserved until the sectors are written
+	System::Int32 SectorCount = static_cast<System::Int32>((Length + _SectorSize - 1) / _SectorSize);
+	System::Boolean IsCompressed = ((Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) != 0);
+	DWORD OffsetTableSize = (IsCompressed && (SectorCount > 0)) ? (SectorCount + 1) * sizeof(DWORD) : 0;
+	std::vector<DWORD> OffsetTable(SectorCount + 1);
+	DWORD BlockSize = OffsetTableSize;
+	DWORD Crc32 = 0;
+	array<System::Byte>^ Md5 = nullptr;
+
+	//The file is encoded a chunk at a time, large chunks on the thread pool like whole blocks are
+	System::Int32 ChunkSectorCount = System::Math::Max(1, CConstants::ParallelEncodeMinSize / _SectorSize);
+	array<System::Byte>^ Chunk = gcnew array<System::Byte>(static_cast<System::Int32>(System::Math::Min(static_cast<System::Int64>(ChunkSectorCount) * _SectorSize, Length)));
+	std::vector<BYTE> EncodedChunk(Chunk->Length + 1);
+	std::vector<DWORD> SectorSizes(ChunkSectorCount);
+
+	try
+	{
+		_Md5->Initialize();
+		if(OffsetTableSize > 0) _Stream->Write(gcnew array<System::Byte>(OffsetTableSize), 0, OffsetTableSize);
+
+		for(System::Int32 FirstSector = 0; FirstSector < SectorCount; FirstSector += ChunkSectorCount)
+		{
+			System::Int32 ChunkSize = static_cast<System::Int32>(System::Math::Min(static_cast<System::Int64>(Chunk->Length), Length - static_cast<System::Int64>(FirstSector) * _SectorSize));
+			ReadChunk(Source, Chunk, ChunkSize);
+
+			pin_ptr<System::Byte> ChunkPointer = &Chunk[0];
+			Crc32 = CCryptography::Crc32(ChunkPointer, ChunkSize, Crc32);
+			_Md5->TransformBlock(Chunk, 0, ChunkSize, nullptr, 0);
+
+			CSectorEncoder Encoder(ChunkPointer, ChunkSize, &EncodedChunk[0], &SectorSizes[0], Flags, CompressionFlags, Level, DictionarySize, Key + FirstSector, _SectorSize);
+
+			if(IsCompressed && (ChunkSize >= CConstants::ParallelEncodeMinSize) && (System::Environment::ProcessorCount > 1))
+			{
+				System::Threading::Tasks::Parallel::For(0, Encoder.GroupCount, gcnew System::Action<System::Int32>(%Encoder, &CSectorEncoder::EncodeGroup));
+			}
+			else
+			{
+				for(System::Int32 i = 0; i < Encoder.GroupCount; i++) Encoder.EncodeGroup(i);
+			}
+
+			//Each sector was encoded into its own slot, they are moved together before being written
+			DWORD EncodedSize = 0;
+			System::Int32 ChunkSectors = (ChunkSize + _SectorSize - 1) / _SectorSize;
+
+			for(System::Int32 i = 0; i < ChunkSectors; i++)
+			{
+				DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize);
+
+				OffsetTable[FirstSector + i] = BlockSize + EncodedSize;
+				if(EncodedSize != SectorStart) memmove(&EncodedChunk[EncodedSize], &EncodedChunk[SectorStart], SectorSizes[i]);
+				EncodedSize += SectorSizes[i];
+			}
+
+			WriteData(&EncodedChunk[0], static_cast<System::Int32>(EncodedSize));
+			BlockSize += EncodedSize;
+		}
+
+		OffsetTable[SectorCount] = BlockSize;
+
+		if(OffsetTableSize > 0)
+		{
+			if(Flags & MPQ_FILE_ENCRYPTED) CCryptography::EncryptBlock(&OffsetTable[0], OffsetTableSize, Key - 1);
+
+			_Stream->Position = Position;
+			WriteData(&OffsetTable[0], static_cast<System::Int32>(OffsetTableSize));
+			_Stream->Position = Position + BlockSize;
+		}
+
+		_Md5->TransformFinalBlock(gcnew array<System::Byte>(0), 0, 0);
+		Md5 = _Md5->Hash;
+	}
+	catch(System::Exception^)
+	{
+		//The partly written block is cut off again, the archive stays as it was before the file
+		_Stream->SetLength(Position);
+		_Stream->Position = Position;
+		throw;
+	}
+
+	BlockEntry.CompressedSize = BlockSize;
+
+	_BlockTable->push_back(BlockEntry);
+	_HiBlockTable->push_back(static_cast<USHORT>(Position >> 32));
+	_FileNames->Add(FileName);
+	_Locales->Add(Locale);
+	_Crc32s->Add(Crc32);
+	_Md5s->Add(Md5);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::ReadChunk(System::IO::Stream^ Source, array<System::Byte>^ Chunk, System::Int32 Size)
+{
+	for(System::Int32 Offset = 0; Offset < Size; )
+	{
+		System::Int32 BytesRead = Source->Read(Chunk, Offset, Size - Offset);
+		if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The file ended before its expected size, it may have been changed while being added!");
+
+		Offset += BytesRead;
+	}
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::WriteTables()
+{
+	//The table is sized for the final number of files, so it never has to grow
+	DWORD HashTableSize = HASH_TABLE_SIZE_MIN;
+	while((HashTableSize < HASH_TABLE_SIZE_MAX) && (HashTableSize * CConstants::DefaultMaxHashTableLoadFactor < _BlockTable->size())) HashTableSize <<= 1;
+
+	std::vector<SHashEntry> HashTable(HashTableSize);
+	memset(&HashTable[0], 0xFF, HashTableSize * sizeof(SHashEntry));
+
+	for(System::Int32 i = 0; i < _FileNames->Count; i++)
+	{
+		CStringHandle FileNameHandle(_FileNames[i]);
+		DWORD Mask = HashTableSize - 1;
+		DWORD Index = CCryptography::HashString(FileNameHandle.Value, CCryptography::HashTypeTableOffset) & Mask;
+
+		while(HashTable[Index].BlockIndex != HASH_ENTRY_FREE) Index = (Index + 1) & Mask;
+
+		HashTable[Index].Name1 = CCryptography::HashString(FileNameHandle.Value, CCryptography::HashTypeNameA);
+		HashTable[Index].Name2 = CCryptography::HashString(FileNameHandle.Value, CCryptography::HashTypeNameB);
+		HashTable[Index].Locale = static_cast<USHORT>(_Locales[i]);
+		HashTable[Index].Platform = 0;
+		HashTable[Index].BlockIndex = static_cast<DWORD>(i);
+	}
+
+	System::Int64 HashTablePosition = _Stream->Position;
+	CCryptography::EncryptBlock(&HashTable[0], static_cast<DWORD>(HashTable.size() * sizeof(SHashEntry)), CCryptography::HashString("(hash table)", CCryptography::HashTypeFileKey));
+	WriteData(&HashTable[0], static_cast<System::Int32>(HashTable.size() * sizeof(SHashEntry)));
+
+	System::Int64 BlockTablePosition = _Stream->Position;
+	std::vector<SBlockEntry> BlockTable(*_BlockTable);
+	CCryptography::EncryptBlock(&BlockTable[0], static_cast<DWORD>(BlockTable.size() * sizeof(SBlockEntry)), CCryptography::HashString("(block table)", CCryptography::HashTypeFileKey));
+	WriteData(&BlockTable[0], static_cast<System::Int32>(BlockTable.size() * sizeof(SBlockEntry)));
+
+	//The high position words are only needed once the archive passes 4 GB
+	System::Int64 HiBlockTablePosition = 0;
+	if(_Stream->Position > 0xFFFFFFFF)
+	{
+		if(_ArchiveFormat == EArchiveFormat::Version1) throw gcnew System::IO::IOException("The archive has grown too large for the version 1 format!");
+
+		HiBlockTablePosition = _Stream->Position;
+		WriteData(&((*_HiBlockTable)[0]), static_cast<System::Int32>(_HiBlockTable->size() * sizeof(USHORT)));
+	}
+
+	WriteHeader(_Stream->Position, HashTablePosition, BlockTablePosition, HiBlockTablePosition, HashTableSize);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::WriteHeader(System::Int64 ArchiveSize, System::Int64 HashTablePosition, System::Int64 BlockTablePosition, System::Int64 HiBlockTablePosition, DWORD HashTableSize)
+{
+	System::Boolean IsVersion1 = (_ArchiveFormat == EArchiveFormat::Version1);
+	System::IO::BinaryWriter^ Writer = gcnew System::IO::BinaryWriter(_Stream);
+
+	_Stream->Position = 0;
+	Writer->Write(static_cast<System::UInt32>(ID_MPQ));
+	Writer->Write(static_cast<System::UInt32>(IsVersion1 ? MPQ_HEADER_SIZE_V1 : MPQ_HEADER_SIZE_V2));
+	Writer->Write(static_cast<System::UInt32>(ArchiveSize));
+	Writer->Write(static_cast<System::UInt16>(IsVersion1 ? MPQ_FORMAT_VERSION_1 : MPQ_FORMAT_VERSION_2));
+	Writer->Write(_SectorSizeShift);
+	Writer->Write(static_cast<System::UInt32>(HashTablePosition));
+	Writer->Write(static_cast<System::UInt32>(BlockTablePosition));
+	Writer->Write(static_cast<System::UInt32>(HashTableSize));
+	Writer->Write(static_cast<System::UInt32>(_BlockTable->size()));
+
+	if(!IsVersion1)
+	{
+		Writer->Write(HiBlockTablePosition);
+		Writer->Write(static_cast<System::UInt16>(HashTablePosition >> 32));
+		Writer->Write(static_cast<System::UInt16>(BlockTablePosition >> 32));
+	}
+
+	Writer->Flush();
+}
+
+array<System::Byte>^ MpqLib::Mpq::CArchiveWriter::BuildListFile()
+{
+	System::Text::StringBuilder^ Builder = gcnew System::Text::StringBuilder();
+	System::Collections::Generic::HashSet<System::String^>^ Names = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+
+	//Locale versions share a name, it is listed once
+	for each(System::String^ FileName in _FileNames)
+	{
+		if(Names->Add(FileName)) Builder->Append(FileName)->Append("\r\n");
+	}
+
+	return System::Text::Encoding::Default->GetBytes(Builder->ToString());
+}
+
+array<System::Byte>^ MpqLib::Mpq::CArchiveWriter::BuildAttributes()
+{
+	//One entry per block, the attributes block itself (added next) has no checksums
+	System::Int32 BlockCount = static_cast<System::Int32>(_BlockTable->size()) + 1;
+	array<System::Byte>^ FileData = gcnew array<System::Byte>(8 + BlockCount * (4 + 16));
+
+	System::Array::Copy(System::BitConverter::GetBytes(static_cast<System::UInt32>(MPQ_ATTRIBUTES_V1)), 0, FileData, 0, 4);
+	System::Array::Copy(System::BitConverter::GetBytes(static_cast<System::UInt32>(MPQ_ATTRIBUTE_CRC32 | MPQ_ATTRIBUTE_MD5)), 0, FileData, 4, 4);
+
+	CAttributes Attributes(FileData, BlockCount);
+	for(System::Int32 i = 0; i < _Crc32s->Count; i++)
+	{
+		Attributes.SetCrc32(i, _Crc32s[i]);
+		Attributes.SetMd5(i, _Md5s[i]);
+	}
+
+	return Attributes.FileData;
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::WriteData(const void* Data, System::Int32 Size)
+{
+	array<System::Byte>^ Buffer = gcnew array<System::Byte>(Size);
+	System::Runtime::InteropServices::Marshal::Copy(static_cast<System::IntPtr>(const_cast<void*>(Data)), Buffer, 0, Size);
+
+	_Stream->Write(Buffer, 0, Size);
+}
+
+System::Void MpqLib::Mpq::CArchiveWriter::CheckBadState()
+{
+	if(_Stream == nullptr) throw gcnew System::InvalidOperationException("The archive writer has been closed!");
+}
+
+void MpqLib::Mpq::CArchiveWriter::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff)
+	{
+		try
+		{
+			Close();
+		}
+		finally
+		{
+			delete _Md5;
+		}
+	}
+
+	if(_BlockTable != NULL)
+	{
+		delete _BlockTable;
+		_BlockTable = NULL;
+	}
+
+	if(_HiBlockTable != NULL)
+	{
+		delete _HiBlockTable;
+		_HiBlockTable = NULL;
+	}
+}
@@ -0,0 +1,199 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Archive.h"
+#include "Attributes.h"
+#include "BlockEncoder.h"
+#include "CompressionOptions.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Builds a new archive in a single pass. Each added file is compressed and written right after the
+		/// previous one, the hash and block tables are kept in memory and written (together with the listfile,
+		/// the attributes and the header) when the writer is closed. Only version 1 and 2 archives can be built.
+		/// </summary>
+		public ref class CArchiveWriter sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor, creates a version 2 archive.
+				/// </summary>
+				/// <param name="FileName">The archive to create (an existing file is overwritten)</param>
+				CArchiveWriter(System::String^ FileName);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The archive to create (an existing file is overwritten)</param>
+				/// <param name="ArchiveFormat">The format of the archive, version 1 or 2</param>
+				CArchiveWriter(System::String^ FileName, EArchiveFormat ArchiveFormat);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The archive to create (an existing file is overwritten)</param>
+				/// <param name="ArchiveFormat">The format of the archive, version 1 or 2</param>
+				/// <param name="SectorSizeShift">The sector size of the archive as a shift of 512 bytes (larger sectors compress better, smaller ones suit small random reads)</param>
+				CArchiveWriter(System::String^ FileName, EArchiveFormat ArchiveFormat, System::UInt16 SectorSizeShift);
+
+				/// <summary>
+				/// Completes the archive and releases all resources used by the MpqLib.Mpq.CArchiveWriter.
+				/// </summary>
+				~CArchiveWriter();
+
+				/// <summary>
+				/// Releases all resources used by the MpqLib.Mpq.CArchiveWriter.
+				/// </summary>
+				!CArchiveWriter();
+
+				/// <summary>
+				/// Completes the archive, writing the tables and the header, and closes it.
+				/// </summary>
+				System::Void Close();
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="RealFileName">The file to add</param>
+				System::Void AddFile(System::String^ FileName, System::String^ RealFileName);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="RealFileName">The file to add</param>
+				/// <param name="Compression">The compression to use</param>
+				System::Void AddFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="RealFileName">The file to add</param>
+				/// <param name="Compression">The compression to use</param>
+				/// <param name="Encryption">The encryption to use</param>
+				System::Void AddFile(System::String^ FileName, System::String^ RealFileName, ECompression Compression, EEncryption Encryption);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="RealFileName">The file to add</param>
+				/// <param name="Options">The compression (and codec parameters) to use</param>
+				/// <param name="Encryption">The encryption to use</param>
+				System::Void AddFile(System::String^ FileName, System::String^ RealFileName, CCompressionOptions^ Options, EEncryption Encryption);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="FileData">The file data to add</param>
+				System::Void AddFile(System::String^ FileName, array<System::Byte>^ FileData);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="FileData">The file data to add</param>
+				/// <param name="Compression">The compression to use</param>
+				System::Void AddFile(System::String^ FileName, array<System::Byte>^ FileData, ECompression Compression);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="FileData">The file data to add</param>
+				/// <param name="Compression">The compression to use</param>
+				/// <param name="Encryption">The encryption to use</param>
+				System::Void AddFile(System::String^ FileName, array<System::Byte>^ FileData, ECompression Compression, EEncryption Encryption);
+
+				/// <summary>
+				/// Adds a file to the archive.
+				/// </summary>
+				/// <param name="FileName">The filename to save as in the archive</param>
+				/// <param name="FileData">The file data to add</param>
+				/// <param name="Options">The compression (and codec parameters) to use</param>
+				/// <param name="Encryption">The encryption to use</param>
+				System::Void AddFile(System::String^ FileName, array<System::Byte>^ FileData, CCompressionOptions^ Options, EEncryption Encryption);
+
+				/// <summary>
+				/// Retrieves the number of files added.
+				/// </summary>
+				property System::Int32 FileCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Gets or sets the locale files are added in.
+				/// </summary>
+				property LCID Locale { LCID get(); System::Void set(LCID Locale); }
+
+				/// <summary>
+				/// Retrieves the filename of the archive.
+				/// </summary>
+				property System::String^ FileName { System::String^ get(); }
+
+			private:
+				System::Void Open(System::String^ FileName, EArchiveFormat ArchiveFormat, System::UInt16 SectorSizeShift);
+				System::Void AddFile(System::String^ FileName, System::IO::Stream^ Source, System::Int64 Length, CCompressionOptions^ Options, EEncryption Encryption);
+				System::Void WriteBlock(System::String^ FileName, LCID Locale, System::IO::Stream^ Source, System::Int64 Length, DWORD Flags, DWORD CompressionFlags, CCompressionOptions^ Options);
+				System::Void ReadChunk(System::IO::Stream^ Source, array<System::Byte>^ Chunk, System::Int32 Size);
+				System::Void WriteTables();
+				System::Void WriteHeader(System::Int64 ArchiveSize, System::Int64 HashTablePosition, System::Int64 BlockTablePosition, System::Int64 HiBlockTablePosition, DWORD HashTableSize);
+				array<System::Byte>^ BuildListFile();
+				array<System::Byte>^ BuildAttributes();
+				System::Void WriteData(const void* Data, System::Int32 Size);
+				System::Void CheckBadState();
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				System::IO::FileStream^ _Stream;
+				System::String^ _FileName;
+				EArchiveFormat _ArchiveFormat;
+				System::UInt16 _SectorSizeShift;
+				System::Int32 _SectorSize;
+				LCID _Locale;
+
+				System::Collections::Generic::List<System::String^>^ _FileNames;
+				System::Collections::Generic::List<LCID>^ _Locales;
+				System::Collections::Generic::HashSet<System::String^>^ _Keys;
+				System::Collections::Generic::List<System::UInt32>^ _Crc32s;
+				System::Collections::Generic::List<array<System::Byte>^>^ _Md5s;
+				System::Security::Cryptography::MD5^ _Md5;
+
+				std::vector<SBlockEntry>* _BlockTable;
+				std::vector<USHORT>* _HiBlockTable;
+		};
+	}
+}
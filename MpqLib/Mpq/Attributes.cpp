@@ -0,0 +1,138 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "Attributes.h"
+#include "Cryptography.h"
+
+MpqLib::Mpq::CAttributes::CAttributes(array<System::Byte>^ FileData, System::Int32 BlockTableSize)
+{
+	_FileData = FileData;
+	_Crc32Offset = 0;
+	_Crc32Count = 0;
+	_Md5Offset = 0;
+	_Md5Count = 0;
+
+	if(FileData->Length < 8) return;
+	if(System::BitConverter::ToUInt32(FileData, 0) != MPQ_ATTRIBUTES_V1) return;
+
+	//Each enabled attribute is an array with one entry per block, some archives leave out the last entries
+	System::UInt32 Flags = System::BitConverter::ToUInt32(FileData, 4);
+	System::Int32 Offset = 8;
+
+	if(Flags & MPQ_ATTRIBUTE_CRC32)
+	{
+		_Crc32Offset = Offset;
+		_Crc32Count = System::Math::Min(BlockTableSize, (FileData->Length - Offset) / 4);
+		Offset += BlockTableSize * 4;
+	}
+
+	if(Flags & MPQ_ATTRIBUTE_FILETIME)
+	{
+		Offset += BlockTableSize * 8;
+	}
+
+	if((Flags & MPQ_ATTRIBUTE_MD5) && (Offset < FileData->Length))
+	{
+		_Md5Offset = Offset;
+		_Md5Count = System::Math::Min(BlockTableSize, (FileData->Length - Offset) / 16);
+	}
+}
+
+System::Boolean MpqLib::Mpq::CAttributes::HasCrc32(System::Int32 BlockIndex)
+{
+	if((BlockIndex < 0) || (BlockIndex >= _Crc32Count)) return false;
+
+	//Entries that were never computed are left zero
+	return (System::BitConverter::ToUInt32(_FileData, _Crc32Offset + BlockIndex * 4) != 0);
+}
+
+System::Boolean MpqLib::Mpq::CAttributes::HasMd5(System::Int32 BlockIndex)
+{
+	if((BlockIndex < 0) || (BlockIndex >= _Md5Count)) return false;
+
+	for(System::Int32 i = 0; i < 16; i++)
+	{
+		if(_FileData[_Md5Offset + BlockIndex * 16 + i] != 0) return true;
+	}
+
+	return false;
+}
+
+System::UInt32 MpqLib::Mpq::CAttributes::GetCrc32(System::Int32 BlockIndex)
+{
+	if(!HasCrc32(BlockIndex)) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+
+	return System::BitConverter::ToUInt32(_FileData, _Crc32Offset + BlockIndex * 4);
+}
+
+System::String^ MpqLib::Mpq::CAttributes::GetMd5(System::Int32 BlockIndex)
+{
+	if(!HasMd5(BlockIndex)) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+
+	return System::BitConverter::ToString(_FileData, _Md5Offset + BlockIndex * 16, 16);
+}
+
+System::Void MpqLib::Mpq::CAttributes::SetCrc32(System::Int32 BlockIndex, System::UInt32 Crc32)
+{
+	if((BlockIndex < 0) || (BlockIndex >= _Crc32Count)) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+
+	System::Array::Copy(System::BitConverter::GetBytes(Crc32), 0, _FileData, _Crc32Offset + BlockIndex * 4, 4);
+}
+
+System::Void MpqLib::Mpq::CAttributes::SetMd5(System::Int32 BlockIndex, array<System::Byte>^ Md5)
+{
+	if((BlockIndex < 0) || (BlockIndex >= _Md5Count)) throw gcnew System::ArgumentOutOfRangeException("BlockIndex");
+	if(Md5->Length != 16) throw gcnew System::ArgumentException("An MD5 hash must be 16 bytes!");
+
+	System::Array::Copy(Md5, 0, _FileData, _Md5Offset + BlockIndex * 16, 16);
+}
+
+System::Void MpqLib::Mpq::CAttributes::SetChecksums(System::Int32 BlockIndex, array<System::Byte>^ FileData)
+{
+	//Blocks past the end of the stored arrays are left without checksums, like in the archives that leave them out
+	if((BlockIndex >= 0) && (BlockIndex < _Crc32Count))
+	{
+		System::UInt32 Crc32 = 0;
+
+		if(FileData->Length > 0)
+		{
+			pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+			Crc32 = CCryptography::Crc32(FileDataPointer, FileData->Length);
+		}
+
+		SetCrc32(BlockIndex, Crc32);
+	}
+
+	if((BlockIndex >= 0) && (BlockIndex < _Md5Count)) SetMd5(BlockIndex, System::Security::Cryptography::MD5::Create()->ComputeHash(FileData));
+}
+
+array<System::Byte>^ MpqLib::Mpq::CAttributes::FileData::get()
+{
+	return _FileData;
+}
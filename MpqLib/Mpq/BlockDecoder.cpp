@@ -0,0 +1,119 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "BlockDecoder.h"
+
+System::Boolean MpqLib::Mpq::CBlockDecoder::CanDecode(const SBlockEntry& BlockEntry, System::Boolean HasKey)
+{
+	if((BlockEntry.Flags & MPQ_FILE_EXISTS) == 0) return false;
+	if(BlockEntry.Flags & (MPQ_FILE_PATCH_FILE | MPQ_FILE_DELETE_MARKER)) return false;
+
+	return (HasKey || ((BlockEntry.Flags & MPQ_FILE_ENCRYPTED) == 0));
+}
+
+array<System::Byte>^ MpqLib::Mpq::CBlockDecoder::DecodeBlock(array<System::Byte>^ Data, System::Int32 Offset, const SBlockEntry& BlockEntry, DWORD Key, System::Int32 SectorSize)
+{
+	array<System::Byte>^ FileData = gcnew array<System::Byte>(BlockEntry.FileSize);
+	if(BlockEntry.FileSize == 0) return FileData;
+
+	if((BlockEntry.CompressedSize == 0) || (Offset < 0) || ((static_cast<System::Int64>(Offset) + BlockEntry.CompressedSize) > Data->Length)) throw gcnew System::IO::EndOfStreamException("The block is truncated!");
+
+	pin_ptr<System::Byte> DataPointer = &Data[Offset];
+	pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+
+	if(BlockEntry.Flags & MPQ_FILE_SINGLE_UNIT)
+	{
+		DecodeSector(DataPointer, BlockEntry.CompressedSize, FileDataPointer, BlockEntry.FileSize, BlockEntry.Flags, Key);
+		return FileData;
+	}
+
+	System::Int32 SectorCount = GetSectorCount(BlockEntry, SectorSize);
+
+	//Uncompressed files have no sector offset table, the sectors simply follow each other
+	if((BlockEntry.Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) == 0)
+	{
+		if(BlockEntry.CompressedSize < BlockEntry.FileSize) throw gcnew System::IO::EndOfStreamException("The block is truncated!");
+
+		for(System::Int32 i = 0; i < SectorCount; i++)
+		{
+			DWORD SectorStart = i * SectorSize;
+			DWORD SectorLength = System::Math::Min(static_cast<DWORD>(SectorSize), BlockEntry.FileSize - SectorStart);
+
+			DecodeSector(DataPointer + SectorStart, SectorLength, FileDataPointer + SectorStart, SectorLength, BlockEntry.Flags, Key + i);
+		}
+
+		return FileData;
+	}
+
+	DWORD OffsetTableSize = (SectorCount + 1) * sizeof(DWORD);
+	if(OffsetTableSize > BlockEntry.CompressedSize) throw gcnew System::IO::InvalidDataException("The sector offset table is corrupt!");
+
+	std::vector<DWORD> OffsetTable(SectorCount + 1);
+	memcpy(&OffsetTable[0], DataPointer, OffsetTableSize);
+	if(BlockEntry.Flags & MPQ_FILE_ENCRYPTED) CCryptography::DecryptBlock(&OffsetTable[0], OffsetTableSize, Key - 1);
+
+	for(System::Int32 i = 0; i < SectorCount; i++)
+	{
+		DWORD SectorStart = i * SectorSize;
+		DWORD SectorLength = System::Math::Min(static_cast<DWORD>(SectorSize), BlockEntry.FileSize - SectorStart);
+
+		if((OffsetTable[i + 1] < OffsetTable[i]) || (OffsetTable[i + 1] > BlockEntry.CompressedSize)) throw gcnew System::IO::InvalidDataException("The sector offset table is corrupt!");
+
+		DecodeSector(DataPointer + OffsetTable[i], OffsetTable[i + 1] - OffsetTable[i], FileDataPointer + SectorStart, SectorLength, BlockEntry.Flags, Key + i);
+	}
+
+	return FileData;
+}
+
+System::Void MpqLib::Mpq::CBlockDecoder::DecodeSector(BYTE* Data, DWORD DataSize, BYTE* Output, DWORD OutputSize, DWORD Flags, DWORD Key)
+{
+	//Decrypts in place, only whole dwords are encrypted
+	if(Flags & MPQ_FILE_ENCRYPTED) CCryptography::DecryptBlock(Data, DataSize, Key);
+
+	//Data that did not shrink when compressed is stored as is
+	if((DataSize >= OutputSize) || ((Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) == 0))
+	{
+		if(DataSize < OutputSize) throw gcnew System::IO::EndOfStreamException("The sector is truncated!");
+
+		memcpy(Output, Data, OutputSize);
+		return;
+	}
+
+	int OutputLength = static_cast<int>(OutputSize);
+	int Success = (Flags & MPQ_FILE_IMPLODE) ? SCompExplode(Output, &OutputLength, Data, static_cast<int>(DataSize)) : SCompDecompress(Output, &OutputLength, Data, static_cast<int>(DataSize));
+
+	if(!Success || (OutputLength != static_cast<int>(OutputSize))) throw gcnew System::IO::InvalidDataException("Unable to decompress the sector!");
+}
+
+System::Int32 MpqLib::Mpq::CBlockDecoder::GetSectorCount(const SBlockEntry& BlockEntry, System::Int32 SectorSize)
+{
+	if(BlockEntry.Flags & MPQ_FILE_SINGLE_UNIT) return 1;
+
+	return static_cast<System::Int32>((BlockEntry.FileSize + SectorSize - 1) / SectorSize);
+}
@@ -0,0 +1,53 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TableEntries.h"
+#include "Cryptography.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Decodes stored block data (decryption and decompression) without going through an
+		/// archive handle, so blocks read in bulk can be expanded on any thread.
+		/// </summary>
+		private ref class CBlockDecoder abstract sealed
+		{
+			public:
+				static System::Boolean CanDecode(const SBlockEntry& BlockEntry, System::Boolean HasKey);
+				static array<System::Byte>^ DecodeBlock(array<System::Byte>^ Data, System::Int32 Offset, const SBlockEntry& BlockEntry, DWORD Key, System::Int32 SectorSize);
+				static System::Void DecodeSector(BYTE* Data, DWORD DataSize, BYTE* Output, DWORD OutputSize, DWORD Flags, DWORD Key);
+
+				static System::Int32 GetSectorCount(const SBlockEntry& BlockEntry, System::Int32 SectorSize);
+		};
+	}
+}
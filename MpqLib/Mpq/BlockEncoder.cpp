@@ -0,0 +1,166 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "BlockEncoder.h"
+#include "SectorEncoder.h"
+
+array<System::Byte>^ MpqLib::Mpq::CBlockEncoder::EncodeBlock(array<System::Byte>^ FileData, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize, DWORD Key, System::Int32 SectorSize)
+{
+	DWORD FileSize = static_cast<DWORD>(FileData->Length);
+	if(FileSize == 0) return gcnew array<System::Byte>(0);
+
+	System::Int32 SectorCount = static_cast<System::Int32>((FileSize + SectorSize - 1) / SectorSize);
+	System::Boolean IsCompressed = ((Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) != 0);
+
+	//Compressed blocks start with the sector offset table, a sector never grows (it is stored as is instead)
+	DWORD OffsetTableSize = IsCompressed ? (SectorCount + 1) * sizeof(DWORD) : 0;
+	std::vector<BYTE> BlockData(OffsetTableSize + FileSize);
+	std::vector<DWORD> OffsetTable(SectorCount + 1);
+	pin_ptr<System::Byte> FileDataPointer = &FileData[0];
+
+	DWORD BlockSize = OffsetTableSize;
+
+	if(IsCompressed && (FileSize >= static_cast<DWORD>(CConstants::ParallelEncodeMinSize)) && (System::Environment::ProcessorCount > 1))
+	{
+		//Large blocks are encoded in sector groups on the thread pool, the encoded sectors are then moved together in order
+		std::vector<DWORD> SectorSizes(SectorCount);
+		CSectorEncoder Encoder(FileDataPointer, FileSize, &BlockData[OffsetTableSize], &SectorSizes[0], Flags, CompressionFlags, Level, DictionarySize, Key, SectorSize);
+		System::Threading::Tasks::Parallel::For(0, Encoder.GroupCount, gcnew System::Action<System::Int32>(%Encoder, &CSectorEncoder::EncodeGroup));
+
+		for(System::Int32 i = 0; i < SectorCount; i++)
+		{
+			DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(SectorSize);
+
+			OffsetTable[i] = BlockSize;
+			if(BlockSize != OffsetTableSize + SectorStart) memmove(&BlockData[BlockSize], &BlockData[OffsetTableSize + SectorStart], SectorSizes[i]);
+			BlockSize += SectorSizes[i];
+		}
+	}
+	else
+	{
+		for(System::Int32 i = 0; i < SectorCount; i++)
+		{
+			DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(SectorSize);
+			DWORD SectorLength = System::Math::Min(static_cast<DWORD>(SectorSize), FileSize - SectorStart);
+
+			OffsetTable[i] = BlockSize;
+			BlockSize += EncodeSector(FileDataPointer + SectorStart, SectorLength, &BlockData[BlockSize], Flags, CompressionFlags, Level, DictionarySize, Key + i);
+		}
+	}
+
+	OffsetTable[SectorCount] = BlockSize;
+
+	if(IsCompressed)
+	{
+		if(Flags & MPQ_FILE_ENCRYPTED) CCryptography::EncryptBlock(&OffsetTable[0], OffsetTableSize, Key - 1);
+		memcpy(&BlockData[0], &OffsetTable[0], OffsetTableSize);
+	}
+
+	array<System::Byte>^ EncodedData = gcnew array<System::Byte>(BlockSize);
+	System::Runtime::InteropServices::Marshal::Copy(static_cast<System::IntPtr>(&BlockData[0]), EncodedData, 0, EncodedData->Length);
+
+	return EncodedData;
+}
+
+DWORD MpqLib::Mpq::CBlockEncoder::EncodeSector(BYTE* Data, DWORD DataSize, BYTE* Output, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize, DWORD Key)
+{
+	DWORD OutputSize = DataSize;
+
+	if(Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS))
+	{
+		//The codecs need some room to fail in, data that does not shrink is stored as is
+		std::vector<BYTE> Buffer(DataSize + 0x100);
+		int BufferLength = static_cast<int>(Buffer.size());
+		System::Boolean Success = (Flags & MPQ_FILE_IMPLODE) ? (SCompImplode(&Buffer[0], &BufferLength, Data, static_cast<int>(DataSize)) != 0) : Compress(Data, DataSize, &Buffer[0], BufferLength, CompressionFlags, Level, DictionarySize);
+
+		if(Success && (BufferLength > 0) && (static_cast<DWORD>(BufferLength) < DataSize))
+		{
+			OutputSize = static_cast<DWORD>(BufferLength);
+			memcpy(Output, &Buffer[0], OutputSize);
+		}
+		else
+		{
+			memcpy(Output, Data, DataSize);
+		}
+	}
+	else
+	{
+		memcpy(Output, Data, DataSize);
+	}
+
+	//Only whole dwords are encrypted
+	if(Flags & MPQ_FILE_ENCRYPTED) CCryptography::EncryptBlock(Output, OutputSize, Key);
+
+	return OutputSize;
+}
+
+System::Boolean MpqLib::Mpq::CBlockEncoder::Compress(BYTE* Data, DWORD DataSize, BYTE* Output, int& OutputSize, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize)
+{
+	//StormLib runs its codecs with fixed settings, tuned ZLib and BZip2 streams are produced here (after the usual compression byte)
+	if((Level == 0) && (DictionarySize == 0))
+	{
+		return (SCompCompress(Output, &OutputSize, Data, static_cast<int>(DataSize), CompressionFlags, 0, 0) != 0);
+	}
+
+	if(CompressionFlags == MPQ_COMPRESSION_BZIP2) return CompressBZip2(Data, DataSize, Output, OutputSize, Level);
+	if(CompressionFlags != MPQ_COMPRESSION_ZLIB) throw gcnew System::NotSupportedException("Only ZLib and BZip2 can be run with other parameters!");
+
+	int WindowBits = MAX_WBITS;
+	if(DictionarySize != 0) for(WindowBits = 0; (1 << WindowBits) < DictionarySize; WindowBits++);
+
+	z_stream Stream;
+	memset(&Stream, 0, sizeof(z_stream));
+	if(deflateInit2(&Stream, (Level != 0) ? Level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, WindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+	Stream.next_in = Data;
+	Stream.avail_in = DataSize;
+	Stream.next_out = Output + 1;
+	Stream.avail_out = static_cast<uInt>(OutputSize - 1);
+
+	System::Boolean Success = (deflate(&Stream, Z_FINISH) == Z_STREAM_END);
+	deflateEnd(&Stream);
+	if(!Success) return false;
+
+	Output[0] = MPQ_COMPRESSION_ZLIB;
+	OutputSize = static_cast<int>(Stream.total_out) + 1;
+
+	return true;
+}
+
+System::Boolean MpqLib::Mpq::CBlockEncoder::CompressBZip2(BYTE* Data, DWORD DataSize, BYTE* Output, int& OutputSize, System::Int32 Level)
+{
+	//The level is the block size of BZip2 in units of 100 kB, StormLib always uses the largest one
+	unsigned int EncodedSize = static_cast<unsigned int>(OutputSize - 1);
+	if(BZ2_bzBuffToBuffCompress(reinterpret_cast<char*>(Output + 1), &EncodedSize, reinterpret_cast<char*>(Data), DataSize, Level, 0, 0) != BZ_OK) return false;
+
+	Output[0] = MPQ_COMPRESSION_BZIP2;
+	OutputSize = static_cast<int>(EncodedSize) + 1;
+
+	return true;
+}
@@ -0,0 +1,56 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TableEntries.h"
+#include "Cryptography.h"
+#include "zlib/zlib.h"
+#include "bzip2/bzlib.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Encodes file data into stored block data (compression and encryption), the
+		/// counterpart of CBlockDecoder for writing blocks without an archive handle.
+		/// </summary>
+		private ref class CBlockEncoder abstract sealed
+		{
+			public:
+				static array<System::Byte>^ EncodeBlock(array<System::Byte>^ FileData, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize, DWORD Key, System::Int32 SectorSize);
+				static DWORD EncodeSector(BYTE* Data, DWORD DataSize, BYTE* Output, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize, DWORD Key);
+
+			private:
+				static System::Boolean Compress(BYTE* Data, DWORD DataSize, BYTE* Output, int& OutputSize, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize);
+				static System::Boolean CompressBZip2(BYTE* Data, DWORD DataSize, BYTE* Output, int& OutputSize, System::Int32 Level);
+		};
+	}
+}
@@ -0,0 +1,176 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "BlockProbe.h"
+
+MpqLib::Mpq::CBlockProbe::CBlockProbe(System::String^ ArchiveFileName, System::Int32 SectorSize)
+{
+	_Stream = gcnew System::IO::FileStream(ArchiveFileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite, 0x1000);
+	_SectorSize = SectorSize;
+	_Length = _Stream->Length;
+}
+
+MpqLib::Mpq::CBlockProbe::~CBlockProbe()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CBlockProbe::!CBlockProbe()
+{
+	Cleanup(false);
+}
+
+MpqLib::Mpq::ECompression MpqLib::Mpq::CBlockProbe::ProbeCompression(LPCSTR FileName, const SBlockEntry& BlockEntry, System::Int64 Position)
+{
+	if(BlockEntry.Flags & MPQ_FILE_IMPLODE) return ECompression::Implode;
+	if(((BlockEntry.Flags & MPQ_FILE_COMPRESS) == 0) || (BlockEntry.CompressedSize == 0)) return ECompression::None;
+
+	//The key of an encrypted file is derived from its name, without one the data can not be inspected
+	if((BlockEntry.Flags & MPQ_FILE_ENCRYPTED) && (FileName == NULL)) return ECompression::None;
+
+	System::Boolean Encrypted = ((BlockEntry.Flags & MPQ_FILE_ENCRYPTED) != 0);
+	DWORD Key = Encrypted ? CCryptography::GetFileKey(FileName, BlockEntry) : 0;
+	DWORD DataSize = BlockEntry.CompressedSize;
+	BYTE Mask = 0;
+
+	//Patch files start with a patch header, the data follows it
+	if(BlockEntry.Flags & MPQ_FILE_PATCH_FILE)
+	{
+		array<System::Byte>^ Header = gcnew array<System::Byte>(4);
+		if(!Read(Position, Header, 4)) return ECompression::None;
+
+		DWORD HeaderSize = System::BitConverter::ToUInt32(Header, 0);
+		if(HeaderSize >= DataSize) return ECompression::None;
+
+		Position += HeaderSize;
+		DataSize -= HeaderSize;
+	}
+
+	if(BlockEntry.Flags & MPQ_FILE_SINGLE_UNIT)
+	{
+		if(BlockEntry.CompressedSize >= BlockEntry.FileSize) return ECompression::None;
+		if(!ReadMask(Position, DataSize, Encrypted, Key, Mask)) return ECompression::None;
+
+		return DecodeCompressionMask(Mask);
+	}
+
+	//Sectors that did not shrink are stored as is (without a mask), look for the first one that did
+	DWORD SectorCount = (BlockEntry.FileSize + _SectorSize - 1) / _SectorSize;
+	array<System::Byte>^ OffsetTable = gcnew array<System::Byte>((SectorCount + 1) * 4);
+	if(!Read(Position, OffsetTable, OffsetTable->Length)) return ECompression::None;
+
+	if(Encrypted)
+	{
+		pin_ptr<System::Byte> OffsetTablePointer = &OffsetTable[0];
+		CCryptography::DecryptBlock(OffsetTablePointer, OffsetTable->Length, Key - 1);
+	}
+
+	for(DWORD i = 0; i < SectorCount; i++)
+	{
+		DWORD SectorStart = System::BitConverter::ToUInt32(OffsetTable, i * 4);
+		DWORD SectorEnd = System::BitConverter::ToUInt32(OffsetTable, (i + 1) * 4);
+		DWORD SectorSize = System::Math::Min(static_cast<DWORD>(_SectorSize), BlockEntry.FileSize - i * _SectorSize);
+
+		if((SectorEnd <= SectorStart) || (SectorEnd > DataSize)) return ECompression::None;
+		if((SectorEnd - SectorStart) >= SectorSize) continue;
+
+		if(!ReadMask(Position + SectorStart, SectorEnd - SectorStart, Encrypted, Key + i, Mask)) return ECompression::None;
+
+		return DecodeCompressionMask(Mask);
+	}
+
+	return ECompression::None;
+}
+
+MpqLib::Mpq::ECompression MpqLib::Mpq::CBlockProbe::DecodeCompressionMask(BYTE Mask)
+{
+	switch(Mask)
+	{
+	case MPQ_COMPRESSION_HUFFMANN: return ECompression::Huffman;
+	case MPQ_COMPRESSION_ZLIB: return ECompression::ZLib;
+	case MPQ_COMPRESSION_PKWARE: return ECompression::PKWareDCL;
+	case MPQ_COMPRESSION_BZIP2: return ECompression::BZip2;
+	case MPQ_COMPRESSION_SPARSE: return ECompression::Sparse;
+	case MPQ_COMPRESSION_LZMA: return ECompression::LZMA;
+	case MPQ_COMPRESSION_ADPCM_MONO: return ECompression::ADPCM_MONO;
+	case MPQ_COMPRESSION_ADPCM_STEREO: return ECompression::ADPCM_STEREO;
+	case MPQ_COMPRESSION_ADPCM_MONO | MPQ_COMPRESSION_HUFFMANN: return ECompression::WaveMono;
+	case MPQ_COMPRESSION_ADPCM_STEREO | MPQ_COMPRESSION_HUFFMANN: return ECompression::WaveStereo;
+	}
+
+	//Combined masks (such as sparse followed by zlib) are named after the strongest compression
+	if(Mask & MPQ_COMPRESSION_BZIP2) return ECompression::BZip2;
+	if(Mask & MPQ_COMPRESSION_ZLIB) return ECompression::ZLib;
+	if(Mask & MPQ_COMPRESSION_PKWARE) return ECompression::PKWareDCL;
+	if(Mask & MPQ_COMPRESSION_SPARSE) return ECompression::Sparse;
+
+	return ECompression::None;
+}
+
+System::Boolean MpqLib::Mpq::CBlockProbe::Read(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Size)
+{
+	if((Position < 0) || ((Position + Size) > _Length)) return false;
+
+	_Stream->Position = Position;
+	for(System::Int32 Index = 0; Index < Size; )
+	{
+		System::Int32 BytesRead = _Stream->Read(Buffer, Index, Size - Index);
+		if(BytesRead <= 0) return false;
+
+		Index += BytesRead;
+	}
+
+	return true;
+}
+
+System::Boolean MpqLib::Mpq::CBlockProbe::ReadMask(System::Int64 Position, DWORD Size, System::Boolean Encrypted, DWORD Key, BYTE& Mask)
+{
+	//Only whole dwords are encrypted, so the first one is needed to decrypt the mask
+	array<System::Byte>^ Data = gcnew array<System::Byte>(4);
+	System::Int32 ReadSize = static_cast<System::Int32>(System::Math::Min(Size, static_cast<DWORD>(4)));
+	if(!Read(Position, Data, ReadSize)) return false;
+
+	if(Encrypted && (ReadSize == 4))
+	{
+		pin_ptr<System::Byte> DataPointer = &Data[0];
+		CCryptography::DecryptBlock(DataPointer, 4, Key);
+	}
+
+	Mask = Data[0];
+	return true;
+}
+
+void MpqLib::Mpq::CBlockProbe::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff && (_Stream != nullptr))
+	{
+		_Stream->Close();
+		_Stream = nullptr;
+	}
+}
@@ -0,0 +1,67 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TableEntries.h"
+#include "Cryptography.h"
+#include "Compression.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Inspects the stored data of blocks without decompressing them, reading only
+		/// the sector offset table and the compression mask of the first compressed sector.
+		/// </summary>
+		private ref class CBlockProbe
+		{
+			public:
+				CBlockProbe(System::String^ ArchiveFileName, System::Int32 SectorSize);
+				~CBlockProbe();
+				!CBlockProbe();
+
+				ECompression ProbeCompression(LPCSTR FileName, const SBlockEntry& BlockEntry, System::Int64 Position);
+
+				static ECompression DecodeCompressionMask(BYTE Mask);
+
+			private:
+				System::Boolean Read(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Size);
+				System::Boolean ReadMask(System::Int64 Position, DWORD Size, System::Boolean Encrypted, DWORD Key, BYTE& Mask);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				System::IO::FileStream^ _Stream;
+				System::Int32 _SectorSize;
+				System::Int64 _Length;
+		};
+	}
+}
@@ -0,0 +1,276 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "BufferPool.h"
+
+MpqLib::Mpq::CBufferPool::CBufferPool()
+{
+	_MaxPooledSize = CConstants::DefaultMaxPooledSize;
+	_PooledSize = 0;
+	_RentCount = 0;
+	_HitCount = 0;
+	_AllocationCount = 0;
+	_AllocatedSize = 0;
+
+	_Buffers = new std::vector<std::vector<std::vector<System::Byte>*> >(CConstants::BufferPoolMaxClassShift - CConstants::BufferPoolMinClassShift + 1);
+	_Arrays = gcnew array<System::Collections::Generic::Stack<array<System::Byte>^>^>(CConstants::BufferPoolMaxClassShift - CConstants::BufferPoolMinClassShift + 1);
+	for(System::Int32 i = 0; i < _Arrays->Length; i++) _Arrays[i] = gcnew System::Collections::Generic::Stack<array<System::Byte>^>();
+	_Lock = gcnew System::Object();
+}
+
+MpqLib::Mpq::CBufferPool::CBufferPool(System::Int64 MaxPooledSize)
+{
+	if(MaxPooledSize < 0) throw gcnew System::ArgumentOutOfRangeException("MaxPooledSize", "The pool size can not be negative!");
+
+	_MaxPooledSize = MaxPooledSize;
+	_PooledSize = 0;
+	_RentCount = 0;
+	_HitCount = 0;
+	_AllocationCount = 0;
+	_AllocatedSize = 0;
+
+	_Buffers = new std::vector<std::vector<std::vector<System::Byte>*> >(CConstants::BufferPoolMaxClassShift - CConstants::BufferPoolMinClassShift + 1);
+	_Arrays = gcnew array<System::Collections::Generic::Stack<array<System::Byte>^>^>(CConstants::BufferPoolMaxClassShift - CConstants::BufferPoolMinClassShift + 1);
+	for(System::Int32 i = 0; i < _Arrays->Length; i++) _Arrays[i] = gcnew System::Collections::Generic::Stack<array<System::Byte>^>();
+	_Lock = gcnew System::Object();
+}
+
+MpqLib::Mpq::CBufferPool::~CBufferPool()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CBufferPool::!CBufferPool()
+{
+	Cleanup(false);
+}
+
+System::Void MpqLib::Mpq::CBufferPool::Trim()
+{
+	msclr::lock Lock(_Lock);
+
+	if(_Buffers == NULL) return;
+
+	for(std::size_t i = 0; i < _Buffers->size(); i++)
+	{
+		for(std::size_t j = 0; j < (*_Buffers)[i].size(); j++) delete (*_Buffers)[i][j];
+		(*_Buffers)[i].clear();
+	}
+
+	for(System::Int32 i = 0; i < _Arrays->Length; i++) _Arrays[i]->Clear();
+
+	_PooledSize = 0;
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::MaxPooledSize::get()
+{
+	return _MaxPooledSize;
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::PooledSize::get()
+{
+	return System::Threading::Interlocked::Read(_PooledSize);
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::RentCount::get()
+{
+	return System::Threading::Interlocked::Read(_RentCount);
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::HitCount::get()
+{
+	return System::Threading::Interlocked::Read(_HitCount);
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::AllocationCount::get()
+{
+	return System::Threading::Interlocked::Read(_AllocationCount);
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::AllocatedSize::get()
+{
+	return System::Threading::Interlocked::Read(_AllocatedSize);
+}
+
+std::vector<System::Byte>* MpqLib::Mpq::CBufferPool::Rent(System::Int32 Size)
+{
+	System::Int32 Class = GetRentClass(Size);
+	System::Int64 Capacity = GetRentSize(Size);
+	std::vector<System::Byte>* Buffer = NULL;
+
+	{
+		msclr::lock Lock(_Lock);
+
+		if((_Buffers != NULL) && (Class >= 0) && !(*_Buffers)[Class].empty())
+		{
+			Buffer = (*_Buffers)[Class].back();
+			(*_Buffers)[Class].pop_back();
+			_PooledSize -= static_cast<System::Int64>(Buffer->capacity());
+		}
+
+		CountRent(Buffer != NULL, Capacity);
+	}
+
+	if(Buffer == NULL)
+	{
+		Buffer = new std::vector<System::Byte>();
+		Buffer->reserve(static_cast<std::size_t>(Capacity));
+	}
+
+	//The capacity is kept, resizing within it does not allocate
+	Buffer->resize(static_cast<std::size_t>(Size));
+
+	return Buffer;
+}
+
+System::Void MpqLib::Mpq::CBufferPool::Return(std::vector<System::Byte>* Buffer)
+{
+	if(Buffer == NULL) return;
+
+	System::Int32 Class = GetReturnClass(static_cast<System::Int64>(Buffer->capacity()));
+
+	{
+		msclr::lock Lock(_Lock);
+
+		if((_Buffers != NULL) && (Class >= 0) && TryPool(static_cast<System::Int64>(Buffer->capacity())))
+		{
+			Buffer->clear();
+			(*_Buffers)[Class].push_back(Buffer);
+			return;
+		}
+	}
+
+	delete Buffer;
+}
+
+array<System::Byte>^ MpqLib::Mpq::CBufferPool::RentArray(System::Int32 Size)
+{
+	System::Int32 Class = GetRentClass(Size);
+	System::Int64 Capacity = GetRentSize(Size);
+	array<System::Byte>^ Buffer = nullptr;
+
+	{
+		msclr::lock Lock(_Lock);
+
+		if((Class >= 0) && (_Arrays[Class]->Count > 0))
+		{
+			Buffer = _Arrays[Class]->Pop();
+			_PooledSize -= Buffer->Length;
+		}
+
+		CountRent(Buffer != nullptr, Capacity);
+	}
+
+	//Pooled arrays are at least as long as requested, not exactly as long
+	return (Buffer != nullptr) ? Buffer : gcnew array<System::Byte>(static_cast<System::Int32>(Capacity));
+}
+
+System::Void MpqLib::Mpq::CBufferPool::ReturnArray(array<System::Byte>^ Buffer)
+{
+	if(Buffer == nullptr) return;
+
+	System::Int32 Class = GetReturnClass(Buffer->Length);
+	if((Class < 0) || ((1LL << (CConstants::BufferPoolMinClassShift + Class)) != Buffer->Length)) return;
+
+	msclr::lock Lock(_Lock);
+
+	if(TryPool(Buffer->Length)) _Arrays[Class]->Push(Buffer);
+}
+
+System::Int64 MpqLib::Mpq::CBufferPool::GetRentSize(System::Int32 Size)
+{
+	//A rented buffer is as large as its class, that is what it keeps allocated
+	System::Int32 Class = GetRentClass(Size);
+	return (Class >= 0) ? (1LL << (CConstants::BufferPoolMinClassShift + Class)) : Size;
+}
+
+System::Void MpqLib::Mpq::CBufferPool::CountRent(System::Boolean Hit, System::Int64 Size)
+{
+	_RentCount++;
+
+	if(Hit)
+	{
+		_HitCount++;
+	}
+	else
+	{
+		_AllocationCount++;
+		_AllocatedSize += Size;
+	}
+}
+
+System::Boolean MpqLib::Mpq::CBufferPool::TryPool(System::Int64 Size)
+{
+	if(_PooledSize > (_MaxPooledSize - Size)) return false;
+
+	_PooledSize += Size;
+	return true;
+}
+
+System::Int32 MpqLib::Mpq::CBufferPool::GetRentClass(System::Int64 Size)
+{
+	//The smallest class holding the size, larger requests are not pooled
+	if(Size > (1LL << CConstants::BufferPoolMaxClassShift)) return -1;
+
+	System::Int32 Class = 0;
+	while((1LL << (CConstants::BufferPoolMinClassShift + Class)) < Size) Class++;
+
+	return Class;
+}
+
+System::Int32 MpqLib::Mpq::CBufferPool::GetReturnClass(System::Int64 Size)
+{
+	//The largest class the size can serve
+	if((Size < (1LL << CConstants::BufferPoolMinClassShift)) || (Size > (1LL << CConstants::BufferPoolMaxClassShift))) return -1;
+
+	System::Int32 Class = 0;
+	while((1LL << (CConstants::BufferPoolMinClassShift + Class + 1)) <= Size) Class++;
+
+	return Class;
+}
+
+void MpqLib::Mpq::CBufferPool::Cleanup(bool CleanupManagedStuff)
+{
+	if(_Buffers != NULL)
+	{
+		for(std::size_t i = 0; i < _Buffers->size(); i++)
+		{
+			for(std::size_t j = 0; j < (*_Buffers)[i].size(); j++) delete (*_Buffers)[i][j];
+		}
+
+		delete _Buffers;
+		_Buffers = NULL;
+	}
+
+	if(CleanupManagedStuff)
+	{
+		for(System::Int32 i = 0; i < _Arrays->Length; i++) _Arrays[i]->Clear();
+		_PooledSize = 0;
+	}
+}
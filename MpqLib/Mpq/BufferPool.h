@@ -0,0 +1,132 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// A pool of reusable buffers in power of two size classes, shared by the file stream caches and
+		/// the export buffers of an archive. Returned buffers are kept (up to a limit) for the next request,
+		/// so repeated open-read-close cycles stop allocating once the pool has warmed up.
+		/// </summary>
+		public ref class CBufferPool sealed
+		{
+			public:
+				/// <summary>
+				/// Default constructor.
+				/// </summary>
+				CBufferPool();
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="MaxPooledSize">The maximum number of bytes kept in idle buffers</param>
+				CBufferPool(System::Int64 MaxPooledSize);
+
+				/// <summary>
+				/// Destructor.
+				/// </summary>
+				~CBufferPool();
+
+				/// <summary>
+				/// Finalizer.
+				/// </summary>
+				!CBufferPool();
+
+				/// <summary>
+				/// Releases all idle buffers.
+				/// </summary>
+				System::Void Trim();
+
+				/// <summary>
+				/// Retrieves the maximum number of bytes kept in idle buffers.
+				/// </summary>
+				property System::Int64 MaxPooledSize { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of bytes currently kept in idle buffers.
+				/// </summary>
+				property System::Int64 PooledSize { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of buffers handed out.
+				/// </summary>
+				property System::Int64 RentCount { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of buffers handed out from the pool (without allocating).
+				/// </summary>
+				property System::Int64 HitCount { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of buffers allocated because the pool had none to give.
+				/// </summary>
+				property System::Int64 AllocationCount { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the number of bytes allocated because the pool had no buffer to give.
+				/// </summary>
+				property System::Int64 AllocatedSize { System::Int64 get(); }
+
+			internal:
+				std::vector<System::Byte>* Rent(System::Int32 Size);
+				System::Void Return(std::vector<System::Byte>* Buffer);
+				array<System::Byte>^ RentArray(System::Int32 Size);
+				System::Void ReturnArray(array<System::Byte>^ Buffer);
+
+				static System::Int64 GetRentSize(System::Int32 Size);
+
+			private:
+				System::Void CountRent(System::Boolean Hit, System::Int64 Size);
+				System::Boolean TryPool(System::Int64 Size);
+
+				static System::Int32 GetRentClass(System::Int64 Size);
+				static System::Int32 GetReturnClass(System::Int64 Size);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				System::Int64 _MaxPooledSize;
+				System::Int64 _PooledSize;
+				System::Int64 _RentCount;
+				System::Int64 _HitCount;
+				System::Int64 _AllocationCount;
+				System::Int64 _AllocatedSize;
+
+				std::vector<std::vector<std::vector<System::Byte>*> >* _Buffers;
+				array<System::Collections::Generic::Stack<array<System::Byte>^>^>^ _Arrays;
+				System::Object^ _Lock;
+		};
+	}
+}
@@ -0,0 +1,109 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ChromeTraceSink.h"
+#include "Json.h"
+
+MpqLib::Mpq::CChromeTraceSink::CChromeTraceSink(System::String^ FileName)
+{
+	_FileName = FileName;
+	_Writer = gcnew System::IO::StreamWriter(FileName, false, gcnew System::Text::UTF8Encoding(false));
+	_ProcessId = System::Diagnostics::Process::GetCurrentProcess()->Id;
+	_IsFirstEvent = true;
+	_Lock = gcnew System::Object();
+
+	_Writer->Write("[");
+}
+
+MpqLib::Mpq::CChromeTraceSink::~CChromeTraceSink()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CChromeTraceSink::!CChromeTraceSink()
+{
+	Cleanup(false);
+}
+
+System::Void MpqLib::Mpq::CChromeTraceSink::Close()
+{
+	Cleanup(true);
+}
+
+System::Void MpqLib::Mpq::CChromeTraceSink::Write(CTraceEvent^ Event)
+{
+	System::Text::StringBuilder^ Builder = gcnew System::Text::StringBuilder();
+
+	Builder->Append("{\"name\":")->Append(CJson::FormatString(Event->Operation));
+	Builder->Append(",\"cat\":\"MpqLib\",\"ph\":")->Append((Event->Kind == ETraceEventKind::Begin) ? "\"B\"" : "\"E\"");
+	Builder->Append(",\"ts\":")->Append(Event->Timestamp);
+	Builder->Append(",\"pid\":")->Append(_ProcessId);
+	Builder->Append(",\"tid\":")->Append(Event->ThreadId);
+	Builder->Append(",\"args\":{\"archive\":")->Append(CJson::FormatString(Event->ArchiveFileName));
+	if(Event->FileName != nullptr) Builder->Append(",\"file\":")->Append(CJson::FormatString(Event->FileName));
+
+	//The viewer merges the arguments of both ends, the results are only known at the end
+	if(Event->Kind == ETraceEventKind::End)
+	{
+		Builder->Append(",\"bytes\":")->Append(Event->Size);
+		if(Event->Compression.HasValue) Builder->Append(",\"compression\":")->Append(CJson::FormatString(Event->Compression.Value.ToString()));
+	}
+
+	Builder->Append("}}");
+
+	msclr::lock Lock(_Lock);
+
+	if(_Writer == nullptr) return;
+
+	if(!_IsFirstEvent) _Writer->Write(",");
+	_Writer->WriteLine();
+	_Writer->Write(Builder->ToString());
+	_IsFirstEvent = false;
+}
+
+System::String^ MpqLib::Mpq::CChromeTraceSink::FileName::get()
+{
+	return _FileName;
+}
+
+System::Void MpqLib::Mpq::CChromeTraceSink::Cleanup(System::Boolean CleanupManagedStuff)
+{
+	//The writer is a managed object of its own, the finalizer can not complete the trace
+	if(!CleanupManagedStuff) return;
+
+	msclr::lock Lock(_Lock);
+
+	if(_Writer != nullptr)
+	{
+		_Writer->WriteLine();
+		_Writer->WriteLine("]");
+		_Writer->Close();
+		_Writer = nullptr;
+	}
+}
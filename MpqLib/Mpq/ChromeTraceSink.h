@@ -0,0 +1,89 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TraceSink.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Writes trace events to a file in the Chrome trace event format, to be viewed in
+		/// chrome://tracing or a compatible viewer. Each thread gets its own track, so overlapping
+		/// operations show up side by side.
+		/// </summary>
+		public ref class CChromeTraceSink sealed : ITraceSink
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The file to write the trace to (an existing file is overwritten)</param>
+				CChromeTraceSink(System::String^ FileName);
+
+				/// <summary>
+				/// Completes the trace and releases all resources used by the MpqLib.Mpq.CChromeTraceSink.
+				/// </summary>
+				~CChromeTraceSink();
+
+				/// <summary>
+				/// Releases all resources used by the MpqLib.Mpq.CChromeTraceSink.
+				/// </summary>
+				!CChromeTraceSink();
+
+				/// <summary>
+				/// Completes the trace, events received afterwards are dropped.
+				/// </summary>
+				System::Void Close();
+
+				/// <summary>
+				/// Receives a trace event.
+				/// </summary>
+				/// <param name="Event">The event</param>
+				virtual System::Void Write(CTraceEvent^ Event);
+
+				/// <summary>
+				/// Retrieves the file the trace is written to.
+				/// </summary>
+				property System::String^ FileName { System::String^ get(); }
+
+			private:
+				System::Void Cleanup(System::Boolean CleanupManagedStuff);
+
+			private:
+				System::String^ _FileName;
+				System::IO::StreamWriter^ _Writer;
+				System::Int32 _ProcessId;
+				System::Boolean _IsFirstEvent;
+				System::Object^ _Lock;
+		};
+	}
+}
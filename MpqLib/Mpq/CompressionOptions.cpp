@@ -0,0 +1,85 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "CompressionOptions.h"
+
+MpqLib::Mpq::CCompressionOptions::CCompressionOptions(ECompression Compression)
+{
+	_Compression = Compression;
+	_Level = 0;
+	_DictionarySize = 0;
+}
+
+MpqLib::Mpq::CCompressionOptions::CCompressionOptions(ECompression Compression, System::Int32 Level)
+{
+	if((Level < 0) || (Level > CConstants::MaxCompressionLevel)) throw gcnew System::ArgumentOutOfRangeException("Level", "The level must be between 0 and " + CConstants::MaxCompressionLevel + "!");
+	if((Level != 0) && (Compression != ECompression::ZLib) && (Compression != ECompression::BZip2)) throw gcnew System::NotSupportedException("Only ZLib and BZip2 can be run at another level!");
+
+	_Compression = Compression;
+	_Level = Level;
+	_DictionarySize = 0;
+}
+
+MpqLib::Mpq::CCompressionOptions::CCompressionOptions(ECompression Compression, System::Int32 Level, System::Int32 DictionarySize)
+{
+	if((Level < 0) || (Level > CConstants::MaxCompressionLevel)) throw gcnew System::ArgumentOutOfRangeException("Level", "The level must be between 0 and " + CConstants::MaxCompressionLevel + "!");
+
+	if((DictionarySize != 0) && ((DictionarySize < CConstants::MinDictionarySize) || (DictionarySize > CConstants::MaxDictionarySize) || ((DictionarySize & (DictionarySize - 1)) != 0)))
+	{
+		throw gcnew System::ArgumentOutOfRangeException("DictionarySize", "The dictionary size must be a power of two between " + CConstants::MinDictionarySize + " and " + CConstants::MaxDictionarySize + "!");
+	}
+
+	//The other codecs are run by StormLib with fixed settings, parameters for them would be silently ignored
+	if((Level != 0) && (Compression != ECompression::ZLib) && (Compression != ECompression::BZip2)) throw gcnew System::NotSupportedException("Only ZLib and BZip2 can be run at another level!");
+	if((DictionarySize != 0) && (Compression != ECompression::ZLib)) throw gcnew System::NotSupportedException("Only ZLib can be run with another dictionary size!");
+
+	_Compression = Compression;
+	_Level = Level;
+	_DictionarySize = DictionarySize;
+}
+
+MpqLib::Mpq::ECompression MpqLib::Mpq::CCompressionOptions::Compression::get()
+{
+	return _Compression;
+}
+
+System::Int32 MpqLib::Mpq::CCompressionOptions::Level::get()
+{
+	return _Level;
+}
+
+System::Int32 MpqLib::Mpq::CCompressionOptions::DictionarySize::get()
+{
+	return _DictionarySize;
+}
+
+System::Boolean MpqLib::Mpq::CCompressionOptions::IsDefault::get()
+{
+	return (_Level == 0) && (_DictionarySize == 0);
+}
@@ -0,0 +1,94 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+#include "Compression.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// The compression of a file together with the codec parameters. The level applies to ZLib and BZip2
+		/// (as its block size), the dictionary (window) size to ZLib only. The other codecs always run with the
+		/// settings of StormLib, parameters for them throw a NotSupportedException.
+		/// </summary>
+		public ref class CCompressionOptions sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor, uses the default parameters of the codec.
+				/// </summary>
+				/// <param name="Compression">The compression to use</param>
+				CCompressionOptions(ECompression Compression);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Compression">The compression to use</param>
+				/// <param name="Level">The compression level, 1 (fastest) to 9 (smallest), or 0 for the default of the codec</param>
+				CCompressionOptions(ECompression Compression, System::Int32 Level);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Compression">The compression to use</param>
+				/// <param name="Level">The compression level, 1 (fastest) to 9 (smallest), or 0 for the default of the codec</param>
+				/// <param name="DictionarySize">The dictionary size in bytes, a power of two from 512 to 32768, or 0 for the default of the codec</param>
+				CCompressionOptions(ECompression Compression, System::Int32 Level, System::Int32 DictionarySize);
+
+				/// <summary>
+				/// Retrieves the compression.
+				/// </summary>
+				property ECompression Compression { ECompression get(); }
+
+				/// <summary>
+				/// Retrieves the compression level (0 for the default of the codec).
+				/// </summary>
+				property System::Int32 Level { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the dictionary size in bytes (0 for the default of the codec).
+				/// </summary>
+				property System::Int32 DictionarySize { System::Int32 get(); }
+
+				/// <summary>
+				/// Checks if the codec runs with its default parameters.
+				/// </summary>
+				property System::Boolean IsDefault { System::Boolean get(); }
+
+			private:
+				ECompression _Compression;
+				System::Int32 _Level;
+				System::Int32 _DictionarySize;
+		};
+	}
+}
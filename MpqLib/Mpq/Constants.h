@@ -56,6 +56,28 @@ namespace MpqLib
 
 		internal:
 			literal System::UInt32 DefaultHashTableSize = 32;
+			literal System::Double DefaultMaxHashTableLoadFactor = 0.75;
+			literal System::UInt16 DefaultSectorSizeShift = 3;
+			literal System::UInt16 MaxSectorSizeShift = 15;
+			literal System::Int32 MaxCompressionLevel = 9;
+			literal System::Int32 MinDictionarySize = 0x200;
+			literal System::Int32 MaxDictionarySize = 0x8000;
+			literal System::Int32 ExportBufferSize = 0x10000;
+			literal System::Int32 ExportRunSize = 0x400000;
+			literal System::Int32 ExportRunGap = 0x10000;
+			literal System::Int32 ExportPendingWrites = 8;
+			literal System::Int64 ExportMaxFileSize = 0x4000000;
+			literal System::Int32 SectorGroupSize = 0x40000;
+			literal System::Int32 ParallelEncodeMinSize = 0x400000;
+			literal System::Int32 ParallelDecodeMinSize = 0x100000;
+			literal System::Int32 ParallelDecodeBatchSize = 0x1000000;
+			literal System::Int64 DefaultMaxPooledSize = 0x4000000;
+			literal System::Int32 BufferPoolMinClassShift = 12;
+			literal System::Int32 BufferPoolMaxClassShift = 26;
+			literal System::Int32 NameTrieMinDeadEntries = 0x100;
+			literal System::UInt32 IndexSegmentSignature = 0x3158444D;
+			literal System::String^ AttributesFileName = "(attributes)";
+			literal System::String^ ListFileName = "(listfile)";
 	};
 }
 
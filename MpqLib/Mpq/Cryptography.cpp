@@ -0,0 +1,146 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "Cryptography.h"
+
+//The MPQ encryption table, 0x100 entries for each of the hash types and 0x100 for the block cipher
+static DWORD CryptTable[0x500];
+
+//The CRC32 table (same polynomial as zlib, which is what the "(attributes)" checksums use)
+static DWORD Crc32Table[0x100];
+
+MpqLib::Mpq::CCryptography::CCryptography()
+{
+	DWORD Seed = 0x00100001;
+
+	for(DWORD Index1 = 0; Index1 < 0x100; Index1++)
+	{
+		for(DWORD Index2 = Index1, i = 0; i < 5; i++, Index2 += 0x100)
+		{
+			Seed = (Seed * 125 + 3) % 0x2AAAAB;
+			DWORD Temp1 = (Seed & 0xFFFF) << 0x10;
+
+			Seed = (Seed * 125 + 3) % 0x2AAAAB;
+			DWORD Temp2 = (Seed & 0xFFFF);
+
+			CryptTable[Index2] = (Temp1 | Temp2);
+		}
+	}
+
+	for(DWORD i = 0; i < 0x100; i++)
+	{
+		DWORD Value = i;
+		for(DWORD j = 0; j < 8; j++) Value = (Value & 1) ? (0xEDB88320 ^ (Value >> 1)) : (Value >> 1);
+
+		Crc32Table[i] = Value;
+	}
+}
+
+DWORD MpqLib::Mpq::CCryptography::HashString(LPCSTR String, DWORD HashType)
+{
+	DWORD Seed1 = 0x7FED7FED;
+	DWORD Seed2 = 0xEEEEEEEE;
+
+	while(*String != '\0')
+	{
+		DWORD Character = static_cast<BYTE>(*String++);
+
+		//Names are case insensitive and both slashes are treated as path separators
+		if((Character >= 'a') && (Character <= 'z')) Character -= 'a' - 'A';
+		if(Character == '/') Character = '\\';
+
+		Seed1 = CryptTable[(HashType << 8) + Character] ^ (Seed1 + Seed2);
+		Seed2 = Character + Seed1 + Seed2 + (Seed2 << 5) + 3;
+	}
+
+	return Seed1;
+}
+
+System::Void MpqLib::Mpq::CCryptography::EncryptBlock(void* Data, DWORD Length, DWORD Key)
+{
+	DWORD* Block = static_cast<DWORD*>(Data);
+	DWORD Seed = 0xEEEEEEEE;
+
+	for(Length >>= 2; Length > 0; Length--)
+	{
+		DWORD Value = *Block;
+
+		Seed += CryptTable[0x400 + (Key & 0xFF)];
+		*Block++ = Value ^ (Key + Seed);
+
+		Key = ((~Key << 0x15) + 0x11111111) | (Key >> 0x0B);
+		Seed = Value + Seed + (Seed << 5) + 3;
+	}
+}
+
+System::Void MpqLib::Mpq::CCryptography::DecryptBlock(void* Data, DWORD Length, DWORD Key)
+{
+	DWORD* Block = static_cast<DWORD*>(Data);
+	DWORD Seed = 0xEEEEEEEE;
+
+	for(Length >>= 2; Length > 0; Length--)
+	{
+		Seed += CryptTable[0x400 + (Key & 0xFF)];
+		DWORD Value = *Block ^ (Key + Seed);
+		*Block++ = Value;
+
+		Key = ((~Key << 0x15) + 0x11111111) | (Key >> 0x0B);
+		Seed = Value + Seed + (Seed << 5) + 3;
+	}
+}
+
+DWORD MpqLib::Mpq::CCryptography::Crc32(const void* Data, DWORD Length)
+{
+	return Crc32(Data, Length, 0);
+}
+
+DWORD MpqLib::Mpq::CCryptography::Crc32(const void* Data, DWORD Length, DWORD Crc32)
+{
+	//Continues the checksum of the data before, so it can be computed piece by piece
+	const BYTE* Buffer = static_cast<const BYTE*>(Data);
+	DWORD Crc = Crc32 ^ 0xFFFFFFFF;
+
+	while(Length-- > 0) Crc = Crc32Table[(Crc ^ *Buffer++) & 0xFF] ^ (Crc >> 8);
+
+	return (Crc ^ 0xFFFFFFFF);
+}
+
+DWORD MpqLib::Mpq::CCryptography::GetFileKey(LPCSTR FileName, const SBlockEntry& BlockEntry)
+{
+	//The key only depends on the plain name, not the path
+	for(LPCSTR Character = FileName; *Character != '\0'; Character++)
+	{
+		if((*Character == '\\') || (*Character == '/')) FileName = Character + 1;
+	}
+
+	DWORD Key = HashString(FileName, HashTypeFileKey);
+	if(BlockEntry.Flags & MPQ_FILE_FIX_KEY) Key = (Key + BlockEntry.FilePosition) ^ BlockEntry.FileSize;
+
+	return Key;
+}
@@ -0,0 +1,58 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+#include "TableEntries.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		private ref class CCryptography abstract sealed
+		{
+			public:
+				static CCryptography();
+
+				static DWORD HashString(LPCSTR String, DWORD HashType);
+				static System::Void EncryptBlock(void* Data, DWORD Length, DWORD Key);
+				static System::Void DecryptBlock(void* Data, DWORD Length, DWORD Key);
+				static DWORD Crc32(const void* Data, DWORD Length);
+				static DWORD Crc32(const void* Data, DWORD Length, DWORD Crc32);
+				static DWORD GetFileKey(LPCSTR FileName, const SBlockEntry& BlockEntry);
+
+			public:
+				literal DWORD HashTypeTableOffset = 0;
+				literal DWORD HashTypeNameA = 1;
+				literal DWORD HashTypeNameB = 2;
+				literal DWORD HashTypeFileKey = 3;
+		};
+	}
+}
@@ -0,0 +1,79 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "DiffKind.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// An immutable difference between two archives.
+		/// </summary>
+		public ref class CDiffEntry sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The filename to use</param>
+				/// <param name="OldFileName">The filename in the original archive to use</param>
+				/// <param name="Kind">The kind of difference to use</param>
+				CDiffEntry(System::String^ FileName, System::String^ OldFileName, EDiffKind Kind);
+
+				/// <summary>
+				/// Generates a string version of the difference.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the filename (the new name for renamed files).
+				/// </summary>
+				property System::String^ FileName { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the filename in the original archive (differs from FileName for renamed files only).
+				/// </summary>
+				property System::String^ OldFileName { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the kind of difference.
+				/// </summary>
+				property EDiffKind Kind { EDiffKind get(); }
+
+			private:
+				System::String^ _FileName;
+				System::String^ _OldFileName;
+				EDiffKind _Kind;
+		};
+	}
+}
@@ -0,0 +1,240 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "DirectoryNode.h"
+
+MpqLib::Mpq::CDirectoryNode::CDirectoryNode(CDirectoryNode^ Parent, System::String^ Name, System::String^ Path)
+{
+	_Parent = Parent;
+	_Name = Name;
+	_Path = Path;
+
+	//Files are moved between the directories of a tree, all of them share the lock of the root
+	_Lock = (Parent != nullptr) ? Parent->_Lock : gcnew System::Object();
+	_PendingFiles = gcnew System::Collections::Generic::List<CFileInfo^>();
+	_DirectoryIndex = nullptr;
+	_DirectoryList = nullptr;
+	_FileList = nullptr;
+	_Directories = nullptr;
+	_Files = nullptr;
+
+	_FileCount = 0;
+	_Size = 0;
+	_CompressedSize = 0;
+}
+
+System::String^ MpqLib::Mpq::CDirectoryNode::ToString()
+{
+	return _Path;
+}
+
+MpqLib::Mpq::CDirectoryNode^ MpqLib::Mpq::CDirectoryNode::GetDirectory(System::String^ Name)
+{
+	msclr::lock Lock(_Lock);
+
+	Expand();
+
+	CDirectoryNode^ Directory = nullptr;
+	_DirectoryIndex->TryGetValue(Name, Directory);
+
+	return Directory;
+}
+
+System::String^ MpqLib::Mpq::CDirectoryNode::Name::get()
+{
+	return _Name;
+}
+
+System::String^ MpqLib::Mpq::CDirectoryNode::Path::get()
+{
+	return _Path;
+}
+
+MpqLib::Mpq::CDirectoryNode^ MpqLib::Mpq::CDirectoryNode::Parent::get()
+{
+	return _Parent;
+}
+
+System::Collections::ObjectModel::ReadOnlyCollection<MpqLib::Mpq::CDirectoryNode^>^ MpqLib::Mpq::CDirectoryNode::Directories::get()
+{
+	msclr::lock Lock(_Lock);
+
+	Expand();
+
+	//The snapshot is kept until the directory changes
+	if(_Directories == nullptr) _Directories = gcnew System::Collections::ObjectModel::ReadOnlyCollection<CDirectoryNode^>(_DirectoryList->ToArray());
+
+	return _Directories;
+}
+
+System::Collections::ObjectModel::ReadOnlyCollection<MpqLib::Mpq::CFileInfo^>^ MpqLib::Mpq::CDirectoryNode::Files::get()
+{
+	msclr::lock Lock(_Lock);
+
+	Expand();
+
+	if(_Files == nullptr) _Files = gcnew System::Collections::ObjectModel::ReadOnlyCollection<CFileInfo^>(_FileList->ToArray());
+
+	return _Files;
+}
+
+System::Int32 MpqLib::Mpq::CDirectoryNode::FileCount::get()
+{
+	msclr::lock Lock(_Lock);
+
+	return _FileCount;
+}
+
+System::Int64 MpqLib::Mpq::CDirectoryNode::Size::get()
+{
+	msclr::lock Lock(_Lock);
+
+	return _Size;
+}
+
+System::Int64 MpqLib::Mpq::CDirectoryNode::CompressedSize::get()
+{
+	msclr::lock Lock(_Lock);
+
+	return _CompressedSize;
+}
+
+System::Void MpqLib::Mpq::CDirectoryNode::AddFile(CFileInfo^ FileInfo)
+{
+	msclr::lock Lock(_Lock);
+
+	_FileCount++;
+	_Size += FileInfo->Size;
+	_CompressedSize += FileInfo->CompressedSize;
+
+	if(_PendingFiles != nullptr) _PendingFiles->Add(FileInfo);
+	else PlaceFile(FileInfo);
+}
+
+System::Void MpqLib::Mpq::CDirectoryNode::RemoveFile(System::String^ FileName)
+{
+	msclr::lock Lock(_Lock);
+
+	//Every locale of the name goes, the archive adds back the ones that are left
+	if(_PendingFiles != nullptr)
+	{
+		for(System::Int32 i = _PendingFiles->Count - 1; i >= 0; i--)
+		{
+			CFileInfo^ FileInfo = _PendingFiles[i];
+			if(System::String::Compare(FileInfo->FileName, FileName, true) != 0) continue;
+
+			_FileCount--;
+			_Size -= FileInfo->Size;
+			_CompressedSize -= FileInfo->CompressedSize;
+			_PendingFiles->RemoveAt(i);
+		}
+
+		return;
+	}
+
+	System::Int32 Separator = FileName->IndexOf(L'\\', _Path->Length);
+
+	if(Separator < 0)
+	{
+		for(System::Int32 i = _FileList->Count - 1; i >= 0; i--)
+		{
+			CFileInfo^ FileInfo = _FileList[i];
+			if(System::String::Compare(FileInfo->FileName, FileName, true) != 0) continue;
+
+			_FileCount--;
+			_Size -= FileInfo->Size;
+			_CompressedSize -= FileInfo->CompressedSize;
+			_FileList->RemoveAt(i);
+			_Files = nullptr;
+		}
+
+		return;
+	}
+
+	CDirectoryNode^ Directory = nullptr;
+	if(!_DirectoryIndex->TryGetValue(FileName->Substring(_Path->Length, Separator - _Path->Length), Directory)) return;
+
+	_FileCount -= Directory->_FileCount;
+	_Size -= Directory->_Size;
+	_CompressedSize -= Directory->_CompressedSize;
+
+	Directory->RemoveFile(FileName);
+
+	_FileCount += Directory->_FileCount;
+	_Size += Directory->_Size;
+	_CompressedSize += Directory->_CompressedSize;
+
+	//Directories only exist through their files
+	if(Directory->_FileCount == 0)
+	{
+		_DirectoryIndex->Remove(Directory->_Name);
+		_DirectoryList->Remove(Directory);
+		_Directories = nullptr;
+	}
+}
+
+System::Void MpqLib::Mpq::CDirectoryNode::Expand()
+{
+	if(_PendingFiles == nullptr) return;
+
+	_DirectoryIndex = gcnew System::Collections::Generic::Dictionary<System::String^, CDirectoryNode^>(System::StringComparer::OrdinalIgnoreCase);
+	_DirectoryList = gcnew System::Collections::Generic::List<CDirectoryNode^>();
+	_FileList = gcnew System::Collections::Generic::List<CFileInfo^>();
+
+	System::Collections::Generic::List<CFileInfo^>^ PendingFiles = _PendingFiles;
+	_PendingFiles = nullptr;
+
+	for each(CFileInfo^ FileInfo in PendingFiles) PlaceFile(FileInfo);
+}
+
+System::Void MpqLib::Mpq::CDirectoryNode::PlaceFile(CFileInfo^ FileInfo)
+{
+	System::String^ FileName = FileInfo->FileName;
+	System::Int32 Separator = FileName->IndexOf(L'\\', _Path->Length);
+
+	if(Separator < 0)
+	{
+		_FileList->Add(FileInfo);
+		_Files = nullptr;
+		return;
+	}
+
+	System::String^ Name = FileName->Substring(_Path->Length, Separator - _Path->Length);
+	CDirectoryNode^ Directory = nullptr;
+
+	if(!_DirectoryIndex->TryGetValue(Name, Directory))
+	{
+		Directory = gcnew CDirectoryNode(this, Name, FileName->Substring(0, Separator + 1));
+		_DirectoryIndex->Add(Name, Directory);
+		_DirectoryList->Add(Directory);
+		_Directories = nullptr;
+	}
+
+	Directory->AddFile(FileInfo);
+}
@@ -0,0 +1,130 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "FileInfo.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// A directory of the virtual folder tree of an archive (MPQ archives only store backslash separated
+		/// names, the directories are implied by them). The tree is maintained by the archive, a directory
+		/// only sorts its files into subdirectories the first time its contents are asked for. The whole
+		/// tree shares one lock, so it can be browsed while the archive applies its changes.
+		/// </summary>
+		public ref class CDirectoryNode sealed
+		{
+			public:
+				/// <summary>
+				/// Generates a string version of the directory.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves a subdirectory by name.
+				/// </summary>
+				/// <param name="Name">The name of the subdirectory (case is ignored)</param>
+				/// <returns>The subdirectory, null if there is none by that name</returns>
+				CDirectoryNode^ GetDirectory(System::String^ Name);
+
+				/// <summary>
+				/// Retrieves the name of the directory (empty for the root).
+				/// </summary>
+				property System::String^ Name { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the path of the directory, ending with a backslash (empty for the root).
+				/// </summary>
+				property System::String^ Path { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the parent directory (null for the root).
+				/// </summary>
+				property CDirectoryNode^ Parent { CDirectoryNode^ get(); }
+
+				/// <summary>
+				/// Retrieves a snapshot of the subdirectories. Changes made through the archive show up in later
+				/// snapshots once its Root has been read again.
+				/// </summary>
+				property System::Collections::ObjectModel::ReadOnlyCollection<CDirectoryNode^>^ Directories { System::Collections::ObjectModel::ReadOnlyCollection<CDirectoryNode^>^ get(); }
+
+				/// <summary>
+				/// Retrieves a snapshot of the files directly in the directory. Changes made through the archive show
+				/// up in later snapshots once its Root has been read again.
+				/// </summary>
+				property System::Collections::ObjectModel::ReadOnlyCollection<CFileInfo^>^ Files { System::Collections::ObjectModel::ReadOnlyCollection<CFileInfo^>^ get(); }
+
+				/// <summary>
+				/// Retrieves the number of files in the directory and all of its subdirectories.
+				/// </summary>
+				property System::Int32 FileCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the total size of the files in the directory and all of its subdirectories.
+				/// </summary>
+				property System::Int64 Size { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the total size of the files in the directory and all of its subdirectories when stored in the archive.
+				/// </summary>
+				property System::Int64 CompressedSize { System::Int64 get(); }
+
+			internal:
+				CDirectoryNode(CDirectoryNode^ Parent, System::String^ Name, System::String^ Path);
+
+				System::Void AddFile(CFileInfo^ FileInfo);
+				System::Void RemoveFile(System::String^ FileName);
+
+			private:
+				System::Void Expand();
+				System::Void PlaceFile(CFileInfo^ FileInfo);
+
+			private:
+				CDirectoryNode^ _Parent;
+				System::String^ _Name;
+				System::String^ _Path;
+
+				System::Object^ _Lock;
+				System::Collections::Generic::List<CFileInfo^>^ _PendingFiles;
+				System::Collections::Generic::Dictionary<System::String^, CDirectoryNode^>^ _DirectoryIndex;
+				System::Collections::Generic::List<CDirectoryNode^>^ _DirectoryList;
+				System::Collections::Generic::List<CFileInfo^>^ _FileList;
+				System::Collections::ObjectModel::ReadOnlyCollection<CDirectoryNode^>^ _Directories;
+				System::Collections::ObjectModel::ReadOnlyCollection<CFileInfo^>^ _Files;
+
+				System::Int32 _FileCount;
+				System::Int64 _Size;
+				System::Int64 _CompressedSize;
+		};
+	}
+}
@@ -0,0 +1,376 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "ExportScheduler.h"
+
+MpqLib::Mpq::CExportScheduler::CExportScheduler(CArchive^ Archive, System::String^ Directory)
+{
+	_Archive = Archive;
+	_Directory = System::IO::Path::GetFullPath(Directory);
+	_SectorSize = Archive->Header->SectorSize;
+	_ExportedFileCount = 0;
+
+	_Files = gcnew System::Collections::Generic::List<CFileInfo^>();
+	_Keys = gcnew System::Collections::Generic::List<System::UInt32>();
+	_FallbackFiles = gcnew System::Collections::Generic::List<CFileInfo^>();
+	_FailedFiles = gcnew System::Collections::Concurrent::ConcurrentQueue<CFileInfo^>();
+
+	_ReadQueue = gcnew System::Collections::Concurrent::BlockingCollection<System::Tuple<System::Int32, System::Int32, array<System::Byte>^>^>(2 * System::Environment::ProcessorCount);
+	_WriteQueue = gcnew System::Collections::Concurrent::BlockingCollection<System::Tuple<System::String^, array<System::Byte>^>^>(2 * System::Environment::ProcessorCount);
+	_Directories = gcnew System::Collections::Generic::HashSet<System::String^>(System::StringComparer::OrdinalIgnoreCase);
+	_Cancel = gcnew System::Threading::CancellationTokenSource();
+}
+
+MpqLib::Mpq::CExportScheduler::~CExportScheduler()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CExportScheduler::!CExportScheduler()
+{
+	Cleanup(false);
+}
+
+System::Int32 MpqLib::Mpq::CExportScheduler::Export(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files)
+{
+	Plan(Files);
+
+	array<System::Threading::Tasks::Task^>^ Decoders = gcnew array<System::Threading::Tasks::Task^>(System::Environment::ProcessorCount);
+	for(System::Int32 i = 0; i < Decoders->Length; i++)
+	{
+		Decoders[i] = System::Threading::Tasks::Task::Factory->StartNew(gcnew System::Action(this, &CExportScheduler::DecodeFiles), System::Threading::Tasks::TaskCreationOptions::LongRunning);
+	}
+
+	array<System::Threading::Tasks::Task^>^ Writers = gcnew array<System::Threading::Tasks::Task^>(1);
+	Writers[0] = System::Threading::Tasks::Task::Factory->StartNew(gcnew System::Action(this, &CExportScheduler::WriteFiles), System::Threading::Tasks::TaskCreationOptions::LongRunning);
+
+	//The reader runs on this thread, each stage is completed once the one before it has drained
+	System::Exception^ Failure = nullptr;
+
+	try
+	{
+		ReadRuns();
+	}
+	catch(System::OperationCanceledException^)
+	{
+		//A later stage failed and reports the error
+	}
+	catch(System::Exception^ Exception)
+	{
+		Failure = Exception;
+		_Cancel->Cancel();
+	}
+
+	_ReadQueue->CompleteAdding();
+	Failure = WaitForStage(Decoders, Failure);
+
+	_WriteQueue->CompleteAdding();
+	Failure = WaitForStage(Writers, Failure);
+
+	if(Failure != nullptr) System::Runtime::ExceptionServices::ExceptionDispatchInfo::Capture(Failure)->Throw();
+
+	//StormLib handles are not thread safe, the remaining files are exported on this thread
+	ExportFallbacks();
+
+	return _ExportedFileCount;
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::Plan(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files)
+{
+	CArchiveIndex^ ArchiveIndex = _Archive->Index;
+
+	for each(CFileInfo^ FileInfo in Files)
+	{
+		//Large files are streamed to disk instead of being decoded in memory
+		if((FileInfo->Position < 0) || (FileInfo->BlockIndex < 0) || (FileInfo->BlockIndex >= ArchiveIndex->BlockTableSize) || (FileInfo->Size > CConstants::ExportMaxFileSize) || (FileInfo->CompressedSize > CConstants::ExportMaxFileSize))
+		{
+			_FallbackFiles->Add(FileInfo);
+			continue;
+		}
+
+		//A name resolving to another block is another locale version, only the one the archive resolves to is exported
+		CStringHandle FileNameHandle(FileInfo->FileName);
+		System::Int32 HashIndex = ArchiveIndex->FindHashEntry(FileNameHandle.Value, _Archive->Locale);
+		System::Boolean IsNamed = (HashIndex != CConstants::InvalidIndex);
+
+		if(IsNamed && (static_cast<System::Int32>(ArchiveIndex->GetHashEntry(HashIndex).BlockIndex) != FileInfo->BlockIndex)) continue;
+
+		SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(FileInfo->BlockIndex);
+		if(!CBlockDecoder::CanDecode(BlockEntry, IsNamed))
+		{
+			if(IsNamed) _FallbackFiles->Add(FileInfo);
+			continue;
+		}
+
+		_Files->Add(FileInfo);
+	}
+
+	_Files->Sort(gcnew System::Comparison<CFileInfo^>(this, &CExportScheduler::ComparePositions));
+
+	for each(CFileInfo^ FileInfo in _Files)
+	{
+		CStringHandle FileNameHandle(FileInfo->FileName);
+		SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(FileInfo->BlockIndex);
+
+		_Keys->Add((BlockEntry.Flags & MPQ_FILE_ENCRYPTED) ? CCryptography::GetFileKey(FileNameHandle.Value, BlockEntry) : 0);
+	}
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::ReadRuns()
+{
+	System::IO::FileStream^ Stream = gcnew System::IO::FileStream(_Archive->FileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite, 0x1000, System::IO::FileOptions::SequentialScan);
+
+	try
+	{
+		for(System::Int32 i = 0; i < _Files->Count; )
+		{
+			System::Int64 RunStart = _Files[i]->Position;
+			System::Int64 RunEnd = RunStart + _Files[i]->CompressedSize;
+			System::Int32 RunCount = 1;
+
+			//Neighbouring blocks are read along, as long as the gap and the total stay small
+			while((i + RunCount) < _Files->Count)
+			{
+				System::Int64 Start = _Files[i + RunCount]->Position;
+				System::Int64 End = System::Math::Max(RunEnd, Start + _Files[i + RunCount]->CompressedSize);
+
+				if(((Start - RunEnd) > CConstants::ExportRunGap) || ((End - RunStart) > CConstants::ExportRunSize)) break;
+
+				RunEnd = End;
+				RunCount++;
+			}
+
+			//Run buffers come from the pool and go back once the run is decoded, they may be longer than the run
+			System::Int32 RunLength = static_cast<System::Int32>(RunEnd - RunStart);
+			array<System::Byte>^ Data = _Archive->BufferPool->RentArray(RunLength);
+
+			Stream->Position = RunStart;
+			for(System::Int32 Index = 0; Index < RunLength; )
+			{
+				System::Int32 BytesRead = Stream->Read(Data, Index, RunLength - Index);
+				if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The archive \"" + _Archive->FileName + "\" is truncated!");
+
+				Index += BytesRead;
+			}
+
+			_ReadQueue->Add(System::Tuple::Create(i, RunCount, Data), _Cancel->Token);
+
+			i += RunCount;
+		}
+	}
+	finally
+	{
+		Stream->Close();
+	}
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::DecodeFiles()
+{
+	try
+	{
+		for each(System::Tuple<System::Int32, System::Int32, array<System::Byte>^>^ Job in _ReadQueue->GetConsumingEnumerable(_Cancel->Token))
+		{
+			System::Int64 RunStart = _Files[Job->Item1]->Position;
+
+			try
+			{
+				for(System::Int32 i = Job->Item1; i < (Job->Item1 + Job->Item2); i++)
+				{
+					DecodeFile(i, Job->Item3, static_cast<System::Int32>(_Files[i]->Position - RunStart));
+				}
+			}
+			finally
+			{
+				_Archive->BufferPool->ReturnArray(Job->Item3);
+			}
+		}
+	}
+	catch(System::OperationCanceledException^)
+	{
+		//Another stage failed and reports the error
+	}
+	catch(System::Exception^)
+	{
+		_Cancel->Cancel();
+		throw;
+	}
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::DecodeFile(System::Int32 FileIndex, array<System::Byte>^ Data, System::Int32 Offset)
+{
+	CFileInfo^ FileInfo = _Files[FileIndex];
+
+	SBlockEntry BlockEntry;
+	BlockEntry.FilePosition = 0;
+	BlockEntry.CompressedSize = static_cast<DWORD>(FileInfo->CompressedSize);
+	BlockEntry.FileSize = static_cast<DWORD>(FileInfo->Size);
+	BlockEntry.Flags = FileInfo->Flags;
+
+	//Decryption is done in place, the run buffer may hold the same block for several names
+	array<System::Byte>^ BlockData = nullptr;
+
+	if(BlockEntry.Flags & MPQ_FILE_ENCRYPTED)
+	{
+		BlockData = _Archive->BufferPool->RentArray(static_cast<System::Int32>(FileInfo->CompressedSize));
+		System::Array::Copy(Data, Offset, BlockData, 0, static_cast<System::Int32>(FileInfo->CompressedSize));
+
+		Data = BlockData;
+		Offset = 0;
+	}
+
+	array<System::Byte>^ FileData = nullptr;
+
+	try
+	{
+		FileData = CBlockDecoder::DecodeBlock(Data, Offset, BlockEntry, _Keys[FileIndex], _SectorSize);
+	}
+	catch(System::IO::InvalidDataException^)
+	{
+	}
+	catch(System::IO::EndOfStreamException^)
+	{
+	}
+	finally
+	{
+		_Archive->BufferPool->ReturnArray(BlockData);
+	}
+
+	if(FileData == nullptr)
+	{
+		_FailedFiles->Enqueue(FileInfo);
+		return;
+	}
+
+	_WriteQueue->Add(System::Tuple::Create(BuildOutputFileName(FileInfo->FileName), FileData), _Cancel->Token);
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::WriteFiles()
+{
+	System::Collections::Generic::Queue<System::Tuple<System::Threading::Tasks::Task^, System::IO::FileStream^>^>^ PendingWrites = gcnew System::Collections::Generic::Queue<System::Tuple<System::Threading::Tasks::Task^, System::IO::FileStream^>^>();
+
+	try
+	{
+		//A few writes are kept in flight, so the disk is busy while the next file is set up
+		for each(System::Tuple<System::String^, array<System::Byte>^>^ Job in _WriteQueue->GetConsumingEnumerable(_Cancel->Token))
+		{
+			System::String^ DirectoryName = System::IO::Path::GetDirectoryName(Job->Item1);
+			if(_Directories->Add(DirectoryName)) System::IO::Directory::CreateDirectory(DirectoryName);
+
+			System::IO::FileStream^ Stream = gcnew System::IO::FileStream(Job->Item1, System::IO::FileMode::Create, System::IO::FileAccess::Write, System::IO::FileShare::None, 0x1000, System::IO::FileOptions::Asynchronous);
+			PendingWrites->Enqueue(System::Tuple::Create(Stream->WriteAsync(Job->Item2, 0, Job->Item2->Length), Stream));
+
+			if(PendingWrites->Count >= CConstants::ExportPendingWrites) CompleteWrite(PendingWrites->Dequeue());
+		}
+
+		while(PendingWrites->Count > 0) CompleteWrite(PendingWrites->Dequeue());
+	}
+	catch(System::OperationCanceledException^)
+	{
+		//Another stage failed and reports the error
+	}
+	catch(System::Exception^)
+	{
+		_Cancel->Cancel();
+		throw;
+	}
+	finally
+	{
+		for each(System::Tuple<System::Threading::Tasks::Task^, System::IO::FileStream^>^ PendingWrite in PendingWrites) PendingWrite->Item2->Close();
+	}
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::CompleteWrite(System::Tuple<System::Threading::Tasks::Task^, System::IO::FileStream^>^ PendingWrite)
+{
+	try
+	{
+		PendingWrite->Item1->Wait();
+	}
+	finally
+	{
+		PendingWrite->Item2->Close();
+	}
+
+	_ExportedFileCount++;
+}
+
+System::Void MpqLib::Mpq::CExportScheduler::ExportFallbacks()
+{
+	_FallbackFiles->AddRange(_FailedFiles);
+
+	for each(CFileInfo^ FileInfo in _FallbackFiles)
+	{
+		System::String^ OutputFileName = BuildOutputFileName(FileInfo->FileName);
+		System::IO::Directory::CreateDirectory(System::IO::Path::GetDirectoryName(OutputFileName));
+
+		_Archive->ExportFile(FileInfo->FileName, OutputFileName, FileInfo->Locale);
+		_ExportedFileCount++;
+	}
+}
+
+System::Exception^ MpqLib::Mpq::CExportScheduler::WaitForStage(array<System::Threading::Tasks::Task^>^ Tasks, System::Exception^ Failure)
+{
+	try
+	{
+		System::Threading::Tasks::Task::WaitAll(Tasks);
+	}
+	catch(System::AggregateException^ Exception)
+	{
+		if(Failure == nullptr) Failure = Exception->Flatten()->InnerExceptions[0];
+	}
+
+	return Failure;
+}
+
+System::String^ MpqLib::Mpq::CExportScheduler::BuildOutputFileName(System::String^ FileName)
+{
+	System::String^ OutputFileName = System::IO::Path::GetFullPath(System::IO::Path::Combine(_Directory, FileName->Replace('\\', System::IO::Path::DirectorySeparatorChar)));
+
+	//Stored paths are not trusted to stay inside the target directory
+	if(!OutputFileName->StartsWith(_Directory->TrimEnd(System::IO::Path::DirectorySeparatorChar) + System::IO::Path::DirectorySeparatorChar, System::StringComparison::OrdinalIgnoreCase))
+	{
+		throw gcnew System::IO::IOException("The path of \"" + FileName + "\" leads outside of \"" + _Directory + "\"!");
+	}
+
+	return OutputFileName;
+}
+
+System::Int32 MpqLib::Mpq::CExportScheduler::ComparePositions(CFileInfo^ FileInfo1, CFileInfo^ FileInfo2)
+{
+	return FileInfo1->Position.CompareTo(FileInfo2->Position);
+}
+
+void MpqLib::Mpq::CExportScheduler::Cleanup(bool CleanupManagedStuff)
+{
+	if(CleanupManagedStuff)
+	{
+		delete _ReadQueue;
+		delete _WriteQueue;
+		delete _Cancel;
+	}
+}
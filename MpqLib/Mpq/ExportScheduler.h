@@ -0,0 +1,86 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Archive.h"
+#include "BlockDecoder.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Exports many files at once through a pipeline of three stages with bounded queues in between:
+		/// a reader taking the blocks in stored order (neighbouring blocks in one large read), a pool of
+		/// workers decoding them, and a writer creating the directories and writing the files asynchronously.
+		/// Blocks that can not be decoded directly are exported through StormLib afterwards.
+		/// </summary>
+		private ref class CExportScheduler
+		{
+			public:
+				CExportScheduler(CArchive^ Archive, System::String^ Directory);
+				~CExportScheduler();
+				!CExportScheduler();
+
+				System::Int32 Export(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files);
+
+			private:
+				System::Void Plan(System::Collections::Generic::IEnumerable<CFileInfo^>^ Files);
+				System::Void ReadRuns();
+				System::Void DecodeFiles();
+				System::Void DecodeFile(System::Int32 FileIndex, array<System::Byte>^ Data, System::Int32 Offset);
+				System::Void WriteFiles();
+				System::Void CompleteWrite(System::Tuple<System::Threading::Tasks::Task^, System::IO::FileStream^>^ PendingWrite);
+				System::Void ExportFallbacks();
+
+				System::Exception^ WaitForStage(array<System::Threading::Tasks::Task^>^ Tasks, System::Exception^ Failure);
+				System::String^ BuildOutputFileName(System::String^ FileName);
+				System::Int32 ComparePositions(CFileInfo^ FileInfo1, CFileInfo^ FileInfo2);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				CArchive^ _Archive;
+				System::String^ _Directory;
+				System::Int32 _SectorSize;
+				System::Int32 _ExportedFileCount;
+
+				System::Collections::Generic::List<CFileInfo^>^ _Files;
+				System::Collections::Generic::List<System::UInt32>^ _Keys;
+				System::Collections::Generic::List<CFileInfo^>^ _FallbackFiles;
+				System::Collections::Concurrent::ConcurrentQueue<CFileInfo^>^ _FailedFiles;
+
+				System::Collections::Concurrent::BlockingCollection<System::Tuple<System::Int32, System::Int32, array<System::Byte>^>^>^ _ReadQueue;
+				System::Collections::Concurrent::BlockingCollection<System::Tuple<System::String^, array<System::Byte>^>^>^ _WriteQueue;
+				System::Collections::Generic::HashSet<System::String^>^ _Directories;
+				System::Threading::CancellationTokenSource^ _Cancel;
+		};
+	}
+}
@@ -28,12 +28,55 @@
 //|
 //+-----------------------------------------------------------------------------
 #include "FileInfo.h"
+#include "StringHandle.h"
+#include "BlockProbe.h"
 
-MpqLib::Mpq::CFileInfo::CFileInfo(System::String^ FileName, System::Int32 Size, System::Int32 CompressedSize)
+MpqLib::Mpq::CFileInfo::CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize)
 {
 	_FileName = FileName;
 	_Size = Size;
 	_CompressedSize = CompressedSize;
+	_BlockIndex = CConstants::InvalidIndex;
+	_Locale = LANG_NEUTRAL;
+	_Flags = 0;
+	_Position = CConstants::InvalidIndex;
+	_Compression = ECompression::None;
+	_ArchiveFileName = nullptr;
+	_SectorSize = 0;
+	_BlockPosition = 0;
+	_IsNamed = false;
+}
+
+MpqLib::Mpq::CFileInfo::CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize, System::Int32 BlockIndex, LCID Locale, System::UInt32 Flags, System::Int64 Position, ECompression Compression)
+{
+	_FileName = FileName;
+	_Size = Size;
+	_CompressedSize = CompressedSize;
+	_BlockIndex = BlockIndex;
+	_Locale = Locale;
+	_Flags = Flags;
+	_Position = Position;
+	_Compression = Compression;
+	_ArchiveFileName = nullptr;
+	_SectorSize = 0;
+	_BlockPosition = 0;
+	_IsNamed = false;
+}
+
+MpqLib::Mpq::CFileInfo::CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize, System::Int32 BlockIndex, LCID Locale, System::UInt32 Flags, System::Int64 Position, System::String^ ArchiveFileName, System::Int32 SectorSize, System::UInt32 BlockPosition, System::Boolean IsNamed)
+{
+	_FileName = FileName;
+	_Size = Size;
+	_CompressedSize = CompressedSize;
+	_BlockIndex = BlockIndex;
+	_Locale = Locale;
+	_Flags = Flags;
+	_Position = Position;
+	_Compression = ECompression::None;
+	_ArchiveFileName = ArchiveFileName;
+	_SectorSize = SectorSize;
+	_BlockPosition = BlockPosition;
+	_IsNamed = IsNamed;
 }
 
 System::String^ MpqLib::Mpq::CFileInfo::FileName::get()
@@ -41,12 +84,75 @@ System::String^ MpqLib::Mpq::CFileInfo::FileName::get()
 	return _FileName;
 }
 
-System::Int32 MpqLib::Mpq::CFileInfo::Size::get()
+System::Int64 MpqLib::Mpq::CFileInfo::Size::get()
 {
 	return _Size;
 }
 
-System::Int32 MpqLib::Mpq::CFileInfo::CompressedSize::get()
+System::Int64 MpqLib::Mpq::CFileInfo::CompressedSize::get()
 {
 	return _CompressedSize;
 }
+
+System::Int32 MpqLib::Mpq::CFileInfo::BlockIndex::get()
+{
+	return _BlockIndex;
+}
+
+LCID MpqLib::Mpq::CFileInfo::Locale::get()
+{
+	return _Locale;
+}
+
+System::UInt32 MpqLib::Mpq::CFileInfo::Flags::get()
+{
+	return _Flags;
+}
+
+System::Int64 MpqLib::Mpq::CFileInfo::Position::get()
+{
+	return _Position;
+}
+
+MpqLib::Mpq::ECompression MpqLib::Mpq::CFileInfo::Compression::get()
+{
+	System::String^ ArchiveFileName = _ArchiveFileName;
+	if(ArchiveFileName == nullptr) return _Compression;
+
+	//Listing a large archive would otherwise read every block, only the files asked for are probed (once)
+	SBlockEntry BlockEntry;
+	BlockEntry.FilePosition = _BlockPosition;
+	BlockEntry.CompressedSize = static_cast<DWORD>(_CompressedSize);
+	BlockEntry.FileSize = static_cast<DWORD>(_Size);
+	BlockEntry.Flags = _Flags;
+
+	CStringHandle FileNameHandle(_FileName);
+
+	try
+	{
+		CBlockProbe Probe(ArchiveFileName, _SectorSize);
+		_Compression = Probe.ProbeCompression(_IsNamed ? FileNameHandle.Value : NULL, BlockEntry, _Position);
+	}
+	catch(System::IO::IOException^)
+	{
+		//The archive file may be gone or locked by now, the method stays undetermined
+		return ECompression::None;
+	}
+
+	_ArchiveFileName = nullptr;
+
+	return _Compression;
+}
+
+MpqLib::Mpq::EEncryption MpqLib::Mpq::CFileInfo::Encryption::get()
+{
+	if((_Flags & MPQ_FILE_ENCRYPTED) == 0) return EEncryption::None;
+	if(_Flags & MPQ_FILE_FIX_KEY) return EEncryption::EncryptedWithFixedSeed;
+
+	return EEncryption::Encrypted;
+}
+
+System::Boolean MpqLib::Mpq::CFileInfo::IsCompressed::get()
+{
+	return ((_Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) != 0);
+}
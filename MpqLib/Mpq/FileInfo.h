@@ -30,6 +30,8 @@
 #pragma once
 
 #include "Constants.h"
+#include "Compression.h"
+#include "Encryption.h"
 
 namespace MpqLib
 {
@@ -48,7 +50,25 @@ namespace MpqLib
 				/// <param name="FileName">The filename to use</param>
 				/// <param name="Size">The size to use</param>
 				/// <param name="CompressedSize">The compressed size to use</param>
-				CFileInfo(System::String^ FileName, System::Int32 Size, System::Int32 CompressedSize);
+				CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The filename to use</param>
+				/// <param name="Size">The size to use</param>
+				/// <param name="CompressedSize">The compressed size to use</param>
+				/// <param name="BlockIndex">The block index to use</param>
+				/// <param name="Locale">The locale to use</param>
+				/// <param name="Flags">The MPQ file flags to use</param>
+				/// <param name="Position">The position in the archive file to use</param>
+				/// <param name="Compression">The compression to use</param>
+				CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize, System::Int32 BlockIndex, LCID Locale, System::UInt32 Flags, System::Int64 Position, ECompression Compression);
+
+			internal:
+				CFileInfo(System::String^ FileName, System::Int64 Size, System::Int64 CompressedSize, System::Int32 BlockIndex, LCID Locale, System::UInt32 Flags, System::Int64 Position, System::String^ ArchiveFileName, System::Int32 SectorSize, System::UInt32 BlockPosition, System::Boolean IsNamed);
+
+			public:
 
 				/// <summary>
 				/// Retrieves the filename.
@@ -58,17 +78,64 @@ namespace MpqLib
 				/// <summary>
 				/// Retrieves the size (the size of the real, exported file).
 				/// </summary>
-				property System::Int32 Size { System::Int32 get(); }
+				property System::Int64 Size { System::Int64 get(); }
 
 				/// <summary>
 				/// Retrieves the compressed size (the size of the file stored in the archive).
 				/// </summary>
-				property System::Int32 CompressedSize { System::Int32 get(); }
+				property System::Int64 CompressedSize { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the index of the block in the block table (CConstants.InvalidIndex if unknown).
+				/// </summary>
+				property System::Int32 BlockIndex { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the locale.
+				/// </summary>
+				property LCID Locale { LCID get(); }
+
+				/// <summary>
+				/// Retrieves the MPQ file flags of the block.
+				/// </summary>
+				property System::UInt32 Flags { System::UInt32 get(); }
+
+				/// <summary>
+				/// Retrieves the position of the stored file in the archive file (-1 if unknown).
+				/// Sorting by position gives sequential reads.
+				/// </summary>
+				property System::Int64 Position { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the compression of the stored file. Is None for compressed files
+				/// whose method could not be determined, use IsCompressed to tell those apart.
+				/// For files found in an archive the method is read from the archive file on first access.
+				/// </summary>
+				property ECompression Compression { ECompression get(); }
+
+				/// <summary>
+				/// Retrieves the encryption of the stored file.
+				/// </summary>
+				property EEncryption Encryption { EEncryption get(); }
+
+				/// <summary>
+				/// Checks if the stored file is compressed.
+				/// </summary>
+				property System::Boolean IsCompressed { System::Boolean get(); }
 
 			private:
 				System::String^ _FileName;
-				System::Int32 _Size;
-				System::Int32 _CompressedSize;
+				System::Int64 _Size;
+				System::Int64 _CompressedSize;
+				System::Int32 _BlockIndex;
+				LCID _Locale;
+				System::UInt32 _Flags;
+				System::Int64 _Position;
+				ECompression _Compression;
+				System::String^ _ArchiveFileName;
+				System::Int32 _SectorSize;
+				System::UInt32 _BlockPosition;
+				System::Boolean _IsNamed;
 		};
 	}
 }
@@ -39,9 +39,104 @@ MpqLib::Mpq::CFileStream::CFileStream(CArchive^ Archive, System::String^ FileNam
 	
 	_Length = 0;
 	_Position = 0;
-	_Cache = new std::vector<System::Byte>();
+	_Cache = NULL;
+	_CacheSize = 0;
+	_CacheLock = gcnew System::Object();
+	_MemoryBudget = nullptr;
+	_BufferPool = nullptr;
+	_Reclaimer = gcnew System::Func<System::Int64>(this, &CFileStream::Reclaim);
+	_BlockIndex = CConstants::InvalidIndex;
+	_SectorReader = nullptr;
+	_SectorReaderCreated = false;
+	_SectorReaderGeneration = 0;
+	_TraceSink = nullptr;
+
+	if(!Open((Archive != nullptr) ? Archive->Locale : LANG_NEUTRAL, true)) throw gcnew System::IO::FileNotFoundException("Could not find \"" + FileName + "\"!", FileName);
+}
 
-	Open();
+MpqLib::Mpq::CFileStream::CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale)
+{
+	_Disposed = false;
+
+	_Handle = INVALID_HANDLE_VALUE;
+	_FileName = FileName;
+	_Archive = Archive;
+	
+	_Length = 0;
+	_Position = 0;
+	_Cache = NULL;
+	_CacheSize = 0;
+	_CacheLock = gcnew System::Object();
+	_MemoryBudget = nullptr;
+	_BufferPool = nullptr;
+	_Reclaimer = gcnew System::Func<System::Int64>(this, &CFileStream::Reclaim);
+	_BlockIndex = CConstants::InvalidIndex;
+	_SectorReader = nullptr;
+	_SectorReaderCreated = false;
+	_SectorReaderGeneration = 0;
+	_TraceSink = nullptr;
+
+	if(!Open(Locale, true)) throw gcnew System::IO::FileNotFoundException("Could not find \"" + FileName + "\"!", FileName);
+}
+
+MpqLib::Mpq::CFileStream::CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload)
+{
+	_Disposed = false;
+
+	_Handle = INVALID_HANDLE_VALUE;
+	_FileName = FileName;
+	_Archive = Archive;
+	
+	_Length = 0;
+	_Position = 0;
+	_Cache = NULL;
+	_CacheSize = 0;
+	_CacheLock = gcnew System::Object();
+	_MemoryBudget = nullptr;
+	_BufferPool = nullptr;
+	_Reclaimer = gcnew System::Func<System::Int64>(this, &CFileStream::Reclaim);
+	_BlockIndex = CConstants::InvalidIndex;
+	_SectorReader = nullptr;
+	_SectorReaderCreated = false;
+	_SectorReaderGeneration = 0;
+	_TraceSink = nullptr;
+
+	if(!Open(Locale, Preload)) throw gcnew System::IO::FileNotFoundException("Could not find \"" + FileName + "\"!", FileName);
+}
+
+MpqLib::Mpq::CFileStream::CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload, System::Boolean% IsOpen)
+{
+	_Disposed = false;
+
+	_Handle = INVALID_HANDLE_VALUE;
+	_FileName = FileName;
+	_Archive = Archive;
+	
+	_Length = 0;
+	_Position = 0;
+	_Cache = NULL;
+	_CacheSize = 0;
+	_CacheLock = gcnew System::Object();
+	_MemoryBudget = nullptr;
+	_BufferPool = nullptr;
+	_Reclaimer = gcnew System::Func<System::Int64>(this, &CFileStream::Reclaim);
+	_BlockIndex = CConstants::InvalidIndex;
+	_SectorReader = nullptr;
+	_SectorReaderCreated = false;
+	_SectorReaderGeneration = 0;
+	_TraceSink = nullptr;
+
+	IsOpen = Open(Locale, Preload);
+}
+
+MpqLib::Mpq::CFileStream^ MpqLib::Mpq::CFileStream::TryOpen(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload)
+{
+	System::Boolean IsOpen = false;
+	CFileStream^ FileStream = gcnew CFileStream(Archive, FileName, Locale, Preload, IsOpen);
+	if(IsOpen) return FileStream;
+
+	delete FileStream;
+	return nullptr;
 }
 
 MpqLib::Mpq::CFileStream::~CFileStream()
@@ -67,18 +162,18 @@ array<System::Byte>^ MpqLib::Mpq::CFileStream::Read(System::Int32 Size)
 {
 	CheckBadState();
 
-	System::Int32 BytesToRead = (_Position + Size > _Length) ? static_cast<System::Int32>(_Length - _Position) : Size;
+	System::Int64 BytesToRead = System::Math::Min(static_cast<System::Int64>(Size), _Length - _Position);
 	if(BytesToRead < 0) return nullptr;
 
-	array<System::Byte>^ Buffer = gcnew array<System::Byte>(BytesToRead);
+	array<System::Byte>^ Buffer = gcnew array<System::Byte>(static_cast<System::Int32>(BytesToRead));
 	if(BytesToRead == 0) return Buffer;
 
-	Read(Buffer, 0, BytesToRead);
+	Read(Buffer, 0, Buffer->Length);
 
 	return Buffer;
 }
 
-array<System::Byte>^ MpqLib::Mpq::CFileStream::Read(System::Int32 Position, System::Int32 Size)
+array<System::Byte>^ MpqLib::Mpq::CFileStream::Read(System::Int64 Position, System::Int32 Size)
 {
 	CheckBadState();
 
@@ -93,11 +188,52 @@ System::Int32 MpqLib::Mpq::CFileStream::Read(array<System::Byte>^ Buffer, System
 
 	if(Size <= 0) return 0;
 
-	System::Int32 BytesToRead = (_Position + Size > _Length) ? static_cast<System::Int32>(_Length - _Position) : Size;
-	System::Runtime::InteropServices::Marshal::Copy(static_cast<System::IntPtr>(&((*_Cache)[static_cast<System::Int32>(_Position)])), Buffer, Index, BytesToRead);
-	_Position += BytesToRead;
+	System::Int32 TraceSize = 0;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "Read", _Archive->FileName, _FileName);
+
+	try
+	{
+		msclr::lock Lock(_CacheLock);
+
+		System::Int32 BytesToRead = static_cast<System::Int32>(System::Math::Min(static_cast<System::Int64>(Size), _Length - _Position));
+		if(BytesToRead <= 0) return 0;
 
-	return BytesToRead;
+		if(_Cache != NULL)
+		{
+			System::Runtime::InteropServices::Marshal::Copy(static_cast<System::IntPtr>(&((*_Cache)[static_cast<std::size_t>(_Position)])), Buffer, Index, BytesToRead);
+		}
+		else
+		{
+			//Not cached, only the sectors covering the range are decompressed
+			pin_ptr<System::Byte> BufferPointer = &Buffer[Index];
+			System::Int32 BytesDecoded = (GetSectorReader() != nullptr) ? ReadSectors(_Position, BufferPointer, BytesToRead) : CConstants::InvalidIndex;
+
+			if(BytesDecoded != CConstants::InvalidIndex)
+			{
+				_Position += BytesDecoded;
+				TraceSize = BytesDecoded;
+
+				return BytesDecoded;
+			}
+
+			LONG PositionHigh = static_cast<LONG>(_Position >> 32);
+			DWORD BytesRead = 0;
+
+			if(SFileSetFilePointer(_Handle, static_cast<LONG>(_Position), &PositionHigh, FILE_BEGIN) == SFILE_INVALID_POS) throw gcnew System::IO::IOException("Seek operation failed!");
+			if(!SFileReadFile(_Handle, BufferPointer, static_cast<DWORD>(BytesToRead), &BytesRead, NULL) && (GetLastError() != ERROR_HANDLE_EOF)) throw gcnew System::IO::IOException("Read operation failed!");
+
+			BytesToRead = static_cast<System::Int32>(BytesRead);
+		}
+
+		_Position += BytesToRead;
+		TraceSize = BytesToRead;
+
+		return BytesToRead;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "Read", _Archive->FileName, _FileName, TraceStart, TraceSize, _TraceCompression);
+	}
 }
 
 System::Void MpqLib::Mpq::CFileStream::Write(array<System::Byte>^ Buffer, System::Int32 Index, System::Int32 Size)
@@ -218,6 +354,13 @@ System::Int64 MpqLib::Mpq::CFileStream::CompressedLength::get()
 	return val;
 }
 
+System::Boolean MpqLib::Mpq::CFileStream::IsCached::get()
+{
+	CheckBadState();
+
+	return (_Cache != NULL);
+}
+
 LCID MpqLib::Mpq::CFileStream::Locale::get()
 {
 	CheckBadState();
@@ -272,50 +415,228 @@ System::Boolean MpqLib::Mpq::CFileStream::IsDisposed::get()
 	return _Disposed;
 }
 
-System::Void MpqLib::Mpq::CFileStream::Open()
+System::Boolean MpqLib::Mpq::CFileStream::Open(LCID Locale, System::Boolean Preload)
 {
 	System::Int32 BytesRead = 0;
-	pin_ptr<HANDLE> HandlePointer = &_Handle;
-	CStringHandle FileNameHandle(_FileName);
 
 	if(_Archive == nullptr) throw gcnew System::InvalidOperationException("The file stream has no associated archive!");
 	if(_Archive->IsDisposed) throw gcnew System::ObjectDisposedException(nullptr, "The archive of the file stream has been disposed!");
 	if((_Archive->Handle == NULL) || (_Archive->Handle == INVALID_HANDLE_VALUE)) throw gcnew System::InvalidOperationException("The archive of the file stream has been closed!");
 
-	if(!_Archive->FileExists(_FileName)) throw gcnew System::IO::FileNotFoundException("Could not find \"" + _FileName + "\"!", _FileName);
-	if(!SFileOpenFileEx(_Archive->Handle, FileNameHandle.Value, SFILE_OPEN_FROM_MPQ, HandlePointer)) throw gcnew System::IO::IOException("Unable to open \"" + _FileName + "\"!");
+	_TraceSink = _Archive->TraceSink;
+	System::Int64 TraceStart = CTracer::Begin(_TraceSink, "OpenFile", _Archive->FileName, _FileName);
 
-	//MHE
-	System::Int64 val = 0;
-	DWORD pcbLengthNeeded = 32;
-	SFileGetFileInfo(_Handle, SFILE_INFO_FILE_SIZE,&val,32,&pcbLengthNeeded);
+	//The archive refuses to rewrite its tables under an open stream
+	_Archive->AttachReader(this);
+
+	try
+	{
+		//The open resolves the name once, a missing file is reported from that same probe
+		_Handle = _Archive->TryOpenFile(_FileName, Locale, _BlockIndex);
 
-	_Length = static_cast<int>(val);
-	if(_Length < 0) _Length = 0;
+		if(_Handle == NULL)
+		{
+			_Archive->DetachReader(this);
+			return false;
+		}
 
-	_Cache->resize(static_cast<System::UInt32>(_Length));
+		//The codec is only looked up for the traces, untraced streams do not pay for it
+		if(_TraceSink != nullptr) _TraceCompression = _Archive->ProbeCompression(_FileName, _BlockIndex);
 
-	if(!SFileReadFile(_Handle, &((*_Cache)[0]), static_cast<DWORD>(_Length), reinterpret_cast<LPDWORD>(&BytesRead), NULL)) throw gcnew System::IO::IOException("Read operation failed!");
-	if(_Length != static_cast<System::Int64>(BytesRead)) throw gcnew System::IO::IOException("Read failed, expected " + _Length + " bytes, read " + BytesRead + " bytes!");
+		//MHE
+		System::Int64 val = 0;
+		DWORD pcbLengthNeeded = 32;
+		SFileGetFileInfo(_Handle, SFILE_INFO_FILE_SIZE,&val,32,&pcbLengthNeeded);
 
-	_Position = 0;
+		_Length = val;
+
+		_Position = 0;
+		_MemoryBudget = _Archive->MemoryBudget;
+		_BufferPool = _Archive->BufferPool;
+
+		//Files that do not fit the budget (or a single buffer) are streamed from the archive instead of being cached,
+		//the budget is charged with the whole pooled buffer rather than the part of it the file fills
+		if(!Preload || (_Length > System::Int32::MaxValue)) return true;
+
+		System::Int64 CacheSize = (_Length > 0) ? CBufferPool::GetRentSize(static_cast<System::Int32>(_Length)) : 0;
+		if((CacheSize > 0) && !_MemoryBudget->TryReserve(CacheSize, _Reclaimer)) return true;
+
+		_Cache = _BufferPool->Rent(static_cast<System::Int32>(_Length));
+		_CacheSize = CacheSize;
+		if(_CacheSize > 0) System::GC::AddMemoryPressure(_CacheSize);
+
+		if(_Length == 0) return true;
+
+		//Blocks the library can decode itself are expanded in parallel, straight into the cache (smaller ones gain nothing over StormLib)
+		if(_Length >= CConstants::ParallelDecodeMinSize)
+		{
+			if((GetSectorReader() != nullptr) && (ReadSectors(0, &((*_Cache)[0]), static_cast<System::Int32>(_Length)) == _Length)) return true;
+		}
+
+		if(!SFileReadFile(_Handle, &((*_Cache)[0]), static_cast<DWORD>(_Length), reinterpret_cast<LPDWORD>(&BytesRead), NULL)) throw gcnew System::IO::IOException("Read operation failed!");
+		if(_Length != static_cast<System::Int64>(BytesRead)) throw gcnew System::IO::IOException("Read failed, expected " + _Length + " bytes, read " + BytesRead + " bytes!");
+
+		return true;
+	}
+	catch(System::Exception^)
+	{
+		//A stream that failed to open is never closed by its owner, it lets go of the handle and the archive here
+		if((_Handle != NULL) && (_Handle != INVALID_HANDLE_VALUE)) SFileCloseFile(_Handle);
+		_Handle = NULL;
+
+		_Archive->DetachReader(this);
+		throw;
+	}
+	finally
+	{
+		CTracer::End(_TraceSink, "OpenFile", _Archive->FileName, _FileName, TraceStart, (_Cache != NULL) ? _Length : 0, _TraceCompression);
+	}
 }
 
-System::Void MpqLib::Mpq::CFileStream::Cleanup(System::Boolean CleanupManagedStuff)
+System::Int32 MpqLib::Mpq::CFileStream::ReadSectors(System::Int64 Position, BYTE* Output, System::Int32 Count)
 {
-	UNREFERENCED_PARAMETER(CleanupManagedStuff);
+	try
+	{
+		return _SectorReader->Read(Position, Output, Count);
+	}
+	catch(System::IO::InvalidDataException^)
+	{
+	}
+	catch(System::IO::EndOfStreamException^)
+	{
+	}
+
+	//A block the library fails to decode after all is left to StormLib from here on
+	delete _SectorReader;
+	_SectorReader = nullptr;
 
-	if(_Handle != NULL)
+	return CConstants::InvalidIndex;
+}
+
+MpqLib::Mpq::CSectorReader^ MpqLib::Mpq::CFileStream::GetSectorReader()
+{
+	//The position of the block was taken from the archive as it was, a reopened archive may have moved it
+	if(_SectorReaderCreated && (_SectorReaderGeneration != _Archive->Generation))
 	{
-		SFileCloseFile(_Handle);
-		_Handle = NULL;
+		if(_SectorReader != nullptr) delete _SectorReader;
+		_SectorReader = nullptr;
+		_SectorReaderCreated = false;
+
+		DWORD FileBlockIndex = 0;
+		DWORD LengthNeeded = 0;
+		_BlockIndex = SFileGetFileInfo(_Handle, SFILE_INFO_BLOCKINDEX, &FileBlockIndex, sizeof(DWORD), &LengthNeeded) ? static_cast<System::Int32>(FileBlockIndex) : CConstants::InvalidIndex;
 	}
 
+	if(!_SectorReaderCreated)
+	{
+		_SectorReaderGeneration = _Archive->Generation;
+		_SectorReader = CreateSectorReader();
+		_SectorReaderCreated = true;
+	}
+
+	return _SectorReader;
+}
+
+MpqLib::Mpq::CSectorReader^ MpqLib::Mpq::CFileStream::CreateSectorReader()
+{
+	CArchiveIndex^ ArchiveIndex = _Archive->Index;
+	if((_BlockIndex == CConstants::InvalidIndex) || (_BlockIndex >= ArchiveIndex->BlockTableSize)) return nullptr;
+
+	SBlockEntry BlockEntry = ArchiveIndex->GetBlockEntry(_BlockIndex);
+	if(!CBlockDecoder::CanDecode(BlockEntry, true)) return nullptr;
+
+	CStringHandle FileNameHandle(_FileName);
+	CArchiveHeader^ Header = _Archive->Header;
+	DWORD Key = (BlockEntry.Flags & MPQ_FILE_ENCRYPTED) ? CCryptography::GetFileKey(FileNameHandle.Value, BlockEntry) : 0;
+
+	//Blocks the reader can not make sense of are left to StormLib
+	try
+	{
+		return gcnew CSectorReader(_Archive->FileName, Header->ArchiveOffset + ArchiveIndex->GetBlockPosition(_BlockIndex), BlockEntry, Key, Header->SectorSize);
+	}
+	catch(System::IO::InvalidDataException^)
+	{
+		return nullptr;
+	}
+	catch(System::IO::EndOfStreamException^)
+	{
+		return nullptr;
+	}
+}
+
+System::Int64 MpqLib::Mpq::CFileStream::ReleaseCache()
+{
+	System::Int64 ReleasedSize = _CacheSize;
+
 	if(_Cache != NULL)
 	{
-		delete _Cache;
+		_BufferPool->Return(_Cache);
 		_Cache = NULL;
 	}
+
+	if(_CacheSize > 0)
+	{
+		_CacheSize = 0;
+
+		System::GC::RemoveMemoryPressure(ReleasedSize);
+		_MemoryBudget->Release(ReleasedSize, _Reclaimer);
+	}
+
+	return ReleasedSize;
+}
+
+System::Int64 MpqLib::Mpq::CFileStream::Reclaim()
+{
+	//Called from other threads, a stream busy reading is left alone
+	if(!System::Threading::Monitor::TryEnter(_CacheLock)) return 0;
+
+	try
+	{
+		if(_Disposed || (_CacheSize == 0)) return 0;
+
+		return ReleaseCache();
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit(_CacheLock);
+	}
+}
+
+System::Void MpqLib::Mpq::CFileStream::Cleanup(System::Boolean CleanupManagedStuff)
+{
+	if((_Handle != NULL) && (_Handle != INVALID_HANDLE_VALUE))
+	{
+		SFileCloseFile(_Handle);
+		_Handle = NULL;
+	}
+
+	//The pool and the budget are managed objects that may be finalized already, the budget drops the reservation of a collected stream itself
+	if(!CleanupManagedStuff)
+	{
+		if(_Cache != NULL)
+		{
+			delete _Cache;
+			_Cache = NULL;
+		}
+
+		if(_CacheSize > 0)
+		{
+			System::GC::RemoveMemoryPressure(_CacheSize);
+			_CacheSize = 0;
+		}
+
+		return;
+	}
+
+	if(_SectorReader != nullptr)
+	{
+		delete _SectorReader;
+		_SectorReader = nullptr;
+	}
+
+	if(_Archive != nullptr) _Archive->DetachReader(this);
+
+	ReleaseCache();
 }
 
 System::Void MpqLib::Mpq::CFileStream::CheckBadState()
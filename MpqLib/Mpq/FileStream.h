@@ -30,6 +30,7 @@
 #pragma once
 
 #include "Archive.h"
+#include "SectorReader.h"
 
 namespace MpqLib
 {
@@ -38,6 +39,8 @@ namespace MpqLib
 		/// <summary>
 		/// Represents a file inside an MPQ archive. The stream is readonly.
 		/// Use the archive Import-methods to update files in the archive.
+		/// The file is cached in memory as long as the memory budget of the archive allows it,
+		/// otherwise only the sectors covering a read are decompressed.
 		/// </summary>
 		public ref class CFileStream sealed : System::IO::Stream
 		{
@@ -49,6 +52,33 @@ namespace MpqLib
 				/// <param name="FileName">The file to stream</param>
 				CFileStream(CArchive^ Archive, System::String^ FileName);
 
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Archive">The archive to stream a file from</param>
+				/// <param name="FileName">The file to stream</param>
+				/// <param name="Locale">Which locale version of the file to stream</param>
+				CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale);
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Archive">The archive to stream a file from</param>
+				/// <param name="FileName">The file to stream</param>
+				/// <param name="Locale">Which locale version of the file to stream</param>
+				/// <param name="Preload">True to decompress the whole file up front, false to decompress the sectors covering each read on demand</param>
+				CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload);
+
+				/// <summary>
+				/// Opens a file if it exists, without throwing when it does not.
+				/// </summary>
+				/// <param name="Archive">The archive to stream a file from</param>
+				/// <param name="FileName">The file to stream</param>
+				/// <param name="Locale">Which locale version of the file to stream</param>
+				/// <param name="Preload">True to decompress the whole file up front, false to decompress the sectors covering each read on demand</param>
+				/// <returns>The opened file, or null if the archive has no such file</returns>
+				static CFileStream^ TryOpen(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload);
+
 				/// <summary>
 				/// Releases all resources used by the MpqLib.Mpq.CFileStream.
 				/// </summary>
@@ -77,7 +107,7 @@ namespace MpqLib
 				/// <param name="Position">The position to start reading at</param>
 				/// <param name="Size">The (maximum) number of bytes to read</param>
 				/// <returns>An array containing the bytes read</returns>
-				array<System::Byte>^ Read(System::Int32 Position, System::Int32 Size);
+				array<System::Byte>^ Read(System::Int64 Position, System::Int32 Size);
 
 				/// <summary>
 				/// Reads a number of bytes from the file to a buffer, starting at the current position.
@@ -151,6 +181,11 @@ namespace MpqLib
 				/// </summary>
 				property System::Int64 CompressedLength { System::Int64 get(); }
 
+				/// <summary>
+				/// Checks if the file is cached in memory (otherwise it is read from the archive on demand).
+				/// </summary>
+				property System::Boolean IsCached { System::Boolean get(); }
+
 				/// <summary>
 				/// Gets or sets the file locale (for language specific files).
 				/// </summary>
@@ -182,7 +217,14 @@ namespace MpqLib
 				property System::Boolean IsDisposed { System::Boolean get(); }
 
 			private:
-				System::Void Open();
+				CFileStream(CArchive^ Archive, System::String^ FileName, LCID Locale, System::Boolean Preload, System::Boolean% IsOpen);
+
+				System::Boolean Open(LCID Locale, System::Boolean Preload);
+				CSectorReader^ GetSectorReader();
+				CSectorReader^ CreateSectorReader();
+				System::Int32 ReadSectors(System::Int64 Position, BYTE* Output, System::Int32 Count);
+				System::Int64 ReleaseCache();
+				System::Int64 Reclaim();
 				System::Void Cleanup(System::Boolean CleanupManagedStuff);
 				System::Void CheckBadState();
 
@@ -194,6 +236,17 @@ namespace MpqLib
 				System::Int64 _Length;
 				System::Int64 _Position;
 				std::vector<System::Byte>* _Cache;
+				System::Int64 _CacheSize;
+				System::Object^ _CacheLock;
+				CMemoryBudget^ _MemoryBudget;
+				CBufferPool^ _BufferPool;
+				System::Func<System::Int64>^ _Reclaimer;
+				System::Int32 _BlockIndex;
+				CSectorReader^ _SectorReader;
+				System::Boolean _SectorReaderCreated;
+				System::Int32 _SectorReaderGeneration;
+				ITraceSink^ _TraceSink;
+				System::Nullable<ECompression> _TraceCompression;
 
 				System::Object^ _Tag;
 				System::Boolean _Disposed;
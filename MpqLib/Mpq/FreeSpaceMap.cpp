@@ -0,0 +1,156 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "FreeSpaceMap.h"
+
+MpqLib::Mpq::CFreeSpaceMap::CFreeSpaceMap(System::Int64 DataStart, System::Int64 DataEnd, array<System::Int64>^ Positions, array<System::Int64>^ Sizes)
+{
+	_DataEnd = DataEnd;
+	_FreeSize = 0;
+	_ExtentPositions = gcnew System::Collections::Generic::List<System::Int64>();
+	_ExtentSizes = gcnew System::Collections::Generic::List<System::Int64>();
+
+	array<System::Int64>^ SortedPositions = safe_cast<array<System::Int64>^>(Positions->Clone());
+	array<System::Int64>^ SortedSizes = safe_cast<array<System::Int64>^>(Sizes->Clone());
+	System::Array::Sort(SortedPositions, SortedSizes);
+
+	//Everything not covered by a block is free, blocks may overlap (or even share their data)
+	System::Int64 Position = DataStart;
+
+	for(System::Int32 i = 0; (i < SortedPositions->Length) && (Position < DataEnd); i++)
+	{
+		System::Int64 BlockStart = System::Math::Min(SortedPositions[i], DataEnd);
+
+		if(BlockStart > Position)
+		{
+			_ExtentPositions->Add(Position);
+			_ExtentSizes->Add(BlockStart - Position);
+			_FreeSize += BlockStart - Position;
+		}
+
+		Position = System::Math::Max(Position, SortedPositions[i] + SortedSizes[i]);
+	}
+
+	if(Position < DataEnd)
+	{
+		_ExtentPositions->Add(Position);
+		_ExtentSizes->Add(DataEnd - Position);
+		_FreeSize += DataEnd - Position;
+	}
+}
+
+System::Int64 MpqLib::Mpq::CFreeSpaceMap::Allocate(System::Int64 Size)
+{
+	if(Size <= 0) return CConstants::InvalidIndex;
+
+	System::Int32 BestIndex = CConstants::InvalidIndex;
+
+	//Best fit, the smallest hole the block fits in (an exact fit ends the search)
+	for(System::Int32 i = 0; i < _ExtentSizes->Count; i++)
+	{
+		if(_ExtentSizes[i] < Size) continue;
+		if((BestIndex != CConstants::InvalidIndex) && (_ExtentSizes[i] >= _ExtentSizes[BestIndex])) continue;
+
+		BestIndex = i;
+		if(_ExtentSizes[i] == Size) break;
+	}
+
+	if(BestIndex == CConstants::InvalidIndex) return CConstants::InvalidIndex;
+
+	//The block takes the front of the hole, what is left stays free
+	System::Int64 Position = _ExtentPositions[BestIndex];
+
+	if(_ExtentSizes[BestIndex] == Size)
+	{
+		_ExtentPositions->RemoveAt(BestIndex);
+		_ExtentSizes->RemoveAt(BestIndex);
+	}
+	else
+	{
+		_ExtentPositions[BestIndex] += Size;
+		_ExtentSizes[BestIndex] -= Size;
+	}
+
+	_FreeSize -= Size;
+
+	return Position;
+}
+
+System::Void MpqLib::Mpq::CFreeSpaceMap::Release(System::Int64 Position, System::Int64 Size)
+{
+	if(Size <= 0) return;
+	if((Position + Size) > _DataEnd) throw gcnew System::ArgumentOutOfRangeException("Position", "Only space below the end of the map can be released!");
+
+	//The extents stay sorted by position, a released range is merged with the holes right before and after it
+	System::Int32 Index = _ExtentPositions->BinarySearch(Position);
+	if(Index >= 0) throw gcnew System::ArgumentException("The space is already free!");
+
+	Index = ~Index;
+
+	System::Boolean JoinsPrevious = (Index > 0) && ((_ExtentPositions[Index - 1] + _ExtentSizes[Index - 1]) == Position);
+	System::Boolean JoinsNext = (Index < _ExtentPositions->Count) && (_ExtentPositions[Index] == (Position + Size));
+
+	if(JoinsPrevious && JoinsNext)
+	{
+		_ExtentSizes[Index - 1] += Size + _ExtentSizes[Index];
+		_ExtentPositions->RemoveAt(Index);
+		_ExtentSizes->RemoveAt(Index);
+	}
+	else if(JoinsPrevious)
+	{
+		_ExtentSizes[Index - 1] += Size;
+	}
+	else if(JoinsNext)
+	{
+		_ExtentPositions[Index] = Position;
+		_ExtentSizes[Index] += Size;
+	}
+	else
+	{
+		_ExtentPositions->Insert(Index, Position);
+		_ExtentSizes->Insert(Index, Size);
+	}
+
+	_FreeSize += Size;
+}
+
+System::Int64 MpqLib::Mpq::CFreeSpaceMap::DataEnd::get()
+{
+	return _DataEnd;
+}
+
+System::Int64 MpqLib::Mpq::CFreeSpaceMap::FreeSize::get()
+{
+	return _FreeSize;
+}
+
+System::Int32 MpqLib::Mpq::CFreeSpaceMap::ExtentCount::get()
+{
+	return _ExtentSizes->Count;
+}
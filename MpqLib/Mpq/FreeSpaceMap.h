@@ -0,0 +1,61 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// The holes between the blocks of an archive (left by removed and replaced files) up to a given end.
+		/// New blocks are placed into the smallest hole they fit in, which keeps the large holes for large blocks.
+		/// </summary>
+		private ref class CFreeSpaceMap
+		{
+			public:
+				CFreeSpaceMap(System::Int64 DataStart, System::Int64 DataEnd, array<System::Int64>^ Positions, array<System::Int64>^ Sizes);
+
+				System::Int64 Allocate(System::Int64 Size);
+				System::Void Release(System::Int64 Position, System::Int64 Size);
+
+				property System::Int64 DataEnd { System::Int64 get(); }
+				property System::Int64 FreeSize { System::Int64 get(); }
+				property System::Int32 ExtentCount { System::Int32 get(); }
+
+			private:
+				System::Int64 _DataEnd;
+				System::Int64 _FreeSize;
+				System::Collections::Generic::List<System::Int64>^ _ExtentPositions;
+				System::Collections::Generic::List<System::Int64>^ _ExtentSizes;
+		};
+	}
+}
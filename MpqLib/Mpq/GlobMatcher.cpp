@@ -0,0 +1,92 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "GlobMatcher.h"
+
+MpqLib::Mpq::CGlobMatcher::CGlobMatcher(System::String^ Mask)
+{
+	if(Mask == nullptr) throw gcnew System::ArgumentNullException("Mask");
+
+	_Mask = Mask;
+	_Pattern = Mask->ToUpperInvariant()->ToCharArray();
+
+	System::Int32 FirstWildcard = Mask->IndexOfAny(gcnew array<System::Char>{ L'*', L'?' });
+	System::Int32 LastWildcard = Mask->LastIndexOfAny(gcnew array<System::Char>{ L'*', L'?' });
+
+	//Names are rejected by their literal ends before the wildcards are matched
+	_IsLiteral = (FirstWildcard < 0);
+	_Prefix = _IsLiteral ? Mask : Mask->Substring(0, FirstWildcard);
+	_Suffix = _IsLiteral ? System::String::Empty : Mask->Substring(LastWildcard + 1);
+}
+
+System::Boolean MpqLib::Mpq::CGlobMatcher::IsMatch(System::String^ FileName)
+{
+	if(_IsLiteral) return System::String::Equals(FileName, _Mask, System::StringComparison::OrdinalIgnoreCase);
+	if(FileName->Length < (_Prefix->Length + _Suffix->Length)) return false;
+	if(!FileName->StartsWith(_Prefix, System::StringComparison::OrdinalIgnoreCase)) return false;
+	if(!FileName->EndsWith(_Suffix, System::StringComparison::OrdinalIgnoreCase)) return false;
+
+	//A mismatch after a star retries with the star taking one more character, no deeper backtracking is needed
+	System::Int32 NameIndex = _Prefix->Length;
+	System::Int32 PatternIndex = _Prefix->Length;
+	System::Int32 StarPatternIndex = CConstants::InvalidIndex;
+	System::Int32 StarNameIndex = 0;
+
+	while(NameIndex < FileName->Length)
+	{
+		if((PatternIndex < _Pattern->Length) && ((_Pattern[PatternIndex] == L'?') || (_Pattern[PatternIndex] == System::Char::ToUpperInvariant(FileName[NameIndex]))))
+		{
+			NameIndex++;
+			PatternIndex++;
+		}
+		else if((PatternIndex < _Pattern->Length) && (_Pattern[PatternIndex] == L'*'))
+		{
+			StarPatternIndex = PatternIndex++;
+			StarNameIndex = NameIndex;
+		}
+		else if(StarPatternIndex != CConstants::InvalidIndex)
+		{
+			PatternIndex = StarPatternIndex + 1;
+			NameIndex = ++StarNameIndex;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while((PatternIndex < _Pattern->Length) && (_Pattern[PatternIndex] == L'*')) PatternIndex++;
+
+	return (PatternIndex == _Pattern->Length);
+}
+
+System::String^ MpqLib::Mpq::CGlobMatcher::Prefix::get()
+{
+	return _Prefix;
+}
@@ -0,0 +1,60 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// A file mask compiled for repeated matching, with the wildcard rules of StormLib: '*' matches any
+		/// run of characters (backslashes included), '?' any single character, case is ignored. The literal
+		/// prefix before the first wildcard lets a name trie skip everything outside of it.
+		/// </summary>
+		private ref class CGlobMatcher
+		{
+			public:
+				CGlobMatcher(System::String^ Mask);
+
+				System::Boolean IsMatch(System::String^ FileName);
+
+				property System::String^ Prefix { System::String^ get(); }
+
+			private:
+				System::String^ _Mask;
+				array<System::Char>^ _Pattern;
+				System::String^ _Prefix;
+				System::String^ _Suffix;
+				System::Boolean _IsLiteral;
+		};
+	}
+}
@@ -29,7 +29,9 @@
 //+-----------------------------------------------------------------------------
 #pragma once
 
+#include <stdio.h>
 #include <vector>
 #include <msclr/marshal.h>
+#include <msclr/lock.h>
 
 #include "StormLib.h"
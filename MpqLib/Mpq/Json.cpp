@@ -0,0 +1,62 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "Json.h"
+
+System::String^ MpqLib::Mpq::CJson::FormatString(System::String^ Value)
+{
+	if(Value == nullptr) return "null";
+
+	System::Text::StringBuilder^ Builder = gcnew System::Text::StringBuilder("\"");
+
+	for each(System::Char Character in Value)
+	{
+		switch(Character)
+		{
+		case L'"': Builder->Append("\\\""); break;
+		case L'\\': Builder->Append("\\\\"); break;
+		default:
+			{
+				if(Character < L' ') Builder->Append("\\u" + static_cast<System::Int32>(Character).ToString("x4"));
+				else Builder->Append(Character);
+				break;
+			}
+		}
+	}
+
+	return Builder->Append("\"")->ToString();
+}
+
+System::String^ MpqLib::Mpq::CJson::FormatNumber(System::Double Value)
+{
+	//JSON has no culture, nor a notation for infinity (the speed of samples too small to time)
+	if(System::Double::IsNaN(Value) || System::Double::IsInfinity(Value)) return "null";
+
+	return Value.ToString("R", System::Globalization::CultureInfo::InvariantCulture);
+}
@@ -0,0 +1,149 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "MemoryBudget.h"
+
+MpqLib::Mpq::CMemoryBudget::CMemoryBudget()
+{
+	_Limit = System::Int64::MaxValue;
+	_UsedSize = 0;
+	_Reclaimers = gcnew System::Collections::Generic::LinkedList<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >();
+	_Lock = gcnew System::Object();
+}
+
+MpqLib::Mpq::CMemoryBudget::CMemoryBudget(System::Int64 Limit)
+{
+	if(Limit < 0) throw gcnew System::ArgumentOutOfRangeException("Limit", "The limit can not be negative!");
+
+	_Limit = Limit;
+	_UsedSize = 0;
+	_Reclaimers = gcnew System::Collections::Generic::LinkedList<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >();
+	_Lock = gcnew System::Object();
+}
+
+System::Int64 MpqLib::Mpq::CMemoryBudget::Limit::get()
+{
+	return _Limit;
+}
+
+System::Void MpqLib::Mpq::CMemoryBudget::Limit::set(System::Int64 Limit)
+{
+	if(Limit < 0) throw gcnew System::ArgumentOutOfRangeException("Limit", "The limit can not be negative!");
+
+	_Limit = Limit;
+}
+
+System::Int64 MpqLib::Mpq::CMemoryBudget::UsedSize::get()
+{
+	return System::Threading::Interlocked::Read(_UsedSize);
+}
+
+System::Boolean MpqLib::Mpq::CMemoryBudget::TryReserve(System::Int64 Size, System::Func<System::Int64>^ Reclaimer)
+{
+	if(Size > _Limit) return false;
+
+	if(!TryReserve(Size))
+	{
+		System::Collections::Generic::List<System::Func<System::Int64>^>^ Candidates = gcnew System::Collections::Generic::List<System::Func<System::Int64>^>();
+
+		{
+			msclr::lock Lock(_Lock);
+
+			for each(System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> Reservation in _Reclaimers)
+			{
+				System::Func<System::Int64>^ Candidate = dynamic_cast<System::Func<System::Int64>^>(Reservation.Key->Target);
+				if(Candidate != nullptr) Candidates->Add(Candidate);
+			}
+		}
+
+		//Reclaiming is done outside the lock, a holder releases its memory through Release
+		System::Boolean Reserved = false;
+
+		for each(System::Func<System::Int64>^ Candidate in Candidates)
+		{
+			if(Candidate() > 0) Reserved = TryReserve(Size);
+			if(Reserved) break;
+		}
+
+		if(!Reserved) return false;
+	}
+
+	msclr::lock Lock(_Lock);
+
+	_Reclaimers->AddLast(System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64>(gcnew System::WeakReference(Reclaimer), Size));
+
+	return true;
+}
+
+System::Void MpqLib::Mpq::CMemoryBudget::Release(System::Int64 Size, System::Func<System::Int64>^ Reclaimer)
+{
+	msclr::lock Lock(_Lock);
+
+	_UsedSize -= Size;
+
+	for(System::Collections::Generic::LinkedListNode<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >^ Node = _Reclaimers->First; Node != nullptr; Node = Node->Next)
+	{
+		if(Node->Value.Key->Target != Reclaimer) continue;
+
+		_Reclaimers->Remove(Node);
+		break;
+	}
+
+	DropCollectedReclaimers();
+}
+
+System::Boolean MpqLib::Mpq::CMemoryBudget::TryReserve(System::Int64 Size)
+{
+	msclr::lock Lock(_Lock);
+
+	DropCollectedReclaimers();
+	if(_UsedSize > (_Limit - Size)) return false;
+
+	_UsedSize += Size;
+	return true;
+}
+
+System::Void MpqLib::Mpq::CMemoryBudget::DropCollectedReclaimers()
+{
+	msclr::lock Lock(_Lock);
+
+	//Streams are never released from their finalizer, the memory of the ones collected without being disposed is given back here
+	for(System::Collections::Generic::LinkedListNode<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >^ Node = _Reclaimers->First; Node != nullptr; )
+	{
+		System::Collections::Generic::LinkedListNode<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >^ Next = Node->Next;
+
+		if(!Node->Value.Key->IsAlive)
+		{
+			_UsedSize -= Node->Value.Value;
+			_Reclaimers->Remove(Node);
+		}
+
+		Node = Next;
+	}
+}
@@ -0,0 +1,82 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// A limit on the memory used for decompressed file data. Each archive has its own
+		/// budget, assign the same budget to several archives to share a (process-wide) limit.
+		/// When a request does not fit, memory held by the oldest file streams is reclaimed first.
+		/// </summary>
+		public ref class CMemoryBudget sealed
+		{
+			public:
+				/// <summary>
+				/// Default constructor, creates an unlimited budget.
+				/// </summary>
+				CMemoryBudget();
+
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Limit">The maximum number of bytes to use</param>
+				CMemoryBudget(System::Int64 Limit);
+
+				/// <summary>
+				/// Gets or sets the maximum number of bytes to use.
+				/// </summary>
+				property System::Int64 Limit { System::Int64 get(); System::Void set(System::Int64 Limit); }
+
+				/// <summary>
+				/// Retrieves the number of bytes in use.
+				/// </summary>
+				property System::Int64 UsedSize { System::Int64 get(); }
+
+			internal:
+				System::Boolean TryReserve(System::Int64 Size, System::Func<System::Int64>^ Reclaimer);
+				System::Void Release(System::Int64 Size, System::Func<System::Int64>^ Reclaimer);
+
+			private:
+				System::Boolean TryReserve(System::Int64 Size);
+				System::Void DropCollectedReclaimers();
+
+			private:
+				System::Int64 _Limit;
+				System::Int64 _UsedSize;
+				System::Collections::Generic::LinkedList<System::Collections::Generic::KeyValuePair<System::WeakReference^, System::Int64> >^ _Reclaimers;
+				System::Object^ _Lock;
+		};
+	}
+}
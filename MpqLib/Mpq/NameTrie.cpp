@@ -0,0 +1,224 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "NameTrie.h"
+
+MpqLib::Mpq::CNameTrie::CNameTrie()
+{
+	_Root = gcnew CNameTrieNode();
+	_Entries = gcnew System::Collections::Generic::List<SNameEntry>();
+	_EntryIndices = gcnew System::Collections::Generic::Dictionary<System::String^, System::Int32>(System::StringComparer::OrdinalIgnoreCase);
+	_DeadEntryCount = 0;
+	_Lock = gcnew System::Object();
+}
+
+System::Void MpqLib::Mpq::CNameTrie::Add(SNameEntry Entry)
+{
+	msclr::lock Lock(_Lock);
+
+	//A name imported again replaces its entry, the slot keeps its place in the order of the names
+	System::String^ Key = GetKey(Entry.FileName, Entry.Locale);
+	System::Int32 EntryIndex;
+
+	if(_EntryIndices->TryGetValue(Key, EntryIndex))
+	{
+		_Entries[EntryIndex] = Entry;
+		return;
+	}
+
+	GetNode(Entry.FileName, true)->Entries->Add(_Entries->Count);
+	_EntryIndices->Add(Key, _Entries->Count);
+	_Entries->Add(Entry);
+}
+
+System::Boolean MpqLib::Mpq::CNameTrie::Remove(System::String^ FileName, LCID Locale)
+{
+	msclr::lock Lock(_Lock);
+
+	System::String^ Key = GetKey(FileName, Locale);
+	System::Int32 EntryIndex;
+	if(!_EntryIndices->TryGetValue(Key, EntryIndex)) return false;
+
+	//The slot is left empty, the numbers of the other entries (and thereby their order) stay as they are
+	GetNode(FileName, false)->Entries->Remove(EntryIndex);
+	_EntryIndices->Remove(Key);
+	_Entries[EntryIndex] = SNameEntry();
+
+	//Once most slots are empty the entries are numbered again, which keeps the cost of that linear in the removals
+	if((++_DeadEntryCount >= CConstants::NameTrieMinDeadEntries) && ((_DeadEntryCount * 2) > _Entries->Count)) Compact();
+
+	return true;
+}
+
+System::Collections::Generic::List<MpqLib::Mpq::SNameEntry>^ MpqLib::Mpq::CNameTrie::Find(CGlobMatcher^ Matcher)
+{
+	System::Collections::Generic::List<System::Int32>^ EntryList = gcnew System::Collections::Generic::List<System::Int32>();
+	System::Collections::Generic::List<SNameEntry>^ Entries = gcnew System::Collections::Generic::List<SNameEntry>();
+	System::String^ Prefix = Matcher->Prefix;
+
+	msclr::lock Lock(_Lock);
+
+	//The whole directories of the prefix are followed down, the partial name after them limits the subdirectories
+	CNameTrieNode^ Node = _Root;
+	System::Int32 Start = 0;
+
+	for(System::Int32 Separator = Prefix->IndexOf(L'\\'); Separator >= 0; Separator = Prefix->IndexOf(L'\\', Start))
+	{
+		Node = Node->GetChild(Prefix->Substring(Start, Separator - Start));
+		if(Node == nullptr) return Entries;
+
+		Start = Separator + 1;
+	}
+
+	System::String^ PartialName = Prefix->Substring(Start);
+	System::Collections::Generic::Stack<CNameTrieNode^>^ Pending = gcnew System::Collections::Generic::Stack<CNameTrieNode^>();
+
+	for each(System::Collections::Generic::KeyValuePair<System::String^, CNameTrieNode^> Child in Node->Children)
+	{
+		if(Child.Key->StartsWith(PartialName, System::StringComparison::OrdinalIgnoreCase)) Pending->Push(Child.Value);
+	}
+
+	AddMatches(Node, Matcher, EntryList);
+
+	while(Pending->Count > 0)
+	{
+		Node = Pending->Pop();
+
+		for each(CNameTrieNode^ Child in Node->Children->Values) Pending->Push(Child);
+		AddMatches(Node, Matcher, EntryList);
+	}
+
+	//Entries are numbered in the order they were added, sorting restores that order
+	EntryList->Sort();
+
+	for each(System::Int32 EntryIndex in EntryList) Entries->Add(_Entries[EntryIndex]);
+
+	return Entries;
+}
+
+System::Collections::Generic::List<MpqLib::Mpq::SNameEntry>^ MpqLib::Mpq::CNameTrie::FindName(System::String^ FileName)
+{
+	System::Collections::Generic::List<System::Int32>^ EntryList = gcnew System::Collections::Generic::List<System::Int32>();
+	System::Collections::Generic::List<SNameEntry>^ Entries = gcnew System::Collections::Generic::List<SNameEntry>();
+
+	msclr::lock Lock(_Lock);
+
+	//Only the directory of the name is visited, every locale of the name is returned
+	CNameTrieNode^ Node = GetNode(FileName, false);
+	if(Node == nullptr) return Entries;
+
+	for each(System::Int32 EntryIndex in Node->Entries)
+	{
+		if(System::String::Compare(_Entries[EntryIndex].FileName, FileName, true) == 0) EntryList->Add(EntryIndex);
+	}
+
+	EntryList->Sort();
+
+	for each(System::Int32 EntryIndex in EntryList) Entries->Add(_Entries[EntryIndex]);
+
+	return Entries;
+}
+
+System::Int32 MpqLib::Mpq::CNameTrie::Count::get()
+{
+	msclr::lock Lock(_Lock);
+
+	return _EntryIndices->Count;
+}
+
+MpqLib::Mpq::CNameTrieNode^ MpqLib::Mpq::CNameTrie::GetNode(System::String^ FileName, System::Boolean Create)
+{
+	CNameTrieNode^ Node = _Root;
+	System::Int32 Start = 0;
+
+	for(System::Int32 Separator = FileName->IndexOf(L'\\'); Separator >= 0; Separator = FileName->IndexOf(L'\\', Start))
+	{
+		System::String^ Name = FileName->Substring(Start, Separator - Start);
+
+		Node = Create ? Node->AddChild(Name) : Node->GetChild(Name);
+		if(Node == nullptr) return nullptr;
+
+		Start = Separator + 1;
+	}
+
+	return Node;
+}
+
+System::String^ MpqLib::Mpq::CNameTrie::GetKey(System::String^ FileName, LCID Locale)
+{
+	//The locale is of fixed width, the name after it can be anything
+	return Locale.ToString("X8") + FileName;
+}
+
+System::Void MpqLib::Mpq::CNameTrie::Compact()
+{
+	//The entries left keep their order, the nodes and the keys are pointed at their new numbers
+	array<System::Int32>^ NewIndices = gcnew array<System::Int32>(_Entries->Count);
+	System::Collections::Generic::List<SNameEntry>^ Entries = gcnew System::Collections::Generic::List<SNameEntry>(_EntryIndices->Count);
+
+	for(System::Int32 i = 0; i < _Entries->Count; i++)
+	{
+		if(_Entries[i].FileName == nullptr) continue;
+
+		NewIndices[i] = Entries->Count;
+		Entries->Add(_Entries[i]);
+	}
+
+	array<System::String^>^ Keys = gcnew array<System::String^>(_EntryIndices->Count);
+	_EntryIndices->Keys->CopyTo(Keys, 0);
+
+	for each(System::String^ Key in Keys) _EntryIndices[Key] = NewIndices[_EntryIndices[Key]];
+
+	System::Collections::Generic::Stack<CNameTrieNode^>^ Pending = gcnew System::Collections::Generic::Stack<CNameTrieNode^>();
+	Pending->Push(_Root);
+
+	while(Pending->Count > 0)
+	{
+		CNameTrieNode^ Node = Pending->Pop();
+
+		for each(CNameTrieNode^ Child in Node->Children->Values) Pending->Push(Child);
+
+		array<System::Int32>^ EntryIndices = gcnew array<System::Int32>(Node->Entries->Count);
+		Node->Entries->CopyTo(EntryIndices);
+		Node->Entries->Clear();
+
+		for each(System::Int32 EntryIndex in EntryIndices) Node->Entries->Add(NewIndices[EntryIndex]);
+	}
+
+	_Entries = Entries;
+	_DeadEntryCount = 0;
+}
+
+System::Void MpqLib::Mpq::CNameTrie::AddMatches(CNameTrieNode^ Node, CGlobMatcher^ Matcher, System::Collections::Generic::List<System::Int32>^ EntryList)
+{
+	for each(System::Int32 EntryIndex in Node->Entries)
+	{
+		if(Matcher->IsMatch(_Entries[EntryIndex].FileName)) EntryList->Add(EntryIndex);
+	}
+}
@@ -0,0 +1,82 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "NameTrieNode.h"
+#include "GlobMatcher.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		value struct SNameEntry
+		{
+			System::String^ FileName;
+			System::Int32 BlockIndex;
+			LCID Locale;
+			DWORD FileSize;
+			DWORD CompressedSize;
+			DWORD Flags;
+		};
+
+		/// <summary>
+		/// The known names of an archive in a trie of backslash separated, case insensitive directories.
+		/// A search only visits the directories under the literal prefix of its mask, so listing a
+		/// directory costs about as much as the files it returns. Imports, renames and removals are
+		/// applied to it in place, searches running meanwhile see it before or after each change.
+		/// Removed names leave an empty slot behind, the entries are numbered again once most slots are empty.
+		/// </summary>
+		private ref class CNameTrie
+		{
+			public:
+				CNameTrie();
+
+				System::Void Add(SNameEntry Entry);
+				System::Boolean Remove(System::String^ FileName, LCID Locale);
+				System::Collections::Generic::List<SNameEntry>^ Find(CGlobMatcher^ Matcher);
+				System::Collections::Generic::List<SNameEntry>^ FindName(System::String^ FileName);
+
+				property System::Int32 Count { System::Int32 get(); }
+
+			private:
+				CNameTrieNode^ GetNode(System::String^ FileName, System::Boolean Create);
+				static System::String^ GetKey(System::String^ FileName, LCID Locale);
+				System::Void Compact();
+				System::Void AddMatches(CNameTrieNode^ Node, CGlobMatcher^ Matcher, System::Collections::Generic::List<System::Int32>^ EntryList);
+
+			private:
+				CNameTrieNode^ _Root;
+				System::Collections::Generic::List<SNameEntry>^ _Entries;
+				System::Collections::Generic::Dictionary<System::String^, System::Int32>^ _EntryIndices;
+				System::Int32 _DeadEntryCount;
+				System::Object^ _Lock;
+		};
+	}
+}
@@ -0,0 +1,65 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "NameTrieNode.h"
+
+MpqLib::Mpq::CNameTrieNode::CNameTrieNode()
+{
+	_Children = gcnew System::Collections::Generic::Dictionary<System::String^, CNameTrieNode^>(System::StringComparer::OrdinalIgnoreCase);
+	_Entries = gcnew System::Collections::Generic::HashSet<System::Int32>();
+}
+
+MpqLib::Mpq::CNameTrieNode^ MpqLib::Mpq::CNameTrieNode::GetChild(System::String^ Name)
+{
+	CNameTrieNode^ Child = nullptr;
+	_Children->TryGetValue(Name, Child);
+
+	return Child;
+}
+
+MpqLib::Mpq::CNameTrieNode^ MpqLib::Mpq::CNameTrieNode::AddChild(System::String^ Name)
+{
+	CNameTrieNode^ Child = GetChild(Name);
+	if(Child != nullptr) return Child;
+
+	Child = gcnew CNameTrieNode();
+	_Children->Add(Name, Child);
+
+	return Child;
+}
+
+System::Collections::Generic::Dictionary<System::String^, MpqLib::Mpq::CNameTrieNode^>^ MpqLib::Mpq::CNameTrieNode::Children::get()
+{
+	return _Children;
+}
+
+System::Collections::Generic::HashSet<System::Int32>^ MpqLib::Mpq::CNameTrieNode::Entries::get()
+{
+	return _Entries;
+}
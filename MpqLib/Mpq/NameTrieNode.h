@@ -0,0 +1,57 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// A directory in a name trie, holding its subdirectories by name and the files directly in it (unordered, by entry number).
+		/// </summary>
+		private ref class CNameTrieNode
+		{
+			public:
+				CNameTrieNode();
+
+				CNameTrieNode^ GetChild(System::String^ Name);
+				CNameTrieNode^ AddChild(System::String^ Name);
+
+				property System::Collections::Generic::Dictionary<System::String^, CNameTrieNode^>^ Children { System::Collections::Generic::Dictionary<System::String^, CNameTrieNode^>^ get(); }
+				property System::Collections::Generic::HashSet<System::Int32>^ Entries { System::Collections::Generic::HashSet<System::Int32>^ get(); }
+
+			private:
+				System::Collections::Generic::Dictionary<System::String^, CNameTrieNode^>^ _Children;
+				System::Collections::Generic::HashSet<System::Int32>^ _Entries;
+		};
+	}
+}
@@ -0,0 +1,85 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "RingBufferTraceSink.h"
+
+MpqLib::Mpq::CRingBufferTraceSink::CRingBufferTraceSink(System::Int32 Capacity)
+{
+	if(Capacity <= 0) throw gcnew System::ArgumentOutOfRangeException("Capacity", "The capacity must be positive!");
+
+	_Events = gcnew array<CTraceEvent^>(Capacity);
+	_Next = 0;
+	_Count = 0;
+	_Lock = gcnew System::Object();
+}
+
+System::Void MpqLib::Mpq::CRingBufferTraceSink::Write(CTraceEvent^ Event)
+{
+	msclr::lock Lock(_Lock);
+
+	_Events[_Next] = Event;
+	_Next = (_Next + 1) % _Events->Length;
+	if(_Count < _Events->Length) _Count++;
+}
+
+array<MpqLib::Mpq::CTraceEvent^>^ MpqLib::Mpq::CRingBufferTraceSink::GetEvents()
+{
+	msclr::lock Lock(_Lock);
+
+	array<CTraceEvent^>^ Events = gcnew array<CTraceEvent^>(_Count);
+	System::Int32 First = (_Next - _Count + _Events->Length) % _Events->Length;
+
+	for(System::Int32 i = 0; i < _Count; i++)
+	{
+		Events[i] = _Events[(First + i) % _Events->Length];
+	}
+
+	return Events;
+}
+
+System::Void MpqLib::Mpq::CRingBufferTraceSink::Clear()
+{
+	msclr::lock Lock(_Lock);
+
+	System::Array::Clear(_Events, 0, _Events->Length);
+	_Next = 0;
+	_Count = 0;
+}
+
+System::Int32 MpqLib::Mpq::CRingBufferTraceSink::Capacity::get()
+{
+	return _Events->Length;
+}
+
+System::Int32 MpqLib::Mpq::CRingBufferTraceSink::Count::get()
+{
+	msclr::lock Lock(_Lock);
+
+	return _Count;
+}
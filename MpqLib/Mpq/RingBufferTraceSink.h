@@ -0,0 +1,84 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TraceSink.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Keeps the most recent trace events in memory, older events are overwritten once it is full.
+		/// </summary>
+		public ref class CRingBufferTraceSink sealed : ITraceSink
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Capacity">The number of events to keep</param>
+				CRingBufferTraceSink(System::Int32 Capacity);
+
+				/// <summary>
+				/// Receives a trace event.
+				/// </summary>
+				/// <param name="Event">The event</param>
+				virtual System::Void Write(CTraceEvent^ Event);
+
+				/// <summary>
+				/// Retrieves the events kept, oldest first.
+				/// </summary>
+				/// <returns>The events</returns>
+				array<CTraceEvent^>^ GetEvents();
+
+				/// <summary>
+				/// Discards all events kept.
+				/// </summary>
+				System::Void Clear();
+
+				/// <summary>
+				/// Retrieves the number of events that can be kept.
+				/// </summary>
+				property System::Int32 Capacity { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the number of events kept.
+				/// </summary>
+				property System::Int32 Count { System::Int32 get(); }
+
+			private:
+				array<CTraceEvent^>^ _Events;
+				System::Int32 _Next;
+				System::Int32 _Count;
+				System::Object^ _Lock;
+		};
+	}
+}
@@ -0,0 +1,64 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "SectorDecoder.h"
+
+MpqLib::Mpq::CSectorDecoder::CSectorDecoder(BYTE* Data, const DWORD* DataOffsets, BYTE* Output, System::Int32 FirstSector, System::Int32 SectorCount, DWORD FileSize, DWORD Flags, DWORD Key, System::Int32 SectorSize)
+{
+	_Data = Data;
+	_DataOffsets = DataOffsets;
+	_Output = Output;
+	_FirstSector = FirstSector;
+	_SectorCount = SectorCount;
+	_FileSize = FileSize;
+	_Flags = Flags;
+	_Key = Key;
+	_SectorSize = SectorSize;
+	_GroupSectorCount = System::Math::Max(1, CConstants::SectorGroupSize / SectorSize);
+}
+
+System::Void MpqLib::Mpq::CSectorDecoder::DecodeGroup(System::Int32 GroupIndex)
+{
+	System::Int32 First = GroupIndex * _GroupSectorCount;
+	System::Int32 Last = System::Math::Min(First + _GroupSectorCount, _SectorCount);
+
+	//Decoding works in place, every sector has its own stretch of the data so groups never overlap
+	for(System::Int32 i = First; i < Last; i++)
+	{
+		DWORD SectorStart = static_cast<DWORD>(_FirstSector + i) * static_cast<DWORD>(_SectorSize);
+		DWORD SectorLength = System::Math::Min(static_cast<DWORD>(_SectorSize), _FileSize - SectorStart);
+
+		CBlockDecoder::DecodeSector(_Data + _DataOffsets[i], _DataOffsets[i + 1] - _DataOffsets[i], _Output + static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize), SectorLength, _Flags, _Key + _FirstSector + i);
+	}
+}
+
+System::Int32 MpqLib::Mpq::CSectorDecoder::GroupCount::get()
+{
+	return (_SectorCount + _GroupSectorCount - 1) / _GroupSectorCount;
+}
@@ -0,0 +1,64 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "BlockDecoder.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Decodes a run of sectors of one block in groups, each sector straight into its place in the
+		/// output. Groups are independent of each other, so they can be decoded on several threads.
+		/// </summary>
+		private ref class CSectorDecoder
+		{
+			public:
+				CSectorDecoder(BYTE* Data, const DWORD* DataOffsets, BYTE* Output, System::Int32 FirstSector, System::Int32 SectorCount, DWORD FileSize, DWORD Flags, DWORD Key, System::Int32 SectorSize);
+
+				System::Void DecodeGroup(System::Int32 GroupIndex);
+
+				property System::Int32 GroupCount { System::Int32 get(); }
+
+			private:
+				BYTE* _Data;
+				const DWORD* _DataOffsets;
+				BYTE* _Output;
+				System::Int32 _FirstSector;
+				System::Int32 _SectorCount;
+				DWORD _FileSize;
+				DWORD _Flags;
+				DWORD _Key;
+				System::Int32 _SectorSize;
+				System::Int32 _GroupSectorCount;
+		};
+	}
+}
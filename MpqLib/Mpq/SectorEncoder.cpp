@@ -0,0 +1,66 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "SectorEncoder.h"
+
+MpqLib::Mpq::CSectorEncoder::CSectorEncoder(BYTE* Data, DWORD DataSize, BYTE* Output, DWORD* SectorSizes, DWORD Flags, DWORD CompressionFlags, System::Int32 Level, System::Int32 DictionarySize, DWORD Key, System::Int32 SectorSize)
+{
+	_Data = Data;
+	_DataSize = DataSize;
+	_Output = Output;
+	_SectorSizes = SectorSizes;
+	_Flags = Flags;
+	_CompressionFlags = CompressionFlags;
+	_Level = Level;
+	_DictionarySize = DictionarySize;
+	_Key = Key;
+	_SectorSize = SectorSize;
+	_SectorCount = static_cast<System::Int32>((static_cast<System::Int64>(DataSize) + SectorSize - 1) / SectorSize);
+	_GroupSectorCount = System::Math::Max(1, CConstants::SectorGroupSize / SectorSize);
+}
+
+System::Void MpqLib::Mpq::CSectorEncoder::EncodeGroup(System::Int32 GroupIndex)
+{
+	System::Int32 First = GroupIndex * _GroupSectorCount;
+	System::Int32 Last = System::Math::Min(First + _GroupSectorCount, _SectorCount);
+
+	//A sector never grows, so it always fits the slot at its position in the file data
+	for(System::Int32 i = First; i < Last; i++)
+	{
+		DWORD SectorStart = static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize);
+		DWORD SectorLength = System::Math::Min(static_cast<DWORD>(_SectorSize), _DataSize - SectorStart);
+
+		_SectorSizes[i] = CBlockEncoder::EncodeSector(_Data + SectorStart, SectorLength, _Output + SectorStart, _Flags, _CompressionFlags, _Level, _DictionarySize, _Key + i);
+	}
+}
+
+System::Int32 MpqLib::Mpq::CSectorEncoder::GroupCount::get()
+{
+	return (_SectorCount + _GroupSectorCount - 1) / _GroupSectorCount;
+}
@@ -0,0 +1,248 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "SectorReader.h"
+#include "SectorDecoder.h"
+
+MpqLib::Mpq::CSectorReader::CSectorReader(System::String^ ArchiveFileName, System::Int64 Position, const SBlockEntry& BlockEntry, DWORD Key, System::Int32 SectorSize)
+{
+	_Stream = gcnew System::IO::FileStream(ArchiveFileName, System::IO::FileMode::Open, System::IO::FileAccess::Read, System::IO::FileShare::ReadWrite, 0x1000, System::IO::FileOptions::RandomAccess);
+	_Position = Position;
+	_FileSize = BlockEntry.FileSize;
+	_CompressedSize = BlockEntry.CompressedSize;
+	_Flags = BlockEntry.Flags;
+	_Key = Key;
+	_SectorSize = SectorSize;
+	_SectorCount = CBlockDecoder::GetSectorCount(BlockEntry, SectorSize);
+
+	_OffsetTable = NULL;
+	_Data = gcnew array<System::Byte>(0);
+	_Sector = gcnew array<System::Byte>(0);
+	_SectorIndex = CConstants::InvalidIndex;
+	_SectorLength = 0;
+
+	try
+	{
+		LoadOffsetTable();
+	}
+	catch(System::Exception^)
+	{
+		Cleanup(true);
+		throw;
+	}
+}
+
+MpqLib::Mpq::CSectorReader::~CSectorReader()
+{
+	Cleanup(true);
+}
+
+MpqLib::Mpq::CSectorReader::!CSectorReader()
+{
+	Cleanup(false);
+}
+
+System::Int32 MpqLib::Mpq::CSectorReader::Read(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Index, System::Int32 Count)
+{
+	if((Position < 0) || (Position >= _FileSize) || (Count <= 0)) return 0;
+
+	pin_ptr<System::Byte> BufferPointer = &Buffer[Index];
+	return Read(Position, BufferPointer, Count);
+}
+
+System::Int32 MpqLib::Mpq::CSectorReader::Read(System::Int64 Position, BYTE* Output, System::Int32 Count)
+{
+	if((Position < 0) || (Position >= _FileSize) || (Count <= 0)) return 0;
+	if((Position + Count) > _FileSize) Count = static_cast<System::Int32>(_FileSize - Position);
+
+	for(System::Int32 BytesRead = 0; BytesRead < Count; )
+	{
+		System::Int64 SectorPosition = Position + BytesRead;
+		System::Int32 SectorIndex = (_Flags & MPQ_FILE_SINGLE_UNIT) ? 0 : static_cast<System::Int32>(SectorPosition / _SectorSize);
+		System::Int32 SectorOffset = static_cast<System::Int32>(SectorPosition - static_cast<System::Int64>(SectorIndex) * _SectorSize);
+
+		System::Int32 SectorCount = (SectorOffset == 0) ? GetParallelSectorCount(SectorIndex, Count - BytesRead) : 0;
+		if(SectorCount > 1)
+		{
+			BytesRead += DecodeSectors(SectorIndex, SectorCount, Output + BytesRead);
+			continue;
+		}
+
+		LoadSector(SectorIndex);
+
+		System::Int32 Length = System::Math::Min(Count - BytesRead, _SectorLength - SectorOffset);
+		System::Runtime::InteropServices::Marshal::Copy(_Sector, SectorOffset, static_cast<System::IntPtr>(Output + BytesRead), Length);
+
+		BytesRead += Length;
+	}
+
+	return Count;
+}
+
+System::Int64 MpqLib::Mpq::CSectorReader::Length::get()
+{
+	return _FileSize;
+}
+
+System::Void MpqLib::Mpq::CSectorReader::LoadOffsetTable()
+{
+	//Single unit and uncompressed blocks have no offset table, their sectors are found by size alone
+	if((_Flags & MPQ_FILE_SINGLE_UNIT) || ((_Flags & (MPQ_FILE_IMPLODE | MPQ_FILE_COMPRESS)) == 0) || (_FileSize == 0)) return;
+
+	DWORD OffsetTableSize = (_SectorCount + 1) * sizeof(DWORD);
+	if(OffsetTableSize > _CompressedSize) throw gcnew System::IO::InvalidDataException("The sector offset table is corrupt!");
+
+	array<System::Byte>^ Data = gcnew array<System::Byte>(OffsetTableSize);
+	ReadData(_Position, Data, Data->Length);
+
+	_OffsetTable = new std::vector<DWORD>(_SectorCount + 1);
+	pin_ptr<System::Byte> DataPointer = &Data[0];
+	memcpy(&(*_OffsetTable)[0], DataPointer, OffsetTableSize);
+	if(_Flags & MPQ_FILE_ENCRYPTED) CCryptography::DecryptBlock(&(*_OffsetTable)[0], OffsetTableSize, _Key - 1);
+
+	for(System::Int32 i = 0; i < _SectorCount; i++)
+	{
+		if(((*_OffsetTable)[i + 1] < (*_OffsetTable)[i]) || ((*_OffsetTable)[i + 1] > _CompressedSize)) throw gcnew System::IO::InvalidDataException("The sector offset table is corrupt!");
+	}
+}
+
+System::Void MpqLib::Mpq::CSectorReader::LoadSector(System::Int32 SectorIndex)
+{
+	if(SectorIndex == _SectorIndex) return;
+
+	DWORD SectorStart = static_cast<DWORD>(SectorIndex) * static_cast<DWORD>(_SectorSize);
+	DWORD SectorLength = (_Flags & MPQ_FILE_SINGLE_UNIT) ? _FileSize : System::Math::Min(static_cast<DWORD>(_SectorSize), _FileSize - SectorStart);
+	DWORD DataStart = SectorStart;
+	DWORD DataSize = SectorLength;
+
+	if(_Flags & MPQ_FILE_SINGLE_UNIT)
+	{
+		DataStart = 0;
+		DataSize = _CompressedSize;
+	}
+	else if(_OffsetTable != NULL)
+	{
+		DataStart = (*_OffsetTable)[SectorIndex];
+		DataSize = (*_OffsetTable)[SectorIndex + 1] - DataStart;
+	}
+
+	if((DataSize == 0) || ((static_cast<System::Int64>(DataStart) + DataSize) > _CompressedSize)) throw gcnew System::IO::EndOfStreamException("The sector is truncated!");
+
+	if(_Data->Length < static_cast<System::Int32>(DataSize)) _Data = gcnew array<System::Byte>(DataSize);
+	if(_Sector->Length < static_cast<System::Int32>(SectorLength)) _Sector = gcnew array<System::Byte>(SectorLength);
+
+	//Decoding works in place, the cached sector is invalid until it succeeded
+	_SectorIndex = CConstants::InvalidIndex;
+	ReadData(_Position + DataStart, _Data, DataSize);
+
+	pin_ptr<System::Byte> DataPointer = &_Data[0];
+	pin_ptr<System::Byte> SectorPointer = &_Sector[0];
+	CBlockDecoder::DecodeSector(DataPointer, DataSize, SectorPointer, SectorLength, _Flags, _Key + SectorIndex);
+
+	_SectorIndex = SectorIndex;
+	_SectorLength = static_cast<System::Int32>(SectorLength);
+}
+
+System::Int32 MpqLib::Mpq::CSectorReader::GetParallelSectorCount(System::Int32 FirstSector, System::Int32 Size)
+{
+	if((_Flags & MPQ_FILE_SINGLE_UNIT) || (Size < CConstants::ParallelDecodeMinSize) || (System::Environment::ProcessorCount == 1)) return 0;
+
+	//Only the sectors wholly inside the range qualify, the tail of the file counts when the range reaches it
+	System::Int64 SectorStart = static_cast<System::Int64>(FirstSector) * _SectorSize;
+	System::Int64 RangeSize = System::Math::Min(static_cast<System::Int64>(System::Math::Min(Size, CConstants::ParallelDecodeBatchSize)), _FileSize - SectorStart);
+	System::Int32 SectorCount = static_cast<System::Int32>(RangeSize / _SectorSize);
+	if(((RangeSize % _SectorSize) != 0) && ((SectorStart + RangeSize) == _FileSize)) SectorCount++;
+
+	return SectorCount;
+}
+
+System::Int32 MpqLib::Mpq::CSectorReader::DecodeSectors(System::Int32 FirstSector, System::Int32 SectorCount, BYTE* Output)
+{
+	DWORD SectorStart = static_cast<DWORD>(FirstSector) * static_cast<DWORD>(_SectorSize);
+	DWORD SectorEnd = System::Math::Min(static_cast<DWORD>(FirstSector + SectorCount) * static_cast<DWORD>(_SectorSize), _FileSize);
+
+	//The sectors follow each other in the block, so all of them are fetched with a single read
+	std::vector<DWORD> DataOffsets(SectorCount + 1);
+	DWORD DataStart = (_OffsetTable != NULL) ? (*_OffsetTable)[FirstSector] : SectorStart;
+	for(System::Int32 i = 0; i <= SectorCount; i++)
+	{
+		DWORD Offset = (i == SectorCount) ? SectorEnd : (SectorStart + static_cast<DWORD>(i) * static_cast<DWORD>(_SectorSize));
+		if(_OffsetTable != NULL) Offset = (*_OffsetTable)[FirstSector + i];
+
+		DataOffsets[i] = Offset - DataStart;
+		if((i > 0) && (DataOffsets[i] == DataOffsets[i - 1])) throw gcnew System::IO::EndOfStreamException("The sector is truncated!");
+	}
+
+	DWORD DataSize = DataOffsets[SectorCount];
+	if((static_cast<System::Int64>(DataStart) + DataSize) > _CompressedSize) throw gcnew System::IO::EndOfStreamException("The sector is truncated!");
+
+	array<System::Byte>^ Data = gcnew array<System::Byte>(DataSize);
+	ReadData(_Position + DataStart, Data, DataSize);
+
+	pin_ptr<System::Byte> DataPointer = &Data[0];
+	CSectorDecoder Decoder(DataPointer, &DataOffsets[0], Output, FirstSector, SectorCount, _FileSize, _Flags, _Key, _SectorSize);
+
+	try
+	{
+		System::Threading::Tasks::Parallel::For(0, Decoder.GroupCount, gcnew System::Action<System::Int32>(%Decoder, &CSectorDecoder::DecodeGroup));
+	}
+	catch(System::AggregateException^ Exception)
+	{
+		System::Runtime::ExceptionServices::ExceptionDispatchInfo::Capture(Exception->Flatten()->InnerExceptions[0])->Throw();
+	}
+
+	return static_cast<System::Int32>(SectorEnd - SectorStart);
+}
+
+System::Void MpqLib::Mpq::CSectorReader::ReadData(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Size)
+{
+	_Stream->Position = Position;
+	for(System::Int32 Index = 0; Index < Size; )
+	{
+		System::Int32 BytesRead = _Stream->Read(Buffer, Index, Size - Index);
+		if(BytesRead <= 0) throw gcnew System::IO::EndOfStreamException("The block is truncated!");
+
+		Index += BytesRead;
+	}
+}
+
+void MpqLib::Mpq::CSectorReader::Cleanup(bool CleanupManagedStuff)
+{
+	if(_OffsetTable != NULL)
+	{
+		delete _OffsetTable;
+		_OffsetTable = NULL;
+	}
+
+	if(CleanupManagedStuff && (_Stream != nullptr))
+	{
+		_Stream->Close();
+		_Stream = nullptr;
+	}
+}
@@ -0,0 +1,82 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "BlockDecoder.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Reads byte ranges of a stored block without expanding all of it. The sector offset table is
+		/// loaded once, a read decodes only the sectors covering the range and keeps the last one around
+		/// for the reads that follow. Large reads decode their whole sectors in parallel, straight into the
+		/// destination.
+		/// </summary>
+		private ref class CSectorReader
+		{
+			public:
+				CSectorReader(System::String^ ArchiveFileName, System::Int64 Position, const SBlockEntry& BlockEntry, DWORD Key, System::Int32 SectorSize);
+				~CSectorReader();
+				!CSectorReader();
+
+				System::Int32 Read(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Index, System::Int32 Count);
+				System::Int32 Read(System::Int64 Position, BYTE* Output, System::Int32 Count);
+
+				property System::Int64 Length { System::Int64 get(); }
+
+			private:
+				System::Void LoadOffsetTable();
+				System::Void LoadSector(System::Int32 SectorIndex);
+				System::Int32 GetParallelSectorCount(System::Int32 FirstSector, System::Int32 Size);
+				System::Int32 DecodeSectors(System::Int32 FirstSector, System::Int32 SectorCount, BYTE* Output);
+				System::Void ReadData(System::Int64 Position, array<System::Byte>^ Buffer, System::Int32 Size);
+
+				void Cleanup(bool CleanupManagedStuff);
+
+			private:
+				System::IO::FileStream^ _Stream;
+				System::Int64 _Position;
+				DWORD _FileSize;
+				DWORD _CompressedSize;
+				DWORD _Flags;
+				DWORD _Key;
+				System::Int32 _SectorSize;
+				System::Int32 _SectorCount;
+
+				std::vector<DWORD>* _OffsetTable;
+				array<System::Byte>^ _Data;
+				array<System::Byte>^ _Sector;
+				System::Int32 _SectorIndex;
+				System::Int32 _SectorLength;
+		};
+	}
+}
@@ -0,0 +1,97 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "TraceEvent.h"
+
+MpqLib::Mpq::CTraceEvent::CTraceEvent(ETraceEventKind Kind, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Size, System::Nullable<ECompression> Compression, System::Int64 Timestamp, System::Int64 Duration, System::Int32 ThreadId)
+{
+	_Kind = Kind;
+	_Operation = Operation;
+	_ArchiveFileName = ArchiveFileName;
+	_FileName = FileName;
+	_Size = Size;
+	_Compression = Compression;
+	_Timestamp = Timestamp;
+	_Duration = Duration;
+	_ThreadId = ThreadId;
+}
+
+System::String^ MpqLib::Mpq::CTraceEvent::ToString()
+{
+	System::String^ Target = (_FileName != nullptr) ? (_ArchiveFileName + ":" + _FileName) : _ArchiveFileName;
+
+	if(_Kind == ETraceEventKind::Begin) return "[" + _ThreadId + "] " + _Operation + " " + Target;
+
+	return "[" + _ThreadId + "] " + _Operation + " " + Target + " done, " + _Size + " bytes" + (_Compression.HasValue ? (" " + _Compression.Value.ToString()) : "") + " in " + _Duration + " us";
+}
+
+MpqLib::Mpq::ETraceEventKind MpqLib::Mpq::CTraceEvent::Kind::get()
+{
+	return _Kind;
+}
+
+System::String^ MpqLib::Mpq::CTraceEvent::Operation::get()
+{
+	return _Operation;
+}
+
+System::String^ MpqLib::Mpq::CTraceEvent::ArchiveFileName::get()
+{
+	return _ArchiveFileName;
+}
+
+System::String^ MpqLib::Mpq::CTraceEvent::FileName::get()
+{
+	return _FileName;
+}
+
+System::Int64 MpqLib::Mpq::CTraceEvent::Size::get()
+{
+	return _Size;
+}
+
+System::Nullable<MpqLib::Mpq::ECompression> MpqLib::Mpq::CTraceEvent::Compression::get()
+{
+	return _Compression;
+}
+
+System::Int64 MpqLib::Mpq::CTraceEvent::Timestamp::get()
+{
+	return _Timestamp;
+}
+
+System::Int64 MpqLib::Mpq::CTraceEvent::Duration::get()
+{
+	return _Duration;
+}
+
+System::Int32 MpqLib::Mpq::CTraceEvent::ThreadId::get()
+{
+	return _ThreadId;
+}
@@ -0,0 +1,122 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Compression.h"
+#include "TraceEventKind.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// An immutable event marking the start or the end of an archive or file operation.
+		/// </summary>
+		public ref class CTraceEvent sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="Kind">The kind of event to use</param>
+				/// <param name="Operation">The name of the operation to use</param>
+				/// <param name="ArchiveFileName">The archive the operation works on to use</param>
+				/// <param name="FileName">The file in the archive the operation works on to use (null if none)</param>
+				/// <param name="Size">The number of bytes processed to use</param>
+				/// <param name="Compression">The compression format to use (null if not known)</param>
+				/// <param name="Timestamp">The time of the event in microseconds to use</param>
+				/// <param name="Duration">The duration of the operation in microseconds to use</param>
+				/// <param name="ThreadId">The managed thread the operation ran on to use</param>
+				CTraceEvent(ETraceEventKind Kind, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Size, System::Nullable<ECompression> Compression, System::Int64 Timestamp, System::Int64 Duration, System::Int32 ThreadId);
+
+				/// <summary>
+				/// Generates a string version of the event.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the kind of event.
+				/// </summary>
+				property ETraceEventKind Kind { ETraceEventKind get(); }
+
+				/// <summary>
+				/// Retrieves the name of the operation (such as "ImportFile" or "Read").
+				/// </summary>
+				property System::String^ Operation { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the archive the operation works on.
+				/// </summary>
+				property System::String^ ArchiveFileName { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the file in the archive the operation works on (null for archive wide operations).
+				/// </summary>
+				property System::String^ FileName { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the number of bytes processed, only known at the end of an operation.
+				/// </summary>
+				property System::Int64 Size { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the compression format involved (null if not known).
+				/// </summary>
+				property System::Nullable<ECompression> Compression { System::Nullable<ECompression> get(); }
+
+				/// <summary>
+				/// Retrieves the time of the event in microseconds, on a monotonic clock with an arbitrary origin.
+				/// </summary>
+				property System::Int64 Timestamp { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the duration of the operation in microseconds (zero for begin events).
+				/// </summary>
+				property System::Int64 Duration { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the managed thread the operation ran on.
+				/// </summary>
+				property System::Int32 ThreadId { System::Int32 get(); }
+
+			private:
+				ETraceEventKind _Kind;
+				System::String^ _Operation;
+				System::String^ _ArchiveFileName;
+				System::String^ _FileName;
+				System::Int64 _Size;
+				System::Nullable<ECompression> _Compression;
+				System::Int64 _Timestamp;
+				System::Int64 _Duration;
+				System::Int32 _ThreadId;
+		};
+	}
+}
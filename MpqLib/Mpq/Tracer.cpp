@@ -0,0 +1,71 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "Tracer.h"
+
+System::Int64 MpqLib::Mpq::CTracer::Begin(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName)
+{
+	if(Sink == nullptr) return 0;
+
+	System::Int64 Timestamp = GetTimestamp();
+	Write(Sink, gcnew CTraceEvent(ETraceEventKind::Begin, Operation, ArchiveFileName, FileName, 0, System::Nullable<ECompression>(), Timestamp, 0, System::Threading::Thread::CurrentThread->ManagedThreadId));
+
+	return Timestamp;
+}
+
+System::Void MpqLib::Mpq::CTracer::End(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Start, System::Int64 Size)
+{
+	End(Sink, Operation, ArchiveFileName, FileName, Start, Size, System::Nullable<ECompression>());
+}
+
+System::Void MpqLib::Mpq::CTracer::End(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Start, System::Int64 Size, System::Nullable<ECompression> Compression)
+{
+	if(Sink == nullptr) return;
+
+	System::Int64 Timestamp = GetTimestamp();
+	Write(Sink, gcnew CTraceEvent(ETraceEventKind::End, Operation, ArchiveFileName, FileName, Size, Compression, Timestamp, Timestamp - Start, System::Threading::Thread::CurrentThread->ManagedThreadId));
+}
+
+System::Void MpqLib::Mpq::CTracer::Write(ITraceSink^ Sink, CTraceEvent^ Event)
+{
+	//A failing sink must not fail the traced operation (nor replace the error it is ending with)
+	try
+	{
+		Sink->Write(Event);
+	}
+	catch(System::Exception^)
+	{
+	}
+}
+
+System::Int64 MpqLib::Mpq::CTracer::GetTimestamp()
+{
+	//Microseconds are what the trace viewers expect, a double keeps the conversion from overflowing
+	return static_cast<System::Int64>(static_cast<System::Double>(System::Diagnostics::Stopwatch::GetTimestamp()) * 1000000.0 / System::Diagnostics::Stopwatch::Frequency);
+}
@@ -0,0 +1,54 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "TraceSink.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Emits the begin and end events of traced operations. Without a sink both calls return right
+		/// away, which keeps tracing free when it is disabled.
+		/// </summary>
+		private ref class CTracer abstract sealed
+		{
+			public:
+				static System::Int64 Begin(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName);
+				static System::Void End(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Start, System::Int64 Size);
+				static System::Void End(ITraceSink^ Sink, System::String^ Operation, System::String^ ArchiveFileName, System::String^ FileName, System::Int64 Start, System::Int64 Size, System::Nullable<ECompression> Compression);
+
+			private:
+				static System::Void Write(ITraceSink^ Sink, CTraceEvent^ Event);
+				static System::Int64 GetTimestamp();
+		};
+	}
+}
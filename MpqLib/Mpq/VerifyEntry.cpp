@@ -0,0 +1,63 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "VerifyEntry.h"
+
+MpqLib::Mpq::CVerifyEntry::CVerifyEntry(System::String^ FileName, System::Int32 BlockIndex, System::Int64 Position, EVerifyError Errors)
+{
+	_FileName = FileName;
+	_BlockIndex = BlockIndex;
+	_Position = Position;
+	_Errors = Errors;
+}
+
+System::String^ MpqLib::Mpq::CVerifyEntry::ToString()
+{
+	return _FileName + " (block " + _BlockIndex + " at 0x" + _Position.ToString("X") + "): " + _Errors.ToString();
+}
+
+System::String^ MpqLib::Mpq::CVerifyEntry::FileName::get()
+{
+	return _FileName;
+}
+
+System::Int32 MpqLib::Mpq::CVerifyEntry::BlockIndex::get()
+{
+	return _BlockIndex;
+}
+
+System::Int64 MpqLib::Mpq::CVerifyEntry::Position::get()
+{
+	return _Position;
+}
+
+MpqLib::Mpq::EVerifyError MpqLib::Mpq::CVerifyEntry::Errors::get()
+{
+	return _Errors;
+}
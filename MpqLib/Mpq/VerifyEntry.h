@@ -0,0 +1,86 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "VerifyError.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// An immutable integrity error of a file in an archive.
+		/// </summary>
+		public ref class CVerifyEntry sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileName">The filename to use</param>
+				/// <param name="BlockIndex">The block index to use</param>
+				/// <param name="Position">The position of the block in the archive file to use</param>
+				/// <param name="Errors">The errors found to use</param>
+				CVerifyEntry(System::String^ FileName, System::Int32 BlockIndex, System::Int64 Position, EVerifyError Errors);
+
+				/// <summary>
+				/// Generates a string version of the error.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the filename (a pseudo name for blocks without a known name).
+				/// </summary>
+				property System::String^ FileName { System::String^ get(); }
+
+				/// <summary>
+				/// Retrieves the index of the block in the block table.
+				/// </summary>
+				property System::Int32 BlockIndex { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the position of the block in the archive file.
+				/// </summary>
+				property System::Int64 Position { System::Int64 get(); }
+
+				/// <summary>
+				/// Retrieves the errors found.
+				/// </summary>
+				property EVerifyError Errors { EVerifyError get(); }
+
+			private:
+				System::String^ _FileName;
+				System::Int32 _BlockIndex;
+				System::Int64 _Position;
+				EVerifyError _Errors;
+		};
+	}
+}
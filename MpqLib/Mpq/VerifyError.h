@@ -0,0 +1,80 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "Constants.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// Enumerates the integrity errors a file in an archive can have.
+		/// </summary>
+		[System::Flags]
+		public enum class EVerifyError
+		{
+			/// <summary>
+			/// Represents an intact file.
+			/// </summary>
+			None = 0,
+
+			/// <summary>
+			/// Represents a block reaching past the end of the archive (a truncated archive).
+			/// </summary>
+			OutOfBounds = 0x01,
+
+			/// <summary>
+			/// Represents a file that could not be opened or read.
+			/// </summary>
+			Unreadable = 0x02,
+
+			/// <summary>
+			/// Represents a sector not matching its stored CRC.
+			/// </summary>
+			SectorCrcMismatch = 0x04,
+
+			/// <summary>
+			/// Represents a file not matching the CRC32 stored in "(attributes)".
+			/// </summary>
+			Crc32Mismatch = 0x08,
+
+			/// <summary>
+			/// Represents a file not matching the MD5 stored in "(attributes)".
+			/// </summary>
+			Md5Mismatch = 0x10,
+
+			/// <summary>
+			/// Represents an encrypted file without a known name, its key is derived from the name so only its bounds could be checked.
+			/// </summary>
+			KeyUnknown = 0x20,
+		};
+	}
+}
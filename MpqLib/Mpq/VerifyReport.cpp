@@ -0,0 +1,71 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#include "VerifyReport.h"
+
+MpqLib::Mpq::CVerifyReport::CVerifyReport(System::Int32 FileCount, System::Collections::Generic::IList<CVerifyEntry^>^ Entries)
+{
+	_FileCount = FileCount;
+	_Entries = gcnew System::Collections::ObjectModel::ReadOnlyCollection<CVerifyEntry^>(Entries);
+}
+
+System::String^ MpqLib::Mpq::CVerifyReport::ToString()
+{
+	System::Int32 UnverifiedCount = UnverifiedFileCount;
+
+	return _FileCount + " files verified, " + (_Entries->Count - UnverifiedCount) + " with errors, " + UnverifiedCount + " with unknown keys";
+}
+
+System::Int32 MpqLib::Mpq::CVerifyReport::FileCount::get()
+{
+	return _FileCount;
+}
+
+System::Collections::ObjectModel::ReadOnlyCollection<MpqLib::Mpq::CVerifyEntry^>^ MpqLib::Mpq::CVerifyReport::Entries::get()
+{
+	return _Entries;
+}
+
+System::Int32 MpqLib::Mpq::CVerifyReport::UnverifiedFileCount::get()
+{
+	System::Int32 Count = 0;
+
+	for each(CVerifyEntry^ Entry in _Entries)
+	{
+		if(Entry->Errors == EVerifyError::KeyUnknown) Count++;
+	}
+
+	return Count;
+}
+
+System::Boolean MpqLib::Mpq::CVerifyReport::IsValid::get()
+{
+	//Files that could not be checked for a missing key are not known to be damaged
+	return (_Entries->Count == UnverifiedFileCount);
+}
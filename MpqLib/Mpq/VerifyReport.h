@@ -0,0 +1,82 @@
+//+-----------------------------------------------------------------------------
+//|
+//| Copyright (C) 2008, Magnus Ostberg, aka Magos
+//| Contact: MagosX@GMail.com, http://www.magosx.com
+//|
+//| This file is part of MpqLib.
+//| MpqLib is a library to manipulate (open, read, write) MoPaQ archives and
+//| its contained files for the game WarCraft 3. It can (and is supposed to)
+//| be freely used in tools and programs made by other developers.
+//|
+//| WarCraft is a trademark of Blizzard Entertainment, Inc.
+//|
+//| MpqLib is free software: you can redistribute it and/or modify
+//| it under the terms of the GNU General Public License as published by
+//| the Free Software Foundation, either version 3 of the License, or
+//| (at your option) any later version.
+//|
+//| MpqLib is distributed in the hope that it will be useful,
+//| but WITHOUT ANY WARRANTY; without even the implied warranty of
+//| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//| GNU General Public License for more details.
+//|
+//| You should have received a copy of the GNU General Public License
+//| along with MpqLib. If not, see <http://www.gnu.org/licenses/>.
+//|
+//| This header must remain unaltered if changes are made to the file.
+//| Additional information may be added as needed.
+//|
+//+-----------------------------------------------------------------------------
+#pragma once
+
+#include "VerifyEntry.h"
+
+namespace MpqLib
+{
+	namespace Mpq
+	{
+		/// <summary>
+		/// The immutable result of verifying the integrity of an archive.
+		/// </summary>
+		public ref class CVerifyReport sealed
+		{
+			public:
+				/// <summary>
+				/// Parameterized constructor.
+				/// </summary>
+				/// <param name="FileCount">The number of files verified to use</param>
+				/// <param name="Entries">The errors found to use</param>
+				CVerifyReport(System::Int32 FileCount, System::Collections::Generic::IList<CVerifyEntry^>^ Entries);
+
+				/// <summary>
+				/// Generates a string version of the report.
+				/// </summary>
+				/// <returns>The generated string</returns>
+				virtual System::String^ ToString() override;
+
+				/// <summary>
+				/// Retrieves the number of files verified.
+				/// </summary>
+				property System::Int32 FileCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Retrieves the files with errors or unknown keys, ordered by their position in the archive.
+				/// </summary>
+				property System::Collections::ObjectModel::ReadOnlyCollection<CVerifyEntry^>^ Entries { System::Collections::ObjectModel::ReadOnlyCollection<CVerifyEntry^>^ get(); }
+
+				/// <summary>
+				/// Retrieves the number of encrypted files whose contents could not be checked because their name is unknown.
+				/// </summary>
+				property System::Int32 UnverifiedFileCount { System::Int32 get(); }
+
+				/// <summary>
+				/// Checks if no errors were found (files with unknown keys do not count as errors).
+				/// </summary>
+				property System::Boolean IsValid { System::Boolean get(); }
+
+			private:
+				System::Int32 _FileCount;
+				System::Collections::ObjectModel::ReadOnlyCollection<CVerifyEntry^>^ _Entries;
+		};
+	}
+}
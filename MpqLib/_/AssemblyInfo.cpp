@@ -33,6 +33,12 @@ using namespace System::Security::Permissions;
 
 [assembly:ComVisible(false)];
 
+//
+// The benchmarks measure the codecs and buffers of the library directly,
+// they are signed with the same key.
+//
+[assembly:InternalsVisibleTo("MpqLib.Benchmark, PublicKey=00240000048000009400000006020000002400005253413100040000010001003b4a5b5e242a6b2e144080cdbd6bb679c734750af0e23b3e889abd247e769eede48ac33a144558c31d7a40ba478943158d0236fc37f3d4da993a8127b96dd10a2040ba2f8d206414238c42a9f36b5c9414697d6b897191f3c67179019a717511cdafaa8d7ffb958fd9c97a043054ae2594ba0c5b0078efebcd61d76a37ab2bda")];
+
 [assembly:CLSCompliantAttribute(true)];
 
 [assembly:SecurityPermission(SecurityAction::RequestMinimum, UnmanagedCode = true)];